@@ -0,0 +1,640 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+// Measures the throughput of the common FileRef operations on synthetic
+// files of each format, along with the amount of I/O they do.
+//
+// usage: filerefbench [--iterations N] [--scale N] [--dir DIR] [--json] [--keep]
+//
+// The corpus is written to DIR (the current directory by default) and
+// removed afterwards unless --keep is given.  --scale multiplies the size of
+// the audio data.  With --json the results are printed as a JSON document
+// instead of a table.  The files are read through the page cache, so the
+// numbers reflect parsing and syscall overhead rather than disk speed.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+
+#include <taglib.h>
+#include <tfile.h>
+#include <tfilestream.h>
+#include <fileref.h>
+#include <tag.h>
+#include <tpropertymap.h>
+#include <mpegfile.h>
+#include <id3v2tag.h>
+#include <attachedpictureframe.h>
+#include <flacfile.h>
+#include <flacpicture.h>
+#include <xiphcomment.h>
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  struct Corpus
+  {
+    const char *format;
+    string path;
+  };
+
+  struct Result
+  {
+    string format;
+    string operation;
+    unsigned long long fileSize;
+    double filesPerSecond;
+    File::IOStatistics io;
+  };
+
+  // Deterministic filler, so that runs are comparable.
+
+  ByteVector noise(unsigned int length, unsigned int seed)
+  {
+    ByteVector data(length, '\0');
+    for(unsigned int i = 0; i < length; ++i) {
+      seed = seed * 1103515245 + 12345;
+      data[i] = static_cast<char>(seed >> 16);
+    }
+    return data;
+  }
+
+  ByteVector beUInt(unsigned int value)
+  {
+    return ByteVector::fromUInt(value, true);
+  }
+
+  ByteVector leUInt(unsigned int value)
+  {
+    return ByteVector::fromUInt(value, false);
+  }
+
+  ByteVector beULongLong(unsigned long long value)
+  {
+    return ByteVector::fromLongLong(static_cast<long long>(value), true);
+  }
+
+  ByteVector leULongLong(unsigned long long value)
+  {
+    return ByteVector::fromLongLong(static_cast<long long>(value), false);
+  }
+
+  ByteVector atom(const char *name, const ByteVector &payload)
+  {
+    return beUInt(payload.size() + 8) + ByteVector(name) + payload;
+  }
+
+  // Writes the header and then \a blocks copies of \a block.
+
+  bool writeFile(const string &path, const ByteVector &header,
+                 const ByteVector &block = ByteVector(), unsigned int blocks = 0,
+                 const ByteVector &trailer = ByteVector())
+  {
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    out.write(header.data(), header.size());
+    for(unsigned int i = 0; i < blocks; ++i)
+      out.write(block.data(), block.size());
+    out.write(trailer.data(), trailer.size());
+    return out.good();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // corpus synthesis
+  ////////////////////////////////////////////////////////////////////////////
+
+  // MPEG-1 Layer III, 128 kb/s, 44.1 kHz stereo frames behind an ID3v2 tag
+  // with a 1 MiB picture.
+
+  bool makeMPEG(const string &path, unsigned int scale)
+  {
+    ByteVector frame = beUInt(0xFFFB9000);
+    frame.append(noise(417 - 4, 1));
+
+    if(!writeFile(path, ByteVector(), frame, 4000 * scale))
+      return false;
+
+    MPEG::File file(path.c_str(), false);
+    ID3v2::Tag *tag = file.ID3v2Tag(true);
+    tag->setTitle("Benchmark");
+    tag->setArtist("TagLib");
+    tag->setAlbum("Synthetic corpus");
+
+    ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+    picture->setMimeType("image/jpeg");
+    picture->setType(ID3v2::AttachedPictureFrame::FrontCover);
+    picture->setPicture(noise(1024 * 1024, 2));
+    tag->addFrame(picture);
+
+    return file.save(MPEG::File::ID3v2);
+  }
+
+  // STREAMINFO followed by 4 MiB of audio, with 32 pictures of 128 KiB.
+
+  bool makeFLAC(const string &path, unsigned int scale)
+  {
+    const unsigned long long samples = 44100ULL * 60 * scale;
+
+    ByteVector streamInfo;
+    streamInfo.append(ByteVector::fromShort(4096));
+    streamInfo.append(ByteVector::fromShort(4096));
+    streamInfo.append(ByteVector(6, '\0'));
+    // 20 bits sample rate, 3 bits channels - 1, 5 bits bits per sample - 1,
+    // 36 bits total samples
+    streamInfo.append(beUInt((44100U << 12) | (1U << 9) | (15U << 4) |
+                             static_cast<unsigned int>(samples >> 32)));
+    streamInfo.append(beUInt(static_cast<unsigned int>(samples)));
+    streamInfo.append(ByteVector(16, '\0'));
+
+    ByteVector header("fLaC");
+    header.append(static_cast<char>(0x80));
+    header.append(beUInt(streamInfo.size()).mid(1));
+    header.append(streamInfo);
+
+    if(!writeFile(path, header, noise(1024 * 1024, 3), 4 * scale))
+      return false;
+
+    FLAC::File file(path.c_str(), false);
+    file.xiphComment(true)->setTitle("Benchmark");
+    file.xiphComment()->setArtist("TagLib");
+
+    for(unsigned int i = 0; i < 32; ++i) {
+      FLAC::Picture *picture = new FLAC::Picture();
+      picture->setMimeType("image/png");
+      picture->setType(i == 0 ? FLAC::Picture::FrontCover : FLAC::Picture::Other);
+      picture->setData(noise(128 * 1024, 100 + i));
+      file.addPicture(picture);
+    }
+
+    return file.save();
+  }
+
+  // An AAC track whose sample table has 200000 chunks, so that 'moov' is
+  // about 2.4 MiB and stored before 'mdat'.
+
+  bool makeMP4(const string &path, unsigned int scale)
+  {
+    const unsigned int chunks = 200000;
+    const unsigned int chunkSize = 40 * scale;
+
+    ByteVector mvhd = beUInt(0) + ByteVector(8, '\0') + beUInt(1000) + beUInt(chunks * 23);
+    mvhd.append(ByteVector(80, '\0'));
+
+    ByteVector mdhd = beUInt(0) + ByteVector(8, '\0') + beUInt(44100) + beUInt(chunks * 1024);
+    mdhd.append(ByteVector(4, '\0'));
+
+    const ByteVector hdlr = beUInt(0) + beUInt(0) + ByteVector("soun") + ByteVector(13, '\0');
+
+    ByteVector mp4a = ByteVector(6, '\0') + ByteVector::fromShort(1);
+    mp4a.append(ByteVector(8, '\0'));
+    mp4a.append(ByteVector::fromShort(2));
+    mp4a.append(ByteVector::fromShort(16));
+    mp4a.append(ByteVector(4, '\0'));
+    mp4a.append(beUInt(44100U << 16));
+    const ByteVector stsd = beUInt(0) + beUInt(1) + atom("mp4a", mp4a);
+
+    const ByteVector stts = beUInt(0) + beUInt(1) + beUInt(chunks) + beUInt(1024);
+    const ByteVector stsc = beUInt(0) + beUInt(1) + beUInt(1) + beUInt(1) + beUInt(1);
+
+    ByteVector stsz = beUInt(0) + beUInt(0) + beUInt(chunks);
+    ByteVector stco = beUInt(0) + beUInt(chunks);
+    ByteVector sizes;
+    for(unsigned int i = 0; i < chunks; ++i)
+      sizes.append(beUInt(chunkSize));
+    stsz.append(sizes);
+
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4A ") + beUInt(0) + ByteVector("M4A mp42isom"));
+
+    // The chunk offsets depend on the size of 'moov', which does not depend
+    // on their values.
+
+    const unsigned int stcoSize = 8 + stco.size() + chunks * 4;
+    ByteVector stbl = atom("stsd", stsd) + atom("stts", stts) + atom("stsc", stsc) + atom("stsz", stsz);
+    const unsigned int moovSize =
+      8 + atom("mvhd", mvhd).size() +
+      8 + atom("tkhd", ByteVector(84, '\0')).size() +
+      8 + atom("mdhd", mdhd).size() + atom("hdlr", hdlr).size() +
+      8 + atom("smhd", ByteVector(8, '\0')).size() +
+      8 + stbl.size() + stcoSize;
+
+    const unsigned int mdatStart = ftyp.size() + moovSize + 8;
+    for(unsigned int i = 0; i < chunks; ++i)
+      stco.append(beUInt(mdatStart + i * chunkSize));
+    stbl.append(atom("stco", stco));
+
+    const ByteVector minf = atom("smhd", ByteVector(8, '\0')) + atom("stbl", stbl);
+    const ByteVector mdia = atom("mdhd", mdhd) + atom("hdlr", hdlr) + atom("minf", minf);
+    const ByteVector trak = atom("tkhd", ByteVector(84, '\0')) + atom("mdia", mdia);
+    const ByteVector moov = atom("moov", atom("mvhd", mvhd) + atom("trak", trak));
+
+    if(moov.size() != moovSize)
+      return false;
+
+    const ByteVector block = noise(chunkSize, 4);
+    if(!writeFile(path, ftyp + moov + beUInt(chunks * chunkSize + 8) + ByteVector("mdat"),
+                  block, chunks))
+      return false;
+
+    FileRef file(path.c_str(), false);
+    if(file.isNull())
+      return false;
+
+    file.tag()->setTitle("Benchmark");
+    file.tag()->setArtist("TagLib");
+    return file.save();
+  }
+
+  // 16-bit stereo PCM, 64 MiB of samples and an ID3v2 tag.
+
+  bool makeWAV(const string &path, unsigned int scale)
+  {
+    const ByteVector block = noise(1024 * 1024, 5);
+    const unsigned int blocks = 64 * scale;
+
+    ByteVector fmt = ByteVector::fromShort(1, false) + ByteVector::fromShort(2, false);
+    fmt.append(leUInt(44100));
+    fmt.append(leUInt(44100 * 4));
+    fmt.append(ByteVector::fromShort(4, false) + ByteVector::fromShort(16, false));
+
+    const unsigned int dataSize = blocks * block.size();
+    ByteVector header("RIFF");
+    header.append(leUInt(4 + 8 + fmt.size() + 8 + dataSize));
+    header.append(ByteVector("WAVEfmt ") + leUInt(fmt.size()) + fmt);
+    header.append(ByteVector("data") + leUInt(dataSize));
+
+    if(!writeFile(path, header, block, blocks))
+      return false;
+
+    FileRef file(path.c_str(), false);
+    if(file.isNull())
+      return false;
+
+    file.tag()->setTitle("Benchmark");
+    file.tag()->setArtist("TagLib");
+    return file.save();
+  }
+
+  // DSD64 stereo, 16 MiB of samples and no tag.
+
+  bool makeDSF(const string &path, unsigned int scale)
+  {
+    const ByteVector block = noise(4096 * 2, 6);
+    const unsigned int blocks = 2048 * scale;
+    const unsigned long long dataSize = 12ULL + blocks * block.size();
+    const unsigned long long fileSize = 28 + 52 + dataSize;
+
+    ByteVector header("DSD ");
+    header.append(leULongLong(28));
+    header.append(leULongLong(fileSize));
+    header.append(leULongLong(0));
+    header.append(ByteVector("fmt ") + leULongLong(52));
+    header.append(leUInt(1));         // format version
+    header.append(leUInt(0));         // DSD raw
+    header.append(leUInt(2));         // stereo
+    header.append(leUInt(2));         // channels
+    header.append(leUInt(2822400));
+    header.append(leUInt(1));         // bits per sample
+    header.append(leULongLong(blocks * 4096ULL * 8));
+    header.append(leUInt(4096));      // block size per channel
+    header.append(leUInt(0));
+    header.append(ByteVector("data") + leULongLong(dataSize));
+
+    return writeFile(path, header, block, blocks);
+  }
+
+  // DSDIFF with the same audio as the DSF file.
+
+  bool makeDFF(const string &path, unsigned int scale)
+  {
+    const ByteVector block = noise(4096 * 2, 7);
+    const unsigned int blocks = 2048 * scale;
+
+    ByteVector prop("SND ");
+    prop.append(ByteVector("FS  ") + beULongLong(4) + beUInt(2822400));
+    prop.append(ByteVector("CHNL") + beULongLong(10) + ByteVector::fromShort(2) + ByteVector("SLFTSRGT"));
+    prop.append(ByteVector("CMPR") + beULongLong(20) + ByteVector("DSD ") +
+                ByteVector(1, 14) + ByteVector("not compressed") + ByteVector(1, '\0'));
+
+    const unsigned long long dataSize = static_cast<unsigned long long>(blocks) * block.size();
+
+    ByteVector chunks;
+    chunks.append(ByteVector("FVER") + beULongLong(4) + beUInt(0x01050000));
+    chunks.append(ByteVector("PROP") + beULongLong(prop.size()) + prop);
+    chunks.append(ByteVector("DSD ") + beULongLong(dataSize));
+
+    ByteVector header("FRM8");
+    header.append(beULongLong(4 + chunks.size() + dataSize));
+    header.append(ByteVector("DSD "));
+    header.append(chunks);
+
+    return writeFile(path, header, block, blocks);
+  }
+
+  // Ogg pages are rendered here rather than with Ogg::Page so that the
+  // granule positions can be set.
+
+  unsigned int oggCRC(const ByteVector &data)
+  {
+    unsigned int crc = 0;
+    for(unsigned int i = 0; i < data.size(); ++i) {
+      crc ^= static_cast<unsigned int>(static_cast<unsigned char>(data[i])) << 24;
+      for(int bit = 0; bit < 8; ++bit)
+        crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+    return crc;
+  }
+
+  ByteVector oggPage(const ByteVector &packet, unsigned int pageNumber,
+                     long long granule, char flags)
+  {
+    ByteVector segments;
+    unsigned int remaining = packet.size();
+    while(remaining >= 255) {
+      segments.append(static_cast<char>(255));
+      remaining -= 255;
+    }
+    segments.append(static_cast<char>(remaining));
+
+    ByteVector page("OggS");
+    page.append(static_cast<char>(0));
+    page.append(flags);
+    page.append(ByteVector::fromLongLong(granule, false));
+    page.append(leUInt(0x12345678));
+    page.append(leUInt(pageNumber));
+    page.append(leUInt(0));
+    page.append(static_cast<char>(segments.size()));
+    page.append(segments);
+    page.append(packet);
+
+    const ByteVector crc = leUInt(oggCRC(page));
+    for(unsigned int i = 0; i < 4; ++i)
+      page[22 + i] = crc[i];
+    return page;
+  }
+
+  // Vorbis with 8000 audio pages of 2 KiB each.
+
+  bool makeOgg(const string &path, unsigned int scale)
+  {
+    const unsigned int pages = 8000 * scale;
+
+    ByteVector identification("\x01vorbis");
+    identification.append(leUInt(0));
+    identification.append(static_cast<char>(2));
+    identification.append(leUInt(44100));
+    identification.append(leUInt(0) + leUInt(128000) + leUInt(0));
+    identification.append(static_cast<char>(0xB8));
+    identification.append(static_cast<char>(1));
+
+    ByteVector comment("\x03vorbis");
+    comment.append(leUInt(6) + ByteVector("TagLib"));
+    comment.append(leUInt(1) + leUInt(15) + ByteVector("TITLE=Benchmark"));
+    comment.append(static_cast<char>(1));
+
+    const ByteVector setup = ByteVector("\x05vorbis") + noise(1000, 8);
+
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+
+    const ByteVector first = oggPage(identification, 0, 0, 0x02);
+    const ByteVector second = oggPage(comment, 1, 0, 0);
+    const ByteVector third = oggPage(setup, 2, 0, 0);
+    out.write(first.data(), first.size());
+    out.write(second.data(), second.size());
+    out.write(third.data(), third.size());
+
+    const ByteVector packet = noise(2048, 9);
+    for(unsigned int i = 0; i < pages; ++i) {
+      const ByteVector page = oggPage(packet, 3 + i, (i + 1) * 1024LL,
+                                      i + 1 == pages ? 0x04 : 0);
+      out.write(page.data(), page.size());
+    }
+
+    return out.good();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // measurements
+  ////////////////////////////////////////////////////////////////////////////
+
+  enum Operation {
+    Open,
+    OpenWithProperties,
+    Properties,
+    Signature,
+    Save
+  };
+
+  const char *operationNames[] = {
+    "open",
+    "open_properties",
+    "properties",
+    "signature",
+    "save"
+  };
+
+  // Runs the operation once and returns false if the format does not
+  // support it.
+
+  bool runOnce(const string &path, Operation operation, unsigned int iteration,
+               File::IOStatistics &io)
+  {
+    const bool readProperties = operation == OpenWithProperties || operation == Signature;
+    AudioProperties::ReadStyle style = AudioProperties::Average;
+    if(operation == Signature)
+      style = style | AudioProperties::LazySignature;
+    else
+      style = style | AudioProperties::NoSignature;
+
+    FileRef file(path.c_str(), readProperties, style);
+    if(file.isNull())
+      return false;
+
+    switch(operation) {
+    case Open:
+    case OpenWithProperties:
+      break;
+    case Properties:
+      file.file()->properties();
+      break;
+    case Signature:
+      if(!file.audioProperties() || file.audioProperties()->signature().isEmpty())
+        return false;
+      break;
+    case Save:
+      if(!file.tag())
+        return false;
+      // Alternate between titles of the same length so that every save
+      // rewrites the tag in place.
+      file.tag()->setTitle(iteration % 2 ? "Benchmark 1" : "Benchmark 2");
+      if(!file.save())
+        return false;
+      break;
+    }
+
+    io = file.file()->ioStatistics();
+    return true;
+  }
+
+  bool measure(const Corpus &corpus, Operation operation, unsigned int iterations,
+               Result &result)
+  {
+    File::IOStatistics io;
+    if(!runOnce(corpus.path, operation, 0, io))
+      return false;
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(unsigned int i = 1; i <= iterations; ++i)
+      runOnce(corpus.path, operation, i, io);
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    result.format = corpus.format;
+    result.operation = operationNames[operation];
+    result.fileSize = FileStream(corpus.path.c_str(), true).length();
+    result.filesPerSecond = seconds > 0.0 ? iterations / seconds : 0.0;
+    result.io = io;
+    return true;
+  }
+
+  void printTable(const vector<Result> &results)
+  {
+    printf("%-6s %-16s %12s %12s %12s %8s %8s %8s\n",
+           "format", "operation", "file bytes", "files/s", "bytes read", "reads", "seeks", "regions");
+
+    for(vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it) {
+      printf("%-6s %-16s %12llu %12.1f %12llu %8llu %8llu %8llu\n",
+             it->format.c_str(), it->operation.c_str(), it->fileSize, it->filesPerSecond,
+             it->io.bytesRead, it->io.readCalls, it->io.seekCalls, it->io.regions);
+    }
+  }
+
+  void printJSON(const vector<Result> &results, unsigned int iterations, unsigned int scale)
+  {
+    printf("{\n");
+    printf("  \"taglib_version\": \"%d.%d.%d\",\n",
+           TAGLIB_MAJOR_VERSION, TAGLIB_MINOR_VERSION, TAGLIB_PATCH_VERSION);
+    printf("  \"iterations\": %u,\n", iterations);
+    printf("  \"scale\": %u,\n", scale);
+    printf("  \"results\": [");
+
+    for(vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it) {
+      printf("%s\n    {\"format\": \"%s\", \"operation\": \"%s\", \"file_bytes\": %llu, "
+             "\"files_per_second\": %.3f, \"bytes_read\": %llu, \"read_calls\": %llu, "
+             "\"seek_calls\": %llu, \"regions\": %llu, \"bytes_written\": %llu}",
+             it == results.begin() ? "" : ",",
+             it->format.c_str(), it->operation.c_str(), it->fileSize, it->filesPerSecond,
+             it->io.bytesRead, it->io.readCalls, it->io.seekCalls, it->io.regions,
+             it->io.bytesWritten);
+    }
+
+    printf("\n  ]\n}\n");
+  }
+
+  void usage(const char *name)
+  {
+    fprintf(stderr, "usage: %s [--iterations N] [--scale N] [--dir DIR] [--json] [--keep]\n", name);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int iterations = 10;
+  unsigned int scale = 1;
+  string dir = ".";
+  bool json = false;
+  bool keep = false;
+
+  for(int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if(arg == "--iterations" && i + 1 < argc)
+      iterations = strtoul(argv[++i], 0, 10);
+    else if(arg == "--scale" && i + 1 < argc)
+      scale = strtoul(argv[++i], 0, 10);
+    else if(arg == "--dir" && i + 1 < argc)
+      dir = argv[++i];
+    else if(arg == "--json")
+      json = true;
+    else if(arg == "--keep")
+      keep = true;
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(iterations == 0 || scale == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  struct {
+    const char *format;
+    const char *extension;
+    bool (*make)(const string &, unsigned int);
+  } const generators[] = {
+    { "mp3",  "mp3",  makeMPEG },
+    { "flac", "flac", makeFLAC },
+    { "mp4",  "m4a",  makeMP4 },
+    { "wav",  "wav",  makeWAV },
+    { "dsf",  "dsf",  makeDSF },
+    { "dff",  "dff",  makeDFF },
+    { "ogg",  "ogg",  makeOgg }
+  };
+
+  vector<Corpus> corpora;
+  for(size_t i = 0; i < sizeof(generators) / sizeof(generators[0]); ++i) {
+    Corpus corpus;
+    corpus.format = generators[i].format;
+    corpus.path = dir + "/filerefbench." + generators[i].extension;
+
+    if(!generators[i].make(corpus.path, scale)) {
+      fprintf(stderr, "Could not create %s\n", corpus.path.c_str());
+      remove(corpus.path.c_str());
+      continue;
+    }
+    corpora.push_back(corpus);
+  }
+
+  vector<Result> results;
+  for(vector<Corpus>::const_iterator it = corpora.begin(); it != corpora.end(); ++it) {
+    for(int operation = Open; operation <= Save; ++operation) {
+      Result result;
+      if(measure(*it, static_cast<Operation>(operation), iterations, result))
+        results.push_back(result);
+      else
+        fprintf(stderr, "%s: %s is not supported\n", it->format, operationNames[operation]);
+    }
+
+    if(!keep)
+      remove(it->path.c_str());
+  }
+
+  if(json)
+    printJSON(results, iterations, scale);
+  else
+    printTable(results);
+
+  return 0;
+}
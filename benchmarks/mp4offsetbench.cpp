@@ -0,0 +1,216 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+// Measures how long it takes to grow the tag of an audiobook with a large
+// chunk offset table, which makes MP4::Tag rewrite every entry of 'stco'.
+// The default is a 10 hour AAC track at 44.1 kHz with one frame per chunk.
+// The chunks are only 8 bytes long, so that the time goes to the offset table
+// rather than to moving 'mdat'.  For comparison the same table is also
+// rewritten with one write per entry.
+//
+// usage: mp4offsetbench [hours] [runs]
+//
+// The file is written to the current directory and removed afterwards.
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <string>
+#include <chrono>
+#include <fstream>
+
+#include <tbytevector.h>
+#include <tfile.h>
+#include <tfilestream.h>
+#include <tstring.h>
+#include <mp4file.h>
+#include <mp4tag.h>
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  const char *const fileName = "mp4offsetbench.m4b";
+  const unsigned int chunkSize = 8;
+
+  ByteVector atom(const char *name, const ByteVector &payload)
+  {
+    return ByteVector::fromUInt(payload.size() + 8) + ByteVector(name) + payload;
+  }
+
+  // Returns the offset of the first chunk offset in the file, or 0 on errors.
+
+  long writeAudiobook(unsigned int chunks)
+  {
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4B ") + ByteVector::fromUInt(0) +
+                                         ByteVector("M4B mp42isom"));
+
+    const ByteVector ilst = atom("ilst", atom("\251nam", atom("data",
+      ByteVector::fromUInt(1) + ByteVector::fromUInt(0) + ByteVector("Audiobook"))));
+    const ByteVector hdlr = ByteVector(8, '\0') + ByteVector("mdirappl") + ByteVector(9, '\0');
+    const ByteVector udta = atom("udta", atom("meta", ByteVector(4, '\0') + atom("hdlr", hdlr) + ilst));
+
+    // Everything in front of the table is built first, so that the offsets
+    // can point into 'mdat'.
+
+    const unsigned int stcoHeaderSize = 8 + 8 + 8 + 8 + 8 + 8 + 8;
+    const unsigned int moovSize = stcoHeaderSize + chunks * 4 + udta.size();
+    const unsigned int mdatStart = ftyp.size() + moovSize + 8;
+
+    ByteVector table(chunks * 4, '\0');
+    for(unsigned int i = 0; i < chunks; ++i) {
+      const unsigned int offset = mdatStart + i * chunkSize;
+      table[i * 4]     = static_cast<char>(offset >> 24);
+      table[i * 4 + 1] = static_cast<char>(offset >> 16);
+      table[i * 4 + 2] = static_cast<char>(offset >> 8);
+      table[i * 4 + 3] = static_cast<char>(offset);
+    }
+
+    const ByteVector stco = atom("stco", ByteVector::fromUInt(0) + ByteVector::fromUInt(chunks) + table);
+    const ByteVector trak = atom("trak", atom("mdia", atom("minf", atom("stbl", stco))));
+    const ByteVector moov = atom("moov", trak + udta);
+
+    if(moov.size() != moovSize)
+      return 0;
+
+    ofstream out(fileName, ios::binary | ios::trunc);
+    out.write(ftyp.data(), ftyp.size());
+    out.write(moov.data(), moov.size());
+
+    const ByteVector mdatHeader = ByteVector::fromUInt(chunks * chunkSize + 8) + ByteVector("mdat");
+    out.write(mdatHeader.data(), mdatHeader.size());
+    const ByteVector chunk(chunkSize, '\0');
+    for(unsigned int i = 0; i < chunks; ++i)
+      out.write(chunk.data(), chunk.size());
+
+    return out.good() ? static_cast<long>(ftyp.size() + stcoHeaderSize) : 0;
+  }
+
+  double elapsed(const chrono::steady_clock::time_point &start)
+  {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
+  // Grows the title, so that 'moov' has to be enlarged.
+
+  double saveTag(File::IOStatistics &io)
+  {
+    MP4::File file(fileName, false);
+    file.tag()->setTitle(String(string(4096, 'x')));
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    file.resetIOStatistics();
+    file.save();
+    const double seconds = elapsed(start);
+    io = file.ioStatistics();
+    return seconds;
+  }
+
+  // The old way: read the table and write back one entry at a time.
+
+  double rewriteEntries(long tableOffset, unsigned int chunks, long delta)
+  {
+    FileStream stream(fileName);
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    stream.seek(tableOffset);
+    const ByteVector data = stream.readBlock(chunks * 4);
+    stream.seek(tableOffset);
+    for(unsigned int i = 0; i < chunks; ++i)
+      stream.writeBlock(ByteVector::fromUInt(data.toUInt(i * 4) + delta));
+    return elapsed(start);
+  }
+
+  // Returns true if every chunk offset still points to its chunk.
+
+  bool checkOffsets(unsigned int chunks)
+  {
+    FileStream stream(fileName, true);
+    MP4::File file(fileName, false);
+    if(!file.isValid())
+      return false;
+
+    const ByteVector all = stream.readBlock(stream.length());
+    const int stco = all.find("stco");
+    const int mdat = all.find("mdat");
+    if(stco < 0 || mdat < 0)
+      return false;
+
+    for(unsigned int i = 0; i < chunks; ++i) {
+      if(all.toUInt(stco + 12 + i * 4) != static_cast<unsigned int>(mdat + 4 + i * chunkSize))
+        return false;
+    }
+    return true;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const double hours = argc > 1 ? atof(argv[1]) : 10.0;
+  const int runs = argc > 2 ? atoi(argv[2]) : 3;
+
+  if(hours <= 0.0 || runs <= 0) {
+    fprintf(stderr, "usage: %s [hours] [runs]\n", argv[0]);
+    return 1;
+  }
+
+  const unsigned int chunks = static_cast<unsigned int>(hours * 3600 * 44100 / 1024);
+
+  printf("%u chunk offsets\n", chunks);
+  printf("%-16s %10s %12s %12s\n", "method", "ms", "writes", "KiB written");
+
+  bool failed = false;
+  double bestSave = 0.0;
+  double bestEntries = 0.0;
+  File::IOStatistics io = File::IOStatistics();
+
+  for(int i = 0; i < runs; ++i) {
+    const long tableOffset = writeAudiobook(chunks);
+    if(tableOffset == 0) {
+      fprintf(stderr, "Could not write %s\n", fileName);
+      return 1;
+    }
+
+    const double seconds = saveTag(io);
+    if(i == 0 || seconds < bestSave)
+      bestSave = seconds;
+
+    if(!checkOffsets(chunks))
+      failed = true;
+
+    writeAudiobook(chunks);
+    const double entrySeconds = rewriteEntries(tableOffset, chunks, 4096);
+    if(i == 0 || entrySeconds < bestEntries)
+      bestEntries = entrySeconds;
+  }
+
+  remove(fileName);
+
+  printf("%-16s %10.2f %12llu %12llu\n", "MP4::File::save", bestSave * 1000,
+         io.writeCalls, io.bytesWritten / 1024);
+  printf("%-16s %10.2f %12u %12u\n", "per entry", bestEntries * 1000,
+         chunks, chunks * 4 / 1024);
+
+  if(failed)
+    printf("MISMATCH: the chunk offsets were not updated correctly\n");
+
+  return failed ? 1 : 0;
+}
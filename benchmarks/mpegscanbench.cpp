@@ -0,0 +1,175 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+// Compares the MPEG frame sync scanner backends, on a plain buffer and by
+// opening in-memory MP3 streams that start with junk, and checks that they
+// all find the same first frame.
+//
+// usage: mpegscanbench [kilobytes of junk] [runs]
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <chrono>
+
+#include <tbytevector.h>
+#include <tbytevectorstream.h>
+#include <mpegfile.h>
+#include <id3v2framefactory.h>
+#include <mpegscanner.h>
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  const char *const backendNames[] = { "scalar", "sse2", "avx2" };
+
+  ByteVector noise(unsigned int length)
+  {
+    ByteVector data(length, '\0');
+    unsigned int seed = 0x12345678;
+    for(unsigned int i = 0; i < length; ++i) {
+      seed = seed * 1103515245 + 12345;
+      data[i] = static_cast<char>(seed >> 16);
+    }
+    return data;
+  }
+
+  // Every four bytes look like the header of a padded 48 kHz frame, but the
+  // next frame never matches it.
+
+  ByteVector falseSyncs(unsigned int length)
+  {
+    ByteVector data;
+    while(data.size() < length)
+      data.append(ByteVector("\xFF\xFB\x96\x00", 4));
+    return data.mid(0, length);
+  }
+
+  // 1000 frames of 128 kb/s at 44.1 kHz.
+
+  ByteVector frames()
+  {
+    ByteVector frame("\xFF\xFB\x90\x00", 4);
+    frame.append(ByteVector(417 - 4, '\0'));
+
+    ByteVector data;
+    for(int i = 0; i < 1000; ++i)
+      data.append(frame);
+    return data;
+  }
+
+  double elapsed(const chrono::steady_clock::time_point &start)
+  {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
+  // Counts the candidates in data and returns the best time of all runs.
+
+  double scanBuffer(const ByteVector &data, int runs, unsigned int &candidates)
+  {
+    double best = 0.0;
+    for(int i = 0; i < runs; ++i) {
+      const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      candidates = 0;
+      for(int offset = MPEG::Scanner::findFrameSync(data); offset >= 0;
+          offset = MPEG::Scanner::findFrameSync(data, offset + 1)) {
+        ++candidates;
+      }
+      const double seconds = elapsed(start);
+      if(i == 0 || seconds < best)
+        best = seconds;
+    }
+    return best;
+  }
+
+  // Opens data as an MP3 stream and returns the best time of all runs.
+
+  double openStream(const ByteVector &data, int runs, long &firstFrame)
+  {
+    double best = 0.0;
+    for(int i = 0; i < runs; ++i) {
+      ByteVectorStream stream(data);
+      const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      MPEG::File file(&stream, ID3v2::FrameFactory::instance());
+      firstFrame = file.firstFrameOffset();
+      const double seconds = elapsed(start);
+      if(i == 0 || seconds < best)
+        best = seconds;
+    }
+    return best;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const unsigned int kilobytes = argc > 1 ? strtoul(argv[1], 0, 10) : 4096;
+  const int runs = argc > 2 ? atoi(argv[2]) : 5;
+
+  if(kilobytes == 0 || runs <= 0) {
+    fprintf(stderr, "usage: %s [kilobytes of junk] [runs]\n", argv[0]);
+    return 1;
+  }
+
+  const unsigned int junkLength = kilobytes * 1024;
+  const ByteVector buffer = noise(64 * 1024 * 1024);
+
+  struct Stream {
+    const char *name;
+    ByteVector data;
+  } streams[] = {
+    { "noise",       noise(junkLength) + frames() },
+    { "false syncs", falseSyncs(junkLength) + frames() }
+  };
+
+  const MPEG::Scanner::Backend defaultBackend = MPEG::Scanner::backend();
+  bool mismatch = false;
+
+  printf("%-10s %12s", "backend", "buffer MB/s");
+  for(size_t s = 0; s < sizeof(streams) / sizeof(streams[0]); ++s)
+    printf(" %14s ms", streams[s].name);
+  printf("\n");
+
+  for(int b = MPEG::Scanner::Scalar; b <= MPEG::Scanner::AVX2; ++b) {
+    const MPEG::Scanner::Backend backend = static_cast<MPEG::Scanner::Backend>(b);
+    if(!MPEG::Scanner::setBackend(backend))
+      continue;
+
+    unsigned int candidates;
+    const double seconds = scanBuffer(buffer, runs, candidates);
+    printf("%-10s %12.1f", backendNames[b], buffer.size() / seconds / (1024 * 1024));
+
+    for(size_t s = 0; s < sizeof(streams) / sizeof(streams[0]); ++s) {
+      long firstFrame;
+      const double streamSeconds = openStream(streams[s].data, runs, firstFrame);
+      printf(" %17.2f", streamSeconds * 1000);
+      if(firstFrame != static_cast<long>(junkLength)) {
+        printf(" MISMATCH (%ld)", firstFrame);
+        mismatch = true;
+      }
+    }
+    printf("\n");
+  }
+
+  MPEG::Scanner::setBackend(defaultBackend);
+
+  return mismatch ? 1 : 0;
+}
@@ -0,0 +1,117 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+// Compares the throughput of the CSHA1 backends and checks that they all
+// produce the same digest.
+//
+// usage: sha1bench [megabytes per run] [runs]
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <SHA1.h>
+
+using namespace std;
+
+namespace
+{
+  // Size of each Update() call, the same as a signature sample
+  const size_t chunkSize = 32 * 1024;
+
+  string hashData(CSHA1::BACKEND backend, const vector<UINT_8> &data, double &seconds)
+  {
+    CSHA1 sha1;
+    sha1.SetBackend(backend);
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(size_t offset = 0; offset < data.size(); offset += chunkSize) {
+      const size_t length = data.size() - offset < chunkSize ? data.size() - offset : chunkSize;
+      sha1.Update(&data[offset], static_cast<UINT_32>(length));
+    }
+    sha1.Final();
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    string report;
+    sha1.ReportHashStl(report, CSHA1::REPORT_HEX_SHORT);
+    return report;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const size_t megabytes = argc > 1 ? strtoul(argv[1], 0, 10) : 256;
+  const int runs = argc > 2 ? atoi(argv[2]) : 5;
+
+  if(megabytes == 0 || runs <= 0) {
+    fprintf(stderr, "usage: %s [megabytes per run] [runs]\n", argv[0]);
+    return 1;
+  }
+
+  vector<UINT_8> data(megabytes * 1024 * 1024);
+  unsigned int seed = 0x12345678;
+  for(size_t i = 0; i < data.size(); ++i) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast<UINT_8>(seed >> 16);
+  }
+
+  printf("%-10s %10s  %s\n", "backend", "MB/s", "digest");
+
+  string reference;
+  double scalarRate = 0.0;
+  bool mismatch = false;
+
+  for(int b = CSHA1::BACKEND_SCALAR; b <= CSHA1::BACKEND_ARMV8_SHA; ++b) {
+    const CSHA1::BACKEND backend = static_cast<CSHA1::BACKEND>(b);
+    if(!CSHA1::IsBackendSupported(backend))
+      continue;
+
+    // Report the best of all runs to reduce scheduling noise.
+    double best = 0.0;
+    string digest;
+    for(int i = 0; i < runs; ++i) {
+      double seconds;
+      digest = hashData(backend, data, seconds);
+      if(i == 0 || seconds < best)
+        best = seconds;
+    }
+
+    const double rate = megabytes / best;
+    if(backend == CSHA1::BACKEND_SCALAR) {
+      reference = digest;
+      scalarRate = rate;
+    }
+
+    printf("%-10s %10.1f  %s", CSHA1::GetBackendName(backend), rate, digest.c_str());
+    if(backend != CSHA1::BACKEND_SCALAR)
+      printf("  (%.2fx)", rate / scalarRate);
+    if(digest != reference) {
+      printf("  MISMATCH");
+      mismatch = true;
+    }
+    printf("\n");
+  }
+
+  return mismatch ? 1 : 0;
+}
@@ -38,6 +38,7 @@
 #include <mp4file.h>
 #include <tag.h>
 #include <string.h>
+#include <list>
 #include <id3v2framefactory.h>
 
 #include "tag_c.h"
@@ -69,6 +70,23 @@ namespace
   {
     return String(s, unicodeStrings ? String::UTF8 : String::Latin1);
   }
+
+  struct ReadTrace
+  {
+    TagLib_Read_Trace_Callback callback;
+    void *userData;
+  };
+
+  // A file keeps the trace that was set when it was opened, so every callback
+  // and user data pair is kept for the rest of the process.  Each distinct pair
+  // is stored once, and std::list never moves its elements.
+  std::list<ReadTrace> readTraces;
+
+  void readTraceTrampoline(const File *file, long offset, unsigned long length, void *userData)
+  {
+    const ReadTrace *trace = static_cast<const ReadTrace *>(userData);
+    trace->callback(reinterpret_cast<const TagLib_File *>(file), offset, length, trace->userData);
+  }
 }
 
 void taglib_set_strings_unicode(BOOL unicode)
@@ -150,6 +168,47 @@ BOOL taglib_file_save(TagLib_File *file)
   return reinterpret_cast<File *>(file)->save();
 }
 
+BOOL taglib_file_io_statistics(const TagLib_File *file, TagLib_IO_Statistics *stats)
+{
+  if(!file || !stats)
+    return false;
+
+  const File::IOStatistics s = reinterpret_cast<const File *>(file)->ioStatistics();
+
+  stats->read_calls     = s.readCalls;
+  stats->bytes_read     = s.bytesRead;
+  stats->seek_calls     = s.seekCalls;
+  stats->regions        = s.regions;
+  stats->write_calls    = s.writeCalls;
+  stats->bytes_written  = s.bytesWritten;
+  stats->io_nanoseconds = s.ioNanoseconds;
+  return true;
+}
+
+void taglib_set_read_trace_callback(TagLib_Read_Trace_Callback callback, void *user_data)
+{
+  if(!callback) {
+    File::setDefaultReadTraceCallback(0);
+    return;
+  }
+
+  std::list<ReadTrace>::iterator it = readTraces.begin();
+  while(it != readTraces.end() && (it->callback != callback || it->userData != user_data))
+    ++it;
+
+  if(it == readTraces.end()) {
+    const ReadTrace trace = { callback, user_data };
+    it = readTraces.insert(readTraces.end(), trace);
+  }
+
+  File::setDefaultReadTraceCallback(readTraceTrampoline, &*it);
+}
+
+void taglib_set_io_timing(BOOL enable)
+{
+  File::setDefaultIOTiming(enable != 0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // TagLib::Tag wrapper
 ////////////////////////////////////////////////////////////////////////////////
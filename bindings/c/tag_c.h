@@ -147,6 +147,54 @@ TAGLIB_C_EXPORT const TagLib_AudioProperties *taglib_file_audioproperties(const
  */
 TAGLIB_C_EXPORT BOOL taglib_file_save(TagLib_File *file);
 
+/******************************************************************************
+ * I/O statistics API
+ ******************************************************************************/
+
+/*!
+ * Counters of the I/O done through a file since it was opened.  io_nanoseconds
+ * stays 0 unless timing was enabled with taglib_set_io_timing().
+ */
+typedef struct {
+  unsigned long long read_calls;
+  unsigned long long bytes_read;
+  unsigned long long seek_calls;
+  unsigned long long regions;
+  unsigned long long write_calls;
+  unsigned long long bytes_written;
+  unsigned long long io_nanoseconds;
+} TagLib_IO_Statistics;
+
+/*!
+ * Fills \a stats with the I/O counters of \a file, including the reads done
+ * while opening it.  Returns false if either argument is null.
+ */
+TAGLIB_C_EXPORT BOOL taglib_file_io_statistics(const TagLib_File *file, TagLib_IO_Statistics *stats);
+
+/*!
+ * Called with the offset and length of each read from \a file.
+ */
+typedef void (*TagLib_Read_Trace_Callback)(const TagLib_File *file, long offset,
+                                           unsigned long length, void *user_data);
+
+/*!
+ * Sets a callback that is called after each read from files opened afterwards.
+ * Pass a null \a callback to stop tracing newly opened files.  Files that are
+ * already open keep the callback and \a user_data they were opened with.
+ *
+ * This setting is shared by all threads and not synchronized, so it must only
+ * be changed while no other thread is opening files.
+ */
+TAGLIB_C_EXPORT void taglib_set_read_trace_callback(TagLib_Read_Trace_Callback callback, void *user_data);
+
+/*!
+ * Sets whether files opened afterwards measure the time spent in I/O, which is
+ * reported as io_nanoseconds.  It is off by default, since it reads a clock
+ * twice per I/O call.  Like taglib_set_read_trace_callback() this is shared by
+ * all threads and not synchronized.
+ */
+TAGLIB_C_EXPORT void taglib_set_io_timing(BOOL enable);
+
 /******************************************************************************
  * Tag API
  ******************************************************************************/
@@ -23,15 +23,38 @@
 #endif
 #endif
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SHA1_HAVE_X86_SHA
+#include <intrin.h>
+#include <immintrin.h>
+#define SHA1_X86_SHA_TARGET
+#elif (defined(__x86_64__) || defined(__i386__)) && \
+	((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+#define SHA1_HAVE_X86_SHA
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA1_X86_SHA_TARGET __attribute__((target("sha,ssse3,sse4.1")))
+#endif
+
+// The ARMv8 instructions are only used when the compiler targets them
+// already (e.g. -march=armv8-a+crypto, or any Apple arm64 target), and only
+// if SHA1_ENABLE_ARMV8_SHA is defined: that path has not been run against
+// test_sha1 on ARM hardware or under emulation yet.
+#if defined(SHA1_ENABLE_ARMV8_SHA) && (defined(__aarch64__) || defined(__arm__)) && \
+	(defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA1_HAVE_ARMV8_SHA
+#include <arm_neon.h>
+#endif
+
 #ifdef SHA1_LITTLE_ENDIAN
-#define SHABLK0(i) (m_block->l[i] = \
-	(ROL32(m_block->l[i],24) & 0xFF00FF00) | (ROL32(m_block->l[i],8) & 0x00FF00FF))
+#define SHABLK0(i) (block.l[i] = \
+	(ROL32(block.l[i],24) & 0xFF00FF00) | (ROL32(block.l[i],8) & 0x00FF00FF))
 #else
-#define SHABLK0(i) (m_block->l[i])
+#define SHABLK0(i) (block.l[i])
 #endif
 
-#define SHABLK(i) (m_block->l[i&15] = ROL32(m_block->l[(i+13)&15] ^ m_block->l[(i+8)&15] \
-	^ m_block->l[(i+2)&15] ^ m_block->l[i&15],1))
+#define SHABLK(i) (block.l[i&15] = ROL32(block.l[(i+13)&15] ^ block.l[(i+8)&15] \
+	^ block.l[(i+2)&15] ^ block.l[i&15],1))
 
 // SHA-1 rounds
 #define _R0(v,w,x,y,z,i) {z+=((w&(x^y))^y)+SHABLK0(i)+0x5A827999+ROL32(v,5);w=ROL32(w,30);}
@@ -40,9 +63,208 @@
 #define _R3(v,w,x,y,z,i) {z+=(((w|x)&y)|(w&x))+SHABLK(i)+0x8F1BBCDC+ROL32(v,5);w=ROL32(w,30);}
 #define _R4(v,w,x,y,z,i) {z+=(w^x^y)+SHABLK(i)+0xCA62C1D6+ROL32(v,5);w=ROL32(w,30);}
 
+namespace
+{
+
+void TransformScalar(UINT_32* pState, const UINT_8* pBlocks, size_t uBlocks)
+{
+	SHA1_WORKSPACE_BLOCK block;
+
+	for( ; uBlocks != 0; --uBlocks, pBlocks += 64)
+	{
+		UINT_32 a = pState[0], b = pState[1], c = pState[2], d = pState[3], e = pState[4];
+
+		memcpy(&block, pBlocks, 64);
+
+		// 4 rounds of 20 operations each. Loop unrolled.
+		_R0(a,b,c,d,e, 0); _R0(e,a,b,c,d, 1); _R0(d,e,a,b,c, 2); _R0(c,d,e,a,b, 3);
+		_R0(b,c,d,e,a, 4); _R0(a,b,c,d,e, 5); _R0(e,a,b,c,d, 6); _R0(d,e,a,b,c, 7);
+		_R0(c,d,e,a,b, 8); _R0(b,c,d,e,a, 9); _R0(a,b,c,d,e,10); _R0(e,a,b,c,d,11);
+		_R0(d,e,a,b,c,12); _R0(c,d,e,a,b,13); _R0(b,c,d,e,a,14); _R0(a,b,c,d,e,15);
+		_R1(e,a,b,c,d,16); _R1(d,e,a,b,c,17); _R1(c,d,e,a,b,18); _R1(b,c,d,e,a,19);
+		_R2(a,b,c,d,e,20); _R2(e,a,b,c,d,21); _R2(d,e,a,b,c,22); _R2(c,d,e,a,b,23);
+		_R2(b,c,d,e,a,24); _R2(a,b,c,d,e,25); _R2(e,a,b,c,d,26); _R2(d,e,a,b,c,27);
+		_R2(c,d,e,a,b,28); _R2(b,c,d,e,a,29); _R2(a,b,c,d,e,30); _R2(e,a,b,c,d,31);
+		_R2(d,e,a,b,c,32); _R2(c,d,e,a,b,33); _R2(b,c,d,e,a,34); _R2(a,b,c,d,e,35);
+		_R2(e,a,b,c,d,36); _R2(d,e,a,b,c,37); _R2(c,d,e,a,b,38); _R2(b,c,d,e,a,39);
+		_R3(a,b,c,d,e,40); _R3(e,a,b,c,d,41); _R3(d,e,a,b,c,42); _R3(c,d,e,a,b,43);
+		_R3(b,c,d,e,a,44); _R3(a,b,c,d,e,45); _R3(e,a,b,c,d,46); _R3(d,e,a,b,c,47);
+		_R3(c,d,e,a,b,48); _R3(b,c,d,e,a,49); _R3(a,b,c,d,e,50); _R3(e,a,b,c,d,51);
+		_R3(d,e,a,b,c,52); _R3(c,d,e,a,b,53); _R3(b,c,d,e,a,54); _R3(a,b,c,d,e,55);
+		_R3(e,a,b,c,d,56); _R3(d,e,a,b,c,57); _R3(c,d,e,a,b,58); _R3(b,c,d,e,a,59);
+		_R4(a,b,c,d,e,60); _R4(e,a,b,c,d,61); _R4(d,e,a,b,c,62); _R4(c,d,e,a,b,63);
+		_R4(b,c,d,e,a,64); _R4(a,b,c,d,e,65); _R4(e,a,b,c,d,66); _R4(d,e,a,b,c,67);
+		_R4(c,d,e,a,b,68); _R4(b,c,d,e,a,69); _R4(a,b,c,d,e,70); _R4(e,a,b,c,d,71);
+		_R4(d,e,a,b,c,72); _R4(c,d,e,a,b,73); _R4(b,c,d,e,a,74); _R4(a,b,c,d,e,75);
+		_R4(e,a,b,c,d,76); _R4(d,e,a,b,c,77); _R4(c,d,e,a,b,78); _R4(b,c,d,e,a,79);
+
+		// Add the working vars back into state
+		pState[0] += a;
+		pState[1] += b;
+		pState[2] += c;
+		pState[3] += d;
+		pState[4] += e;
+	}
+
+	// Wipe variables
+#ifdef SHA1_WIPE_VARIABLES
+	memset(&block, 0, sizeof(block));
+#endif
+}
+
+#ifdef SHA1_HAVE_X86_SHA
+
+bool HasX86Sha()
+{
+	unsigned int r[4] = { 0, 0, 0, 0 }; // eax, ebx, ecx, edx
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if(info[0] < 7) return false;
+	__cpuid(info, 1);
+	r[2] = (unsigned int)info[2];
+	__cpuidex(info, 7, 0);
+	r[1] = (unsigned int)info[1];
+#else
+	if(__get_cpuid_max(0, 0) < 7) return false;
+	unsigned int a, b, c, d;
+	__cpuid(1, a, b, c, d);
+	r[2] = c;
+	__cpuid_count(7, 0, a, b, c, d);
+	r[1] = b;
+#endif
+	const bool bSSSE3 = (r[2] & (1U << 9)) != 0;
+	const bool bSSE41 = (r[2] & (1U << 19)) != 0;
+	const bool bSHA = (r[1] & (1U << 29)) != 0;
+	return bSSSE3 && bSSE41 && bSHA;
+}
+
+// Four rounds; M[] holds the last four message vectors W[4i-12..4i+3]
+#define SHANI_ROUNDS(i) \
+	if((i) >= 4) \
+		M[(i)&3] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(M[(i)&3], \
+			M[((i)+1)&3]), M[((i)+2)&3]), M[((i)+3)&3]); \
+	E = ((i) == 0) ? _mm_add_epi32(E, M[0]) : _mm_sha1nexte_epu32(EPrev, M[(i)&3]); \
+	EPrev = ABCD; \
+	ABCD = _mm_sha1rnds4_epu32(ABCD, E, (i) / 5);
+
+SHA1_X86_SHA_TARGET
+void TransformX86Sha(UINT_32* pState, const UINT_8* pBlocks, size_t uBlocks)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090A0B0C0D0E0FLL);
+
+	__m128i ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)pState), 0x1B);
+	__m128i E0 = _mm_set_epi32((int)pState[4], 0, 0, 0);
+
+	for( ; uBlocks != 0; --uBlocks, pBlocks += 64)
+	{
+		const __m128i ABCDSave = ABCD;
+		__m128i E = E0, EPrev = E0;
+		__m128i M[4];
+
+		for(int j = 0; j < 4; ++j)
+			M[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pBlocks + 16 * j)), mask);
+
+		SHANI_ROUNDS( 0); SHANI_ROUNDS( 1); SHANI_ROUNDS( 2); SHANI_ROUNDS( 3);
+		SHANI_ROUNDS( 4); SHANI_ROUNDS( 5); SHANI_ROUNDS( 6); SHANI_ROUNDS( 7);
+		SHANI_ROUNDS( 8); SHANI_ROUNDS( 9); SHANI_ROUNDS(10); SHANI_ROUNDS(11);
+		SHANI_ROUNDS(12); SHANI_ROUNDS(13); SHANI_ROUNDS(14); SHANI_ROUNDS(15);
+		SHANI_ROUNDS(16); SHANI_ROUNDS(17); SHANI_ROUNDS(18); SHANI_ROUNDS(19);
+
+		E0 = _mm_sha1nexte_epu32(EPrev, E0);
+		ABCD = _mm_add_epi32(ABCD, ABCDSave);
+	}
+
+	_mm_storeu_si128((__m128i*)pState, _mm_shuffle_epi32(ABCD, 0x1B));
+	pState[4] = (UINT_32)_mm_extract_epi32(E0, 3);
+}
+
+#endif // SHA1_HAVE_X86_SHA
+
+#ifdef SHA1_HAVE_ARMV8_SHA
+
+// Four rounds; M[] holds the last four message vectors W[4i-12..4i+3]
+#define ARMV8_ROUNDS(i, k) \
+	{ \
+		if((i) >= 4) \
+			M[(i)&3] = vsha1su1q_u32(vsha1su0q_u32(M[(i)&3], M[((i)+1)&3], \
+				M[((i)+2)&3]), M[((i)+3)&3]); \
+		const uint32x4_t W = vaddq_u32(M[(i)&3], vdupq_n_u32(k)); \
+		const UINT_32 ENext = vsha1h_u32(vgetq_lane_u32(ABCD, 0)); \
+		if((i) < 5) ABCD = vsha1cq_u32(ABCD, E, W); \
+		else if((i) < 10 || (i) >= 15) ABCD = vsha1pq_u32(ABCD, E, W); \
+		else ABCD = vsha1mq_u32(ABCD, E, W); \
+		E = ENext; \
+	}
+
+void TransformArmV8Sha(UINT_32* pState, const UINT_8* pBlocks, size_t uBlocks)
+{
+	uint32x4_t ABCD = vld1q_u32(pState);
+	UINT_32 E0 = pState[4];
+
+	for( ; uBlocks != 0; --uBlocks, pBlocks += 64)
+	{
+		const uint32x4_t ABCDSave = ABCD;
+		UINT_32 E = E0;
+		uint32x4_t M[4];
+
+		for(int j = 0; j < 4; ++j)
+			M[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(pBlocks + 16 * j)));
+
+		ARMV8_ROUNDS( 0, 0x5A827999); ARMV8_ROUNDS( 1, 0x5A827999);
+		ARMV8_ROUNDS( 2, 0x5A827999); ARMV8_ROUNDS( 3, 0x5A827999);
+		ARMV8_ROUNDS( 4, 0x5A827999); ARMV8_ROUNDS( 5, 0x6ED9EBA1);
+		ARMV8_ROUNDS( 6, 0x6ED9EBA1); ARMV8_ROUNDS( 7, 0x6ED9EBA1);
+		ARMV8_ROUNDS( 8, 0x6ED9EBA1); ARMV8_ROUNDS( 9, 0x6ED9EBA1);
+		ARMV8_ROUNDS(10, 0x8F1BBCDC); ARMV8_ROUNDS(11, 0x8F1BBCDC);
+		ARMV8_ROUNDS(12, 0x8F1BBCDC); ARMV8_ROUNDS(13, 0x8F1BBCDC);
+		ARMV8_ROUNDS(14, 0x8F1BBCDC); ARMV8_ROUNDS(15, 0xCA62C1D6);
+		ARMV8_ROUNDS(16, 0xCA62C1D6); ARMV8_ROUNDS(17, 0xCA62C1D6);
+		ARMV8_ROUNDS(18, 0xCA62C1D6); ARMV8_ROUNDS(19, 0xCA62C1D6);
+
+		E0 += E;
+		ABCD = vaddq_u32(ABCD, ABCDSave);
+	}
+
+	vst1q_u32(pState, ABCD);
+	pState[4] = E0;
+}
+
+#endif // SHA1_HAVE_ARMV8_SHA
+
+SHA1_TRANSFORM_FUNC GetTransform(CSHA1::BACKEND bBackend)
+{
+	switch(bBackend)
+	{
+#ifdef SHA1_HAVE_X86_SHA
+	case CSHA1::BACKEND_X86_SHA:
+		return TransformX86Sha;
+#endif
+#ifdef SHA1_HAVE_ARMV8_SHA
+	case CSHA1::BACKEND_ARMV8_SHA:
+		return TransformArmV8Sha;
+#endif
+	default:
+		return TransformScalar;
+	}
+}
+
+CSHA1::BACKEND DetectBestBackend()
+{
+#ifdef SHA1_HAVE_X86_SHA
+	if(HasX86Sha()) return CSHA1::BACKEND_X86_SHA;
+#endif
+#ifdef SHA1_HAVE_ARMV8_SHA
+	return CSHA1::BACKEND_ARMV8_SHA;
+#endif
+	return CSHA1::BACKEND_SCALAR;
+}
+
+}
+
 CSHA1::CSHA1()
 {
-	m_block = (SHA1_WORKSPACE_BLOCK*)m_workspace;
+	SetBackend(GetBestBackend());
 
 	Reset();
 }
@@ -65,47 +287,6 @@ void CSHA1::Reset()
 	m_count[1] = 0;
 }
 
-void CSHA1::Transform(UINT_32* pState, const UINT_8* pBuffer)
-{
-	UINT_32 a = pState[0], b = pState[1], c = pState[2], d = pState[3], e = pState[4];
-
-	memcpy(m_block, pBuffer, 64);
-
-	// 4 rounds of 20 operations each. Loop unrolled.
-	_R0(a,b,c,d,e, 0); _R0(e,a,b,c,d, 1); _R0(d,e,a,b,c, 2); _R0(c,d,e,a,b, 3);
-	_R0(b,c,d,e,a, 4); _R0(a,b,c,d,e, 5); _R0(e,a,b,c,d, 6); _R0(d,e,a,b,c, 7);
-	_R0(c,d,e,a,b, 8); _R0(b,c,d,e,a, 9); _R0(a,b,c,d,e,10); _R0(e,a,b,c,d,11);
-	_R0(d,e,a,b,c,12); _R0(c,d,e,a,b,13); _R0(b,c,d,e,a,14); _R0(a,b,c,d,e,15);
-	_R1(e,a,b,c,d,16); _R1(d,e,a,b,c,17); _R1(c,d,e,a,b,18); _R1(b,c,d,e,a,19);
-	_R2(a,b,c,d,e,20); _R2(e,a,b,c,d,21); _R2(d,e,a,b,c,22); _R2(c,d,e,a,b,23);
-	_R2(b,c,d,e,a,24); _R2(a,b,c,d,e,25); _R2(e,a,b,c,d,26); _R2(d,e,a,b,c,27);
-	_R2(c,d,e,a,b,28); _R2(b,c,d,e,a,29); _R2(a,b,c,d,e,30); _R2(e,a,b,c,d,31);
-	_R2(d,e,a,b,c,32); _R2(c,d,e,a,b,33); _R2(b,c,d,e,a,34); _R2(a,b,c,d,e,35);
-	_R2(e,a,b,c,d,36); _R2(d,e,a,b,c,37); _R2(c,d,e,a,b,38); _R2(b,c,d,e,a,39);
-	_R3(a,b,c,d,e,40); _R3(e,a,b,c,d,41); _R3(d,e,a,b,c,42); _R3(c,d,e,a,b,43);
-	_R3(b,c,d,e,a,44); _R3(a,b,c,d,e,45); _R3(e,a,b,c,d,46); _R3(d,e,a,b,c,47);
-	_R3(c,d,e,a,b,48); _R3(b,c,d,e,a,49); _R3(a,b,c,d,e,50); _R3(e,a,b,c,d,51);
-	_R3(d,e,a,b,c,52); _R3(c,d,e,a,b,53); _R3(b,c,d,e,a,54); _R3(a,b,c,d,e,55);
-	_R3(e,a,b,c,d,56); _R3(d,e,a,b,c,57); _R3(c,d,e,a,b,58); _R3(b,c,d,e,a,59);
-	_R4(a,b,c,d,e,60); _R4(e,a,b,c,d,61); _R4(d,e,a,b,c,62); _R4(c,d,e,a,b,63);
-	_R4(b,c,d,e,a,64); _R4(a,b,c,d,e,65); _R4(e,a,b,c,d,66); _R4(d,e,a,b,c,67);
-	_R4(c,d,e,a,b,68); _R4(b,c,d,e,a,69); _R4(a,b,c,d,e,70); _R4(e,a,b,c,d,71);
-	_R4(d,e,a,b,c,72); _R4(c,d,e,a,b,73); _R4(b,c,d,e,a,74); _R4(a,b,c,d,e,75);
-	_R4(e,a,b,c,d,76); _R4(d,e,a,b,c,77); _R4(c,d,e,a,b,78); _R4(b,c,d,e,a,79);
-
-	// Add the working vars back into state
-	pState[0] += a;
-	pState[1] += b;
-	pState[2] += c;
-	pState[3] += d;
-	pState[4] += e;
-
-	// Wipe variables
-#ifdef SHA1_WIPE_VARIABLES
-	a = b = c = d = e = 0;
-#endif
-}
-
 // Use this function to hash in binary data and strings
 void CSHA1::Update(const UINT_8* pbData, UINT_32 uLen)
 {
@@ -121,10 +302,12 @@ void CSHA1::Update(const UINT_8* pbData, UINT_32 uLen)
 	{
 		i = 64 - j;
 		memcpy(&m_buffer[j], pbData, i);
-		Transform(m_state, m_buffer);
+		m_transform(m_state, m_buffer, 1);
 
-		for( ; (i + 63) < uLen; i += 64)
-			Transform(m_state, &pbData[i]);
+		// Hand all remaining complete blocks to the backend at once
+		const UINT_32 uBlocks = (uLen - i) / 64;
+		m_transform(m_state, &pbData[i], uBlocks);
+		i += uBlocks * 64;
 
 		j = 0;
 	}
@@ -198,7 +381,6 @@ void CSHA1::Final()
 	memset(m_state, 0, 20);
 	memset(m_count, 0, 8);
 	memset(finalcount, 0, 8);
-	Transform(m_state, m_buffer);
 #endif
 }
 
@@ -256,3 +438,56 @@ bool CSHA1::GetHash(UINT_8* pbDest) const
 	memcpy(pbDest, m_digest, 20);
 	return true;
 }
+
+bool CSHA1::IsBackendSupported(BACKEND bBackend)
+{
+	switch(bBackend)
+	{
+	case BACKEND_SCALAR:
+		return true;
+#ifdef SHA1_HAVE_X86_SHA
+	case BACKEND_X86_SHA:
+		return HasX86Sha();
+#endif
+#ifdef SHA1_HAVE_ARMV8_SHA
+	case BACKEND_ARMV8_SHA:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+CSHA1::BACKEND CSHA1::GetBestBackend()
+{
+	static const BACKEND bBest = DetectBestBackend();
+	return bBest;
+}
+
+const char* CSHA1::GetBackendName(BACKEND bBackend)
+{
+	switch(bBackend)
+	{
+	case BACKEND_SCALAR:
+		return "scalar";
+	case BACKEND_X86_SHA:
+		return "x86-sha";
+	case BACKEND_ARMV8_SHA:
+		return "armv8-sha";
+	default:
+		return "unknown";
+	}
+}
+
+bool CSHA1::SetBackend(BACKEND bBackend)
+{
+	if(!IsBackendSupported(bBackend)) return false;
+	m_backend = bBackend;
+	m_transform = GetTransform(bBackend);
+	return true;
+}
+
+CSHA1::BACKEND CSHA1::GetBackend() const
+{
+	return m_backend;
+}
@@ -97,6 +97,8 @@
 #include <string>
 #endif
 
+#include <stddef.h>
+
 #ifdef _MSC_VER
 #include <stdlib.h>
 #endif
@@ -111,9 +113,10 @@
 
 // If you want variable wiping, #define SHA1_WIPE_VARIABLES, if not,
 // #define SHA1_NO_WIPE_VARIABLES. If you don't define anything, it
-// defaults to wiping.
+// defaults to no wiping: TagLib only hashes audio data for signatures,
+// which is not secret.
 #if !defined(SHA1_WIPE_VARIABLES) && !defined(SHA1_NO_WIPE_VARIABLES)
-#define SHA1_WIPE_VARIABLES
+#define SHA1_NO_WIPE_VARIABLES
 #endif
 
 #if defined(SHA1_HAS_TCHAR)
@@ -191,6 +194,9 @@ typedef union
 	UINT_32 l[16];
 } SHA1_WORKSPACE_BLOCK;
 
+// Compresses uBlocks consecutive 64 byte blocks into pState
+typedef void (*SHA1_TRANSFORM_FUNC)(UINT_32* pState, const UINT_8* pBlocks, size_t uBlocks);
+
 class CSHA1
 {
 public:
@@ -204,6 +210,14 @@ public:
 	};
 #endif
 
+	// Block transformation backends
+	enum BACKEND
+	{
+		BACKEND_SCALAR = 0,    // Portable C implementation
+		BACKEND_X86_SHA = 1,   // x86 SHA extensions (SHA-NI), SSSE3 and SSE4.1
+		BACKEND_ARMV8_SHA = 2  // ARMv8 cryptography extensions, needs SHA1_ENABLE_ARMV8_SHA
+	};
+
 	// Constructor and destructor
 	CSHA1();
 	~CSHA1();
@@ -239,13 +253,18 @@ public:
 
 	bool GetHash(UINT_8* pbDest) const;
 
-private:
-	// Private SHA-1 transformation
-	void Transform(UINT_32* pState, const UINT_8* pBuffer);
+	// Backend selection. New instances use the fastest backend supported by
+	// the CPU; SetBackend returns false if the backend is not available.
+	static bool IsBackendSupported(BACKEND bBackend);
+	static BACKEND GetBestBackend();
+	static const char* GetBackendName(BACKEND bBackend);
+	bool SetBackend(BACKEND bBackend);
+	BACKEND GetBackend() const;
 
+private:
 	// Member variables
-	UINT_8 m_workspace[64];
-	SHA1_WORKSPACE_BLOCK* m_block; // SHA1 pointer to the byte array above
+	BACKEND m_backend;
+	SHA1_TRANSFORM_FUNC m_transform;
 };
 
 #endif // ___SHA1_HDR___
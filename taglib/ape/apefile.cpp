@@ -87,20 +87,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-APE::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+APE::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-APE::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+APE::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 APE::File::~File()
@@ -244,7 +244,7 @@ bool APE::File::hasID3v1Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void APE::File::read(bool readProperties)
+void APE::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -297,6 +297,6 @@ void APE::File::read(bool readProperties)
       seek(0);
     }
 
-    d->properties = new Properties(this, streamLength);
+    d->properties = new Properties(this, streamLength, propertiesStyle);
   }
 }
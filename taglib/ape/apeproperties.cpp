@@ -35,6 +35,7 @@
 #include "apefile.h"
 #include "apetag.h"
 #include "apefooter.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 
@@ -57,6 +58,7 @@ public:
   int version;
   int bitsPerSample;
   unsigned int sampleFrames;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,7 +76,9 @@ APE::Properties::Properties(File *file, long streamLength, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
+  const long streamOffset = file->tell();
   read(file, streamLength);
+  d->signature.setRegion(file, streamOffset, streamLength, style);
 }
 
 APE::Properties::~Properties()
@@ -117,6 +121,11 @@ int APE::Properties::version() const
   return d->version;
 }
 
+ByteVector APE::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 int APE::Properties::bitsPerSample() const
 {
   return d->bitsPerSample;
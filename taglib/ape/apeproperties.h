@@ -125,6 +125,11 @@ namespace TagLib {
        */
       int version() const;
 
+      /*!
+       * Returns the SHA1 signature of the audio stream
+       */
+      virtual ByteVector signature() const;
+
     private:
       Properties(const Properties &);
       Properties &operator=(const Properties &);
@@ -33,6 +33,14 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The picture fields preceding the image data are read with this much of
+  // the value when the image data is read on demand.
+
+  const unsigned int PictureFieldsSize = 4096;
+}
+
 class ASF::Attribute::AttributePrivate : public RefCounter
 {
 public:
@@ -176,7 +184,7 @@ ASF::Picture ASF::Attribute::toPicture() const
   return d->pictureValue;
 }
 
-String ASF::Attribute::parse(ASF::File &f, int kind)
+String ASF::Attribute::parse(ASF::File &f, int kind, bool lazyPicture)
 {
   unsigned int size, nameLength;
   String name;
@@ -233,6 +241,17 @@ String ASF::Attribute::parse(ASF::File &f, int kind)
     break;
 
   case BytesType:
+    if(lazyPicture && size > PictureFieldsSize && name == "WM/Picture") {
+      const long long offset = f.tell();
+      if(d->pictureValue.parse(f.readBlock(PictureFieldsSize), &f, offset, size)) {
+        f.seek(offset + size);
+        return name;
+      }
+      f.seek(offset);
+    }
+    d->byteVectorValue = f.readBlock(size);
+    break;
+
   case GuidType:
     d->byteVectorValue = f.readBlock(size);
     break;
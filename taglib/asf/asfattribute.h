@@ -187,7 +187,7 @@ namespace TagLib
 
 #ifndef DO_NOT_DOCUMENT
       /* THIS IS PRIVATE, DON'T TOUCH IT! */
-      String parse(ASF::File &file, int kind = 0);
+      String parse(ASF::File &file, int kind = 0, bool lazyPicture = false);
 #endif
 
       //! Returns the size of the stored data
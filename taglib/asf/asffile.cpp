@@ -51,6 +51,7 @@ public:
 
   FilePrivate():
     headerSize(0),
+    lazyPictures(false),
     tag(0),
     properties(0),
     contentDescriptionObject(0),
@@ -69,6 +70,7 @@ public:
   }
 
   unsigned long long headerSize;
+  bool lazyPictures;
 
   ASF::Tag *tag;
   ASF::Properties *properties;
@@ -303,7 +305,7 @@ void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *
   int count = readWORD(file);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file);
+    String name = attribute.parse(*file, 0, file->d->lazyPictures);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -327,7 +329,7 @@ void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, unsigned int
   int count = readWORD(file);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 1);
+    String name = attribute.parse(*file, 1, file->d->lazyPictures);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -351,7 +353,7 @@ void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, unsig
   int count = readWORD(file);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 2);
+    String name = attribute.parse(*file, 2, file->d->lazyPictures);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -477,20 +479,22 @@ void ASF::File::FilePrivate::CodecListObject::parse(ASF::File *file, unsigned in
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-ASF::File::File(FileName file, bool, Properties::ReadStyle) :
+ASF::File::File(FileName file, bool, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
+  d->lazyPictures = (propertiesStyle & Properties::LazyTags) != 0;
   if(isOpen())
-    read();
+    read(propertiesStyle);
 }
 
-ASF::File::File(IOStream *stream, bool, Properties::ReadStyle) :
+ASF::File::File(IOStream *stream, bool, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
+  d->lazyPictures = (propertiesStyle & Properties::LazyTags) != 0;
   if(isOpen())
-    read();
+    read(propertiesStyle);
 }
 
 ASF::File::~File()
@@ -535,6 +539,10 @@ bool ASF::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before the audio data is moved.
+
+  d->properties->signature();
+
   if(!d->contentDescriptionObject) {
     d->contentDescriptionObject = new FilePrivate::ContentDescriptionObject();
     d->objects.append(d->contentDescriptionObject);
@@ -611,7 +619,7 @@ bool ASF::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void ASF::File::read()
+void ASF::File::read(Properties::ReadStyle propertiesStyle)
 {
   if(!isValid())
     return;
@@ -680,4 +688,9 @@ void ASF::File::read()
     obj->parse(this, size);
     d->objects.append(obj);
   }
+
+  // The data object and the index objects follow the header.
+
+  if(isValid() && d->headerSize < static_cast<unsigned long long>(length()))
+    d->properties->setSignatureRegion(this, d->headerSize, length() - d->headerSize, propertiesStyle);
 }
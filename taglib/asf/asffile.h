@@ -50,9 +50,10 @@ namespace TagLib {
       /*!
        * Constructs an ASF file from \a file.
        *
-       * \note In the current implementation, both \a readProperties and
-       * \a propertiesStyle are ignored.  The audio properties are always
-       * read.
+       * \note In the current implementation, \a readProperties is ignored.
+       * The audio properties are always read.  Only the signature flags and
+       * the LazyTags flag of \a propertiesStyle are used; with the latter,
+       * the image data of the pictures is read when it is first accessed.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -60,9 +61,10 @@ namespace TagLib {
       /*!
        * Constructs an ASF file from \a stream.
        *
-       * \note In the current implementation, both \a readProperties and
-       * \a propertiesStyle are ignored.  The audio properties are always
-       * read.
+       * \note In the current implementation, \a readProperties is ignored.
+       * The audio properties are always read.  Only the signature flags and
+       * the LazyTags flag of \a propertiesStyle are used; with the latter,
+       * the image data of the pictures is read when it is first accessed.
        *
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
@@ -116,7 +118,7 @@ namespace TagLib {
       virtual bool save();
 
     private:
-      void read();
+      void read(Properties::ReadStyle propertiesStyle);
 
       class FilePrivate;
       FilePrivate *d;
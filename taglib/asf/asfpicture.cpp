@@ -37,11 +37,16 @@ using namespace TagLib;
 class ASF::Picture::PicturePrivate : public RefCounter
 {
 public:
+  PicturePrivate() {}
+
   bool valid;
   Type type;
   String mimeType;
   String description;
   ByteVector picture;
+
+  // Set while the image data is still to be read from the file.
+  PictureHandle handle;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,19 +108,36 @@ void ASF::Picture::setDescription(const String &desc)
 
 ByteVector ASF::Picture::picture() const
 {
+  if(!d->handle.isNull()) {
+    d->picture = d->handle.data();
+    d->handle = PictureHandle();
+  }
   return d->picture;
 }
 
 void ASF::Picture::setPicture(const ByteVector &p)
 {
   d->picture = p;
+  d->handle = PictureHandle();
+}
+
+PictureHandle ASF::Picture::handle() const
+{
+  if(!d->handle.isNull() &&
+     d->handle.mimeType() == d->mimeType &&
+     d->handle.type() == d->type &&
+     d->handle.description() == d->description) {
+    return d->handle;
+  }
+
+  return PictureHandle(picture(), d->mimeType, d->type, d->description);
 }
 
 int ASF::Picture::dataSize() const
 {
   return
     9 + (d->mimeType.length() + d->description.length()) * 2 +
-    d->picture.size();
+    (!d->handle.isNull() ? d->handle.size() : d->picture.size());
 }
 
 ASF::Picture& ASF::Picture::operator=(const ASF::Picture& other)
@@ -136,43 +158,71 @@ ByteVector ASF::Picture::render() const
   if(!isValid())
     return ByteVector();
 
+  const ByteVector data = picture();
+
   return
     ByteVector((char)d->type) +
-    ByteVector::fromUInt(d->picture.size(), false) +
+    ByteVector::fromUInt(data.size(), false) +
     renderString(d->mimeType) +
     renderString(d->description) +
-    d->picture;
+    data;
 }
 
 void ASF::Picture::parse(const ByteVector& bytes)
+{
+  unsigned int dataLen = 0;
+  const int pos = parseFields(bytes, dataLen);
+  if(pos < 0 || dataLen + pos != bytes.size())
+    return;
+
+  d->picture = bytes.mid(pos, dataLen);
+  d->handle = PictureHandle();
+  d->valid = true;
+  return;
+}
+
+bool ASF::Picture::parse(const ByteVector &bytes, TagLib::File *file, long long offset,
+                         unsigned int size)
+{
+  unsigned int dataLen = 0;
+  const int pos = parseFields(bytes, dataLen);
+  if(pos < 0 || dataLen + pos != size)
+    return false;
+
+  d->picture.clear();
+  d->handle = PictureHandle(file, offset + pos, dataLen, d->mimeType, d->type, d->description);
+  d->valid = true;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+int ASF::Picture::parseFields(const ByteVector &bytes, unsigned int &dataLen)
 {
   d->valid = false;
   if(bytes.size() < 9)
-    return;
+    return -1;
   int pos = 0;
   d->type = (Type)bytes[0]; ++pos;
-  const unsigned int dataLen = bytes.toUInt(pos, false); pos+=4;
+  dataLen = bytes.toUInt(pos, false); pos+=4;
 
   const ByteVector nullStringTerminator(2, 0);
 
   int endPos = bytes.find(nullStringTerminator, pos, 2);
   if(endPos < 0)
-    return;
+    return -1;
   d->mimeType = String(bytes.mid(pos, endPos - pos), String::UTF16LE);
   pos = endPos+2;
 
   endPos = bytes.find(nullStringTerminator, pos, 2);
   if(endPos < 0)
-    return;
+    return -1;
   d->description = String(bytes.mid(pos, endPos - pos), String::UTF16LE);
   pos = endPos+2;
 
-  if(dataLen + pos != bytes.size())
-    return;
-
-  d->picture = bytes.mid(pos, dataLen);
-  d->valid = true;
-  return;
+  return pos;
 }
 
 ASF::Picture ASF::Picture::fromInvalid()
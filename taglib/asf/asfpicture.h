@@ -29,6 +29,7 @@
 #include "tstring.h"
 #include "tbytevector.h"
 #include "taglib_export.h"
+#include "tpicturehandle.h"
 #include "attachedpictureframe.h"
 
 namespace TagLib
@@ -196,6 +197,12 @@ namespace TagLib
        */
       void setPicture(const ByteVector &p);
 
+      /*!
+       * Returns a handle for the picture.  If the image data has not been
+       * read yet, the handle refers to it in the file.
+       */
+      PictureHandle handle() const;
+
       /*!
        * Returns picture as binary raw data \a value
        */
@@ -209,10 +216,13 @@ namespace TagLib
 #ifndef DO_NOT_DOCUMENT
       /* THIS IS PRIVATE, DON'T TOUCH IT! */
       void parse(const ByteVector& );
+      bool parse(const ByteVector &bytes, TagLib::File *file, long long offset, unsigned int size);
       static Picture fromInvalid();
 #endif
 
       private:
+        int parseFields(const ByteVector &bytes, unsigned int &dataLen);
+
         class PicturePrivate;
         PicturePrivate *d;
       };
@@ -26,6 +26,7 @@
 #include <tdebug.h>
 #include <tstring.h>
 #include "asfproperties.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 
@@ -50,6 +51,7 @@ public:
   String codecName;
   String codecDescription;
   bool encrypted;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -122,6 +124,11 @@ bool ASF::Properties::isEncrypted() const
   return d->encrypted;
 }
 
+ByteVector ASF::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -192,3 +199,9 @@ void ASF::Properties::setEncrypted(bool value)
 {
   d->encrypted = value;
 }
+
+void ASF::Properties::setSignatureRegion(TagLib::File *file, long long offset, long long length,
+                                         ReadStyle style)
+{
+  d->signature.setRegion(file, offset, length, style);
+}
@@ -32,6 +32,8 @@
 
 namespace TagLib {
 
+  class File;
+
   namespace ASF {
 
     //! An implementation of ASF audio properties
@@ -159,6 +161,11 @@ namespace TagLib {
        */
       bool isEncrypted() const;
 
+      /*!
+       * Returns the SHA1 signature of the audio data
+       */
+      virtual ByteVector signature() const;
+
 #ifndef DO_NOT_DOCUMENT
       // deprecated
       void setLength(int value);
@@ -172,6 +179,8 @@ namespace TagLib {
       void setCodecName(const String &value);
       void setCodecDescription(const String &value);
       void setEncrypted(bool value);
+      void setSignatureRegion(TagLib::File *file, long long offset, long long length,
+                              ReadStyle style);
 #endif
 
     private:
@@ -50,6 +50,18 @@ namespace TagLib {
      * file.  Because in many situations speed is critical or the accuracy of the
      * values is not particularly important this allows the level of desired
      * accuracy to be set.
+     *
+     * NoSignature and LazySignature are flags which may be OR-ed with one of
+     * the levels above to control when the audio signature is computed, e.g.
+     * <tt>AudioProperties::Average | AudioProperties::LazySignature</tt>.
+     * Code that checks the level has to mask it with ReadStyleLevelMask first.
+     *
+     * LazyTags may be OR-ed in the same way to defer reading large parts of
+     * tags until they are first accessed.  It is currently honored by
+     * MPEG::File for the ID3v2 tag, and by FLAC::File, MP4::File and
+     * ASF::File for the image data of embedded pictures.
+     *
+     * \see signature()
      */
     enum ReadStyle {
       //! Read as little of the file as possible
@@ -57,7 +69,15 @@ namespace TagLib {
       //! Read more of the file and make better values guesses
       Average,
       //! Read as much of the file as needed to report accurate values
-      Accurate
+      Accurate,
+      //! Don't compute the audio signature at all
+      NoSignature   = 0x100,
+      //! Compute the audio signature on the first call to signature()
+      LazySignature = 0x200,
+      //! Defer reading tags or embedded pictures until they are accessed
+      LazyTags      = 0x400,
+      //! Selects Fast, Average or Accurate from a style with flags OR-ed in
+      ReadStyleLevelMask = 0xFF
     };
 
     /*!
@@ -104,6 +124,14 @@ namespace TagLib {
      */
     virtual int channels() const = 0;
 
+    /*!
+     * Returns the SHA1 signature of the audio content, or a null ByteVector if
+     * the format doesn't provide one or it wasn't computed.
+     *
+     * By default the signature is computed while reading the properties.  If
+     * the properties were read with the LazySignature flag the audio is only
+     * sampled on the first call, which requires the file to still be open.
+     */
     virtual ByteVector signature() const {
       return ByteVector::null;
     }
@@ -127,6 +155,15 @@ namespace TagLib {
     AudioPropertiesPrivate *d;
   };
 
+  /*!
+   * Combines a ReadStyle level with the signature flags.
+   */
+  inline AudioProperties::ReadStyle operator|(AudioProperties::ReadStyle a,
+                                              AudioProperties::ReadStyle b)
+  {
+    return static_cast<AudioProperties::ReadStyle>(static_cast<int>(a) | static_cast<int>(b));
+  }
+
 }
 
 #endif
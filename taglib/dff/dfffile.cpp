@@ -110,8 +110,16 @@ TagLib::Tag *DFFFile::tag() const
 void DFFFile::read(bool readProperties, 
 		   TagLib::AudioProperties::ReadStyle propertiesStyle)
 {
-    if(readProperties) {
-        d->properties = new DFFProperties(this, propertiesStyle);
-        d->fileSize = d->properties->fileSize();
-    }
+    // The header is validated even if the audio properties were not asked
+    // for, in which case there is no signature to compute.
+    DFFProperties *properties = new DFFProperties(this, readProperties ? propertiesStyle :
+                                                  propertiesStyle | TagLib::AudioProperties::NoSignature);
+    d->fileSize = properties->fileSize();
+    if (properties->sampleRate() == 0)
+        setValid(false); // didn't get sane properties
+
+    if(readProperties)
+        d->properties = properties;
+    else
+        delete properties;
 }
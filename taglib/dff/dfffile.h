@@ -39,7 +39,8 @@ class DFFFile : public TagLib::File
    * Constructs an DFF file from \a file.  If \a readProperties is true the
    * file's audio properties will also be read.
    *
-   * \note In the current implementation, \a propertiesStyle is ignored.
+   * \note In the current implementation, only the signature flags of
+   * \a propertiesStyle are used.
    *
    * \deprecated This constructor will be dropped in favor of the one below
    * in a future version.
@@ -56,7 +57,8 @@ class DFFFile : public TagLib::File
    * \note TagLib will *not* take ownership of the stream, the caller is
    * responsible for deleting it after the File object.
    *
-   * \note In the current implementation, \a propertiesStyle is ignored.
+   * \note In the current implementation, only the signature flags of
+   * \a propertiesStyle are used.
    */
   DFFFile(TagLib::IOStream *stream, 
 	  bool readProperties = true,
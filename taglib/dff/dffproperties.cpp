@@ -55,7 +55,7 @@ public:
   int bitsPerSample;
   unsigned int version;
   unsigned short channelType;
-  ByteVector signature;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,7 +134,7 @@ int DFFProperties::bitsPerSample() const
 
 ByteVector DFFProperties::signature() const
 {
-  return d->signature;
+  return d->signature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -164,5 +164,5 @@ void DFFProperties::read()
   ulonglong data_start = h.dataStart();
   ulonglong data_end   = h.dataEnd();
 
-  d->signature = taglib_make_signature(d->file, data_start, data_end - data_start);
+  d->signature.setRegion(d->file, data_start, data_end - data_start, d->style);
 }
@@ -43,7 +43,8 @@ public:
     fileSize(0),
     tag(0),
     hasID3v2(false),
-    properties(0)
+    properties(0),
+    propertiesStyle(TagLib::AudioProperties::Average)
   {}
 
   ~FilePrivate()
@@ -65,6 +66,7 @@ public:
   bool hasID3v2;
 
   DSFProperties *properties;
+  TagLib::AudioProperties::ReadStyle propertiesStyle;
 
   static inline TagLib::ByteVector& uint64ToVector(unsigned long long num, 
 						   TagLib::ByteVector &v) 
@@ -196,6 +198,11 @@ bool DSFFile::save(int id3v2Version, bool shrink)
 
   bool success = true;
 
+  // Frames skipped by the ID3v2 frame filter are read before anything moves.
+
+  if(d->tag)
+    d->tag->readSkippedFrames();
+
   if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
     if (shrink) // remove padding 0's
       d->shrinkTag();
@@ -246,9 +253,10 @@ bool DSFFile::save(int id3v2Version, bool shrink)
   }
 
   // Reinitialize properties because DSD header may have been changed
-  delete d->properties;
-  d->properties = new DSFProperties(this, 
-				    TagLib::AudioProperties::Average);
+  if(d->properties) {
+    delete d->properties;
+    d->properties = new DSFProperties(this, d->propertiesStyle);
+  }
 
   return success;
 }
@@ -283,16 +291,25 @@ bool DSFFile::secondSynchByte(char byte)
 void DSFFile::read(bool readProperties, 
 		   TagLib::AudioProperties::ReadStyle propertiesStyle)
 {
-  if(readProperties)
-    d->properties = new DSFProperties(this, propertiesStyle);
-  if (d->properties->sampleRate() == 0) {
-      delete d->properties;
-      d->properties = 0;
+  d->propertiesStyle = propertiesStyle;
+
+  // The header is needed to find the ID3v2 tag even if the audio properties
+  // were not asked for, in which case there is no signature to compute.
+  DSFProperties *properties = new DSFProperties(this, readProperties ? propertiesStyle :
+                                                propertiesStyle | TagLib::AudioProperties::NoSignature);
+  if (properties->sampleRate() == 0) {
+      delete properties;
+      setValid(false);
       return; // didn't get sane properties
   }
 
-  d->ID3v2Location = d->properties->ID3v2Offset();
-  d->fileSize = d->properties->fileSize();
+  d->ID3v2Location = properties->ID3v2Offset();
+  d->fileSize = properties->fileSize();
+
+  if(readProperties)
+    d->properties = properties;
+  else
+    delete properties;
 
   if(d->ID3v2Location > 0) {
     d->tag = new TagLib::ID3v2::Tag(this, d->ID3v2Location, d->ID3v2FrameFactory);
@@ -48,7 +48,8 @@ class DSFFile : public TagLib::File
    * Constructs an DSF file from \a file.  If \a readProperties is true the
    * file's audio properties will also be read.
    *
-   * \note In the current implementation, \a propertiesStyle is ignored.
+   * \note In the current implementation, only the signature flags of
+   * \a propertiesStyle are used.
    *
    * \deprecated This constructor will be dropped in favor of the one below
    * in a future version.
@@ -64,7 +65,8 @@ class DSFFile : public TagLib::File
    * If this file contains and ID3v2 tag the frames will be created using
    * \a frameFactory.
    *
-   * \note In the current implementation, \a propertiesStyle is ignored.
+   * \note In the current implementation, only the signature flags of
+   * \a propertiesStyle are used.
    */
   // BIC: merge with the above constructor
   DSFFile(TagLib::FileName file, TagLib::ID3v2::FrameFactory *frameFactory,
@@ -82,7 +84,8 @@ class DSFFile : public TagLib::File
    * If this file contains and ID3v2 tag the frames will be created using
    * \a frameFactory.
    *
-   * \note In the current implementation, \a propertiesStyle is ignored.
+   * \note In the current implementation, only the signature flags of
+   * \a propertiesStyle are used.
    */
   DSFFile(TagLib::IOStream *stream, TagLib::ID3v2::FrameFactory *frameFactory,
 	  bool readProperties = true,
@@ -57,7 +57,7 @@ public:
   int bitsPerSample;
   DSFHeader::Version version;
   DSFHeader::ChannelType channelType;
-  ByteVector signature;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -141,7 +141,7 @@ int DSFProperties::bitsPerSample() const
 
 ByteVector DSFProperties::signature() const
 {
-  return d->signature;
+  return d->signature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,8 +174,8 @@ void DSFProperties::read()
   ulonglong data_start = DSFHeader::DSD_HEADER_SIZE + DSFHeader::FMT_HEADER_SIZE;
   ulonglong data_end   = (ulonglong)d->file->length();
   // if there is a valid id3v2 offset at end of file, exclude it from audio signature
-  if (d->ID3v2Offset > 0 && d->ID3v2Offset < d->file->length()) {
+  if (d->ID3v2Offset > 0 && d->ID3v2Offset < data_end) {
       data_end = d->ID3v2Offset;
   }
-  d->signature = taglib_make_signature(d->file, data_start, data_end - data_start);
+  d->signature.setRegion(d->file, data_start, data_end - data_start, d->style);
 }
@@ -31,6 +31,8 @@
 #include <tstring.h>
 #include <tdebug.h>
 #include <trefcounter.h>
+#include <tfilestream.h>
+#include <tmappedfilestream.h>
 
 #include "fileref.h"
 #include "asffile.h"
@@ -51,6 +53,10 @@
 #include "s3mfile.h"
 #include "itfile.h"
 #include "xmfile.h"
+#include "dsffile.h"
+#include "dfffile.h"
+#include "id3v2synchdata.h"
+#include "mpegframeheader.h"
 
 using namespace TagLib;
 
@@ -102,13 +108,9 @@ namespace
   }
 
   template <typename T>
-  File* createInternal(T arg, bool readAudioProperties,
-                       AudioProperties::ReadStyle audioPropertiesStyle)
+  File *createByExtension(T arg, bool readAudioProperties,
+                          AudioProperties::ReadStyle audioPropertiesStyle)
   {
-    File *file = resolveFileType(arg, readAudioProperties, audioPropertiesStyle);
-    if(file)
-      return file;
-
 #ifdef _WIN32
     const String s = toFileName(arg).toString();
 #else
@@ -170,23 +172,162 @@ namespace
       return new IT::File(arg, readAudioProperties, audioPropertiesStyle);
     if(ext == "XM")
       return new XM::File(arg, readAudioProperties, audioPropertiesStyle);
+    if(ext == "DSF")
+      return new DSFFile(arg, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+    if(ext == "DFF")
+      return new DFFFile(arg, readAudioProperties, audioPropertiesStyle);
 
     return 0;
   }
+
+  template <typename T>
+  File* createInternal(T arg, bool readAudioProperties,
+                       AudioProperties::ReadStyle audioPropertiesStyle)
+  {
+    File *file = resolveFileType(arg, readAudioProperties, audioPropertiesStyle);
+    if(file)
+      return file;
+
+    return createByExtension(arg, readAudioProperties, audioPropertiesStyle);
+  }
+
+  // The size of the block that is read to detect the file type.  All of the
+  // magic numbers checked below are within it.
+
+  const unsigned int detectionBlockSize = 64;
+
+  // Returns the offset right after an ID3v2 tag at the start of the file, or
+  // 0 if the file does not start with one.
+
+  long id3v2TagEnd(const ByteVector &header)
+  {
+    if(header.size() < 10 || !header.startsWith("ID3"))
+      return 0;
+
+    const unsigned char majorVersion = header[3];
+    const unsigned char flags        = header[5];
+    if(majorVersion == 0xFF || (header[6] | header[7] | header[8] | header[9]) & 0x80)
+      return 0;
+
+    const long footerSize = (flags & 0x10) ? 10 : 0;
+    return 10 + ID3v2::SynchData::toUInt(header.mid(6, 4)) + footerSize;
+  }
+
+  bool isMPEGFrameHeader(const ByteVector &header)
+  {
+    MPEG::FrameHeader frameHeader;
+    return header.size() >= 4 && MPEG::parseFrameHeader(header.toUInt(0, true), frameHeader);
+  }
+
+  // Picks the File subclass from the magic numbers at the beginning of the
+  // stream.  The header is read through the stream that the file is then
+  // created with, so a buffering stream serves the parser's first reads from
+  // the same block instead of reading it again.
+
+  File *detectByContent(IOStream *stream, bool readAudioProperties,
+                        AudioProperties::ReadStyle audioPropertiesStyle)
+  {
+    if(!stream->isOpen())
+      return 0;
+
+    stream->seek(0);
+    ByteVector header = stream->readBlock(detectionBlockSize);
+
+    // These formats may be preceded by an ID3v2 tag, so they are recognized by
+    // what follows it.
+
+    const long tagEnd = id3v2TagEnd(header);
+    if(tagEnd > 0) {
+      stream->seek(tagEnd);
+      header = stream->readBlock(detectionBlockSize);
+    }
+
+    stream->seek(0);
+
+    if(header.startsWith("fLaC"))
+      return new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("MAC "))
+      return new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("TTA1"))
+      return new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("MPCK") || header.startsWith("MP+"))
+      return new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(isMPEGFrameHeader(header))
+      return new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+
+    if(tagEnd > 0)
+      return 0;
+
+    if(header.startsWith("OggS") && header.size() > 27) {
+
+      // The codec is identified by the first packet, which is alone on the
+      // first page.
+
+      const ByteVector packet = header.mid(27 + static_cast<unsigned char>(header[26]));
+      if(packet.startsWith("\x01vorbis"))
+        return new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
+      if(packet.startsWith("\x7F" "FLAC"))
+        return new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+      if(packet.startsWith("Speex   "))
+        return new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
+      if(packet.startsWith("OpusHead"))
+        return new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+      return 0;
+    }
+
+    if(header.containsAt("ftyp", 4))
+      return new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("RIFF") && header.containsAt("WAVE", 8))
+      return new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("FORM") && (header.containsAt("AIFF", 8) || header.containsAt("AIFC", 8)))
+      return new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("wvpk"))
+      return new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith(ByteVector("\x30\x26\xB2\x75\x8E\x66\xCF\x11\xA6\xD9\x00\xAA\x00\x62\xCE\x6C", 16)))
+      return new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("IMPM"))
+      return new IT::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("Extended Module: "))
+      return new XM::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.containsAt("SCRM", 44))
+      return new S3M::File(stream, readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("DSD "))
+      return new DSFFile(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
+    if(header.startsWith("FRM8") && header.containsAt("DSD ", 12))
+      return new DFFFile(stream, readAudioProperties, audioPropertiesStyle);
+
+    return 0;
+  }
+
+  File *createFromStream(IOStream *stream, bool readAudioProperties,
+                         AudioProperties::ReadStyle audioPropertiesStyle,
+                         FileRef::DetectionMode detectionMode)
+  {
+    if(detectionMode == FileRef::DetectByContent) {
+      File *file = detectByContent(stream, readAudioProperties, audioPropertiesStyle);
+      if(file)
+        return file;
+    }
+
+    return createByExtension(stream, readAudioProperties, audioPropertiesStyle);
+  }
 }
 
 class FileRef::FileRefPrivate : public RefCounter
 {
 public:
-  FileRefPrivate(File *f) :
+  FileRefPrivate(File *f, IOStream *s = 0) :
     RefCounter(),
-    file(f) {}
+    file(f),
+    stream(s) {}
 
   ~FileRefPrivate() {
     delete file;
+    delete stream;
   }
 
   File *file;
+  IOStream *stream;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -204,11 +345,52 @@ FileRef::FileRef(FileName fileName, bool readAudioProperties,
 {
 }
 
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle, StreamType streamType,
+                 DetectionMode detectionMode) :
+  d(0)
+{
+  // Custom resolvers only know about file names, so they still go first and
+  // open the file however they like.
+
+  File *file = resolveFileType(fileName, readAudioProperties, audioPropertiesStyle);
+  if(file) {
+    d = new FileRefPrivate(file);
+    return;
+  }
+
+  if(streamType == FileStreamType && detectionMode == DetectByExtension) {
+    d = new FileRefPrivate(createByExtension(fileName, readAudioProperties, audioPropertiesStyle));
+    return;
+  }
+
+  IOStream *stream = 0;
+  if(streamType == MappedStreamType) {
+    stream = new MappedFileStream(fileName);
+    if(!stream->isOpen()) {
+      delete stream;
+      stream = 0;
+    }
+  }
+
+  if(!stream)
+    stream = new FileStream(fileName);
+
+  d = new FileRefPrivate(
+    createFromStream(stream, readAudioProperties, audioPropertiesStyle, detectionMode), stream);
+}
+
 FileRef::FileRef(IOStream* stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle) :
   d(new FileRefPrivate(createInternal(stream, readAudioProperties, audioPropertiesStyle)))
 {
 }
 
+FileRef::FileRef(IOStream *stream, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle, DetectionMode detectionMode) :
+  d(new FileRefPrivate(createFromStream(stream, readAudioProperties, audioPropertiesStyle, detectionMode)))
+{
+}
+
 FileRef::FileRef(File *file) :
   d(new FileRefPrivate(file))
 {
@@ -296,6 +478,8 @@ StringList FileRef::defaultFileExtensions()
   l.append("s3m");
   l.append("it");
   l.append("xm");
+  l.append("dsf");
+  l.append("dff");
 
   return l;
 }
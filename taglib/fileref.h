@@ -108,6 +108,30 @@ namespace TagLib {
                                audioPropertiesStyle = AudioProperties::Average) const = 0;
     };
 
+    /*!
+     * Selects the kind of stream a FileRef opens a file name with.
+     */
+    enum StreamType {
+      //! A FileStream, which can read and write the file
+      FileStreamType,
+      //! A read only MappedFileStream, which serves reads from a memory
+      //! mapping of the file.  save() is not possible with this stream.
+      //! \warning If another process truncates the file while it is open,
+      //! a read may raise SIGBUS on POSIX systems; see MappedFileStream.
+      MappedStreamType
+    };
+
+    /*!
+     * Selects how a FileRef picks the File subclass for a file.
+     */
+    enum DetectionMode {
+      //! Use the extension of the file name
+      DetectByExtension,
+      //! Use the magic numbers at the start of the file, looking past an
+      //! ID3v2 tag, and fall back on the extension if they are not recognized
+      DetectByContent
+    };
+
     /*!
      * Creates a null FileRef.
      */
@@ -127,6 +151,26 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Create a FileRef from \a fileName, opening it with a stream of type
+     * \a streamType.  The stream is owned by the FileRef.  If the file can not
+     * be memory mapped, a regular FileStream is used instead.  The file type
+     * is picked according to \a detectionMode.  The other arguments are the
+     * same as for the constructor above.
+     *
+     * With DetectByContent the file type does not depend on the file name, so
+     * extensionless and mislabeled files can be opened, and only the first
+     * block of the file is read to find it.
+     *
+     * \see StreamType
+     * \see DetectionMode
+     */
+    FileRef(FileName fileName,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            StreamType streamType,
+            DetectionMode detectionMode = DetectByExtension);
+
     /*!
      * Construct a FileRef from an opened \a IOStream.  If \a readAudioProperties
      * is true then the audio properties will be read using \a audioPropertiesStyle.
@@ -144,6 +188,21 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Construct a FileRef from an opened \a IOStream, picking the file type
+     * according to \a detectionMode.  The other arguments are the same as for
+     * the constructor above.
+     *
+     * \note TagLib will *not* take ownership of the stream, the caller is
+     * responsible for deleting it after the File object.
+     *
+     * \see DetectionMode
+     */
+    FileRef(IOStream *stream,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            DetectionMode detectionMode);
+
     /*!
      * Construct a FileRef using \a file.  The FileRef now takes ownership of the
      * pointer and will delete the File when it passes out of scope.
@@ -55,6 +55,9 @@ namespace
   const long MaxPaddingLegnth = 1024 * 1024;
 
   const char LastBlockFlag = '\x80';
+
+  // The amount of a picture block that is read for its fields.
+  const unsigned int PictureFieldsSize = 4096;
 }
 
 class FLAC::File::FilePrivate
@@ -68,7 +71,8 @@ public:
     properties(0),
     flacStart(0),
     streamStart(0),
-    scanned(false)
+    scanned(false),
+    lazyPictures(false)
   {
     blocks.setAutoDelete(true);
   }
@@ -93,36 +97,42 @@ public:
   long flacStart;
   long streamStart;
   bool scanned;
+
+  // Picture blocks only have their fields read; the image is read on demand.
+  bool lazyPictures;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
+  d->lazyPictures = (propertiesStyle & Properties::LazyTags) != 0;
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
+  d->lazyPictures = (propertiesStyle & Properties::LazyTags) != 0;
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
+  d->lazyPictures = (propertiesStyle & Properties::LazyTags) != 0;
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::~File()
@@ -167,6 +177,16 @@ bool FLAC::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before the audio data is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
+  // Frames skipped by the ID3v2 frame filter are read before anything moves.
+
+  if(ID3v2Tag())
+    ID3v2Tag()->readSkippedFrames();
+
   // Create new vorbis comments
   if(!hasXiphComment())
     Tag::duplicate(&d->tag, xiphComment(true), false);
@@ -339,6 +359,17 @@ List<FLAC::Picture *> FLAC::File::pictureList()
   return pictures;
 }
 
+PictureHandleList FLAC::File::pictureHandles() const
+{
+  PictureHandleList handles;
+  for(BlockConstIterator it = d->blocks.begin(); it != d->blocks.end(); ++it) {
+    const Picture *picture = dynamic_cast<const Picture *>(*it);
+    if(picture)
+      handles.append(picture->handle());
+  }
+  return handles;
+}
+
 void FLAC::File::addPicture(Picture *picture)
 {
   d->blocks.append(picture);
@@ -400,7 +431,7 @@ bool FLAC::File::hasID3v2Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void FLAC::File::read(bool readProperties)
+void FLAC::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -443,7 +474,7 @@ void FLAC::File::read(bool readProperties)
     else
       streamLength = length() - d->streamStart;
 
-    d->properties = new Properties(infoData, streamLength);
+    d->properties = new Properties(infoData, this, d->streamStart, streamLength, propertiesStyle);
   }
 }
 
@@ -510,6 +541,25 @@ void FLAC::File::scan()
       return;
     }
 
+    // The fields of a picture block are usually short; the image data that
+    // follows them is read when it's needed.
+
+    if(blockType == MetadataBlock::Picture && d->lazyPictures && blockLength > PictureFieldsSize) {
+      FLAC::Picture *picture = new FLAC::Picture();
+      if(picture->parse(readBlock(PictureFieldsSize), this, nextBlockOffset + 4, blockLength)) {
+        d->blocks.append(picture);
+        nextBlockOffset += blockLength + 4;
+
+        if(isLastBlock)
+          break;
+
+        continue;
+      }
+
+      delete picture;
+      seek(nextBlockOffset + 4);
+    }
+
     const ByteVector data = readBlock(blockLength);
     if(data.size() != blockLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
@@ -87,7 +87,9 @@ namespace TagLib {
        * Constructs a FLAC file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, only the AudioProperties::LazyTags
+       * flag of \a propertiesStyle is used.  With it the image data of picture
+       * blocks is only read when it is needed.
        *
        * \deprecated This constructor will be dropped in favor of the one below
        * in a future version.
@@ -102,7 +104,9 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, only the AudioProperties::LazyTags
+       * flag of \a propertiesStyle is used.  With it the image data of picture
+       * blocks is only read when it is needed.
        */
       // BIC: merge with the above constructor
       File(FileName file, ID3v2::FrameFactory *frameFactory,
@@ -119,7 +123,9 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, only the AudioProperties::LazyTags
+       * flag of \a propertiesStyle is used.  With it the image data of picture
+       * blocks is only read when it is needed.
        */
       // BIC: merge with the above constructor
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
@@ -263,6 +269,15 @@ namespace TagLib {
        */
       List<Picture *> pictureList();
 
+      /*!
+       * Returns handles for the pictures attached to the FLAC file.  For
+       * pictures that have not been read yet the handles refer to the image
+       * data in the file.
+       *
+       * \see Picture::handle()
+       */
+      PictureHandleList pictureHandles() const;
+
       /*!
        * Removes an attached picture. If \a del is true the picture's memory
        * will be freed; if it is false, it must be deleted by the user.
@@ -322,7 +337,7 @@ namespace TagLib {
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       void scan();
 
       class FilePrivate;
@@ -25,6 +25,7 @@
 
 #include <taglib.h>
 #include <tdebug.h>
+#include <tfile.h>
 #include "flacpicture.h"
 
 using namespace TagLib;
@@ -48,6 +49,9 @@ public:
   int colorDepth;
   int numColors;
   ByteVector data;
+
+  // Set while the image data is still to be read from the file.
+  PictureHandle handle;
 };
 
 FLAC::Picture::Picture() :
@@ -73,49 +77,55 @@ int FLAC::Picture::code() const
 
 bool FLAC::Picture::parse(const ByteVector &data)
 {
-  if(data.size() < 32) {
-    debug("A picture block must contain at least 5 bytes.");
+  unsigned int dataLength = 0;
+  const unsigned int pos = parseFields(data, dataLength);
+  if(pos == 0)
     return false;
-  }
 
-  unsigned int pos = 0;
-  d->type = FLAC::Picture::Type(data.toUInt(pos));
-  pos += 4;
-  unsigned int mimeTypeLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + mimeTypeLength + 24 > data.size()) {
+  if(pos + dataLength > data.size()) {
     debug("Invalid picture block.");
     return false;
   }
-  d->mimeType = String(data.mid(pos, mimeTypeLength), String::UTF8);
-  pos += mimeTypeLength;
-  unsigned int descriptionLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + descriptionLength + 20 > data.size()) {
-    debug("Invalid picture block.");
+  d->data = data.mid(pos, dataLength);
+  d->handle = PictureHandle();
+
+  return true;
+}
+
+bool FLAC::Picture::parse(const ByteVector &rawData, TagLib::File *file, long offset,
+                          unsigned int blockLength)
+{
+  unsigned int dataLength = 0;
+  const unsigned int pos = parseFields(rawData, dataLength);
+  if(pos == 0)
     return false;
-  }
-  d->description = String(data.mid(pos, descriptionLength), String::UTF8);
-  pos += descriptionLength;
-  d->width = data.toUInt(pos);
-  pos += 4;
-  d->height = data.toUInt(pos);
-  pos += 4;
-  d->colorDepth = data.toUInt(pos);
-  pos += 4;
-  d->numColors = data.toUInt(pos);
-  pos += 4;
-  unsigned int dataLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + dataLength > data.size()) {
+
+  if(dataLength > blockLength || pos > blockLength - dataLength) {
     debug("Invalid picture block.");
     return false;
   }
-  d->data = data.mid(pos, dataLength);
+
+  d->data.clear();
+  d->handle = PictureHandle(file, offset + pos, dataLength, d->mimeType, d->type, d->description);
 
   return true;
 }
 
+PictureHandle FLAC::Picture::handle() const
+{
+  if(!d->handle.isNull() &&
+     d->handle.mimeType() == d->mimeType &&
+     d->handle.type() == d->type &&
+     d->handle.description() == d->description) {
+    d->handle.setDimensions(d->width, d->height);
+    return d->handle;
+  }
+
+  PictureHandle handle(data(), d->mimeType, d->type, d->description);
+  handle.setDimensions(d->width, d->height);
+  return handle;
+}
+
 ByteVector FLAC::Picture::render() const
 {
   ByteVector result;
@@ -130,8 +140,9 @@ ByteVector FLAC::Picture::render() const
   result.append(ByteVector::fromUInt(d->height));
   result.append(ByteVector::fromUInt(d->colorDepth));
   result.append(ByteVector::fromUInt(d->numColors));
-  result.append(ByteVector::fromUInt(d->data.size()));
-  result.append(d->data);
+  const ByteVector imageData = data();
+  result.append(ByteVector::fromUInt(imageData.size()));
+  result.append(imageData);
   return result;
 }
 
@@ -207,11 +218,60 @@ void FLAC::Picture::setNumColors(int numColors)
 
 ByteVector FLAC::Picture::data() const
 {
+  if(!d->handle.isNull()) {
+    d->data = d->handle.data();
+    d->handle = PictureHandle();
+  }
   return d->data;
 }
 
 void FLAC::Picture::setData(const ByteVector &data)
 {
   d->data = data;
+  d->handle = PictureHandle();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned int FLAC::Picture::parseFields(const ByteVector &data, unsigned int &dataLength)
+{
+  if(data.size() < 32) {
+    debug("A picture block must contain at least 5 bytes.");
+    return 0;
+  }
+
+  unsigned int pos = 0;
+  d->type = FLAC::Picture::Type(data.toUInt(pos));
+  pos += 4;
+  unsigned int mimeTypeLength = data.toUInt(pos);
+  pos += 4;
+  if(pos + mimeTypeLength + 24 > data.size()) {
+    debug("Invalid picture block.");
+    return 0;
+  }
+  d->mimeType = String(data.mid(pos, mimeTypeLength), String::UTF8);
+  pos += mimeTypeLength;
+  unsigned int descriptionLength = data.toUInt(pos);
+  pos += 4;
+  if(pos + descriptionLength + 20 > data.size()) {
+    debug("Invalid picture block.");
+    return 0;
+  }
+  d->description = String(data.mid(pos, descriptionLength), String::UTF8);
+  pos += descriptionLength;
+  d->width = data.toUInt(pos);
+  pos += 4;
+  d->height = data.toUInt(pos);
+  pos += 4;
+  d->colorDepth = data.toUInt(pos);
+  pos += 4;
+  d->numColors = data.toUInt(pos);
+  pos += 4;
+  dataLength = data.toUInt(pos);
+  pos += 4;
+
+  return pos;
 }
 
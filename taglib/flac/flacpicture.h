@@ -29,11 +29,14 @@
 #include "tlist.h"
 #include "tstring.h"
 #include "tbytevector.h"
+#include "tpicturehandle.h"
 #include "taglib_export.h"
 #include "flacmetadatablock.h"
 
 namespace TagLib {
 
+  class File;
+
   namespace FLAC {
 
     class TAGLIB_EXPORT Picture : public MetadataBlock
@@ -167,7 +170,8 @@ namespace TagLib {
       void setNumColors(int numColors);
 
       /*!
-       * Returns the image data.
+       * Returns the image data.  If the picture was read lazily this reads the
+       * data from the file the first time.
        */
       ByteVector data() const;
 
@@ -191,10 +195,28 @@ namespace TagLib {
        */
       bool parse(const ByteVector &rawData);
 
+      /*!
+       * Parse the fields of a picture block from \a rawData, which needs to
+       * contain the block up to at least the image data length, without the
+       * image data itself.  The image data is read from \a file on demand,
+       * where the block of \a blockLength bytes starts at \a offset.  Returns
+       * false if the image data would not fit in the block.
+       */
+      bool parse(const ByteVector &rawData, TagLib::File *file, long offset,
+                 unsigned int blockLength);
+
+      /*!
+       * Returns a handle for the picture.  If the image data has not been
+       * read yet, the handle refers to it in the file.
+       */
+      PictureHandle handle() const;
+
     private:
       Picture(const Picture &item);
       Picture &operator=(const Picture &item);
 
+      unsigned int parseFields(const ByteVector &data, unsigned int &dataLength);
+
       class PicturePrivate;
       PicturePrivate *d;
     };
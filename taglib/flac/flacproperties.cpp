@@ -50,6 +50,7 @@ public:
   int channels;
   unsigned long long sampleFrames;
   ByteVector signature;
+  TaglibSignature streamSignature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -63,6 +64,19 @@ FLAC::Properties::Properties(ByteVector data, long streamLength, ReadStyle style
   read(data, streamLength);
 }
 
+FLAC::Properties::Properties(const ByteVector &data, TagLib::File *file, long long streamOffset,
+                             long long streamLength, ReadStyle style) :
+  AudioProperties(style),
+  d(new PropertiesPrivate())
+{
+  read(data, static_cast<long>(streamLength));
+
+  // Without the MD5 of the audio, fall back to a signature of the frames.
+
+  if(d->signature.isEmpty() && file && streamLength > 0)
+    d->streamSignature.setRegion(file, streamOffset, streamLength, style);
+}
+
 FLAC::Properties::Properties(File *, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
@@ -122,7 +136,10 @@ unsigned long long FLAC::Properties::sampleFrames() const
 
 ByteVector FLAC::Properties::signature() const
 {
-  return d->signature;
+  if(!d->signature.isEmpty())
+    return d->signature;
+
+  return d->streamSignature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -166,6 +183,15 @@ void FLAC::Properties::read(const ByteVector &data, long streamLength)
 
   d->sampleFrames = (hi << 32) | lo;
 
+  // The MD5 of the decoded audio, which is all zeros if the encoder didn't
+  // compute it.
+
+  if(data.size() >= 34) {
+    const ByteVector md5 = data.mid(18, 16);
+    if(md5 != ByteVector(16, '\0'))
+      d->signature = md5;
+  }
+
   if(d->sampleFrames > 0 && d->sampleRate > 0) {
     const double length = d->sampleFrames * 1000.0 / d->sampleRate;
     d->length  = static_cast<int>(length + 0.5);
@@ -31,6 +31,8 @@
 
 namespace TagLib {
 
+  class File;
+
   namespace FLAC {
 
     class File;
@@ -52,6 +54,15 @@ namespace TagLib {
        // BIC: switch to const reference
       Properties(ByteVector data, long streamLength, ReadStyle style = Average);
 
+      /*!
+       * Create an instance of FLAC::Properties with the data read from the
+       * ByteVector \a data.  If the stream info doesn't carry the MD5 of the
+       * audio, the signature is computed from the \a streamLength bytes of
+       * audio frames at \a streamOffset in \a file, as selected by \a style.
+       */
+      Properties(const ByteVector &data, TagLib::File *file, long long streamOffset,
+                 long long streamLength, ReadStyle style = Average);
+
       /*!
        * Create an instance of FLAC::Properties with the data read from the
        * FLAC::File \a file.
@@ -129,7 +140,8 @@ namespace TagLib {
 
       /*!
        * Returns the MD5 signature of the uncompressed audio stream as read
-       * from the stream info header.
+       * from the stream info header.  If the header doesn't have it, the
+       * SHA1 signature of the audio frames is returned instead.
        */
       ByteVector signature() const;
 
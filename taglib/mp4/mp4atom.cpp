@@ -37,9 +37,12 @@ const char *MP4::Atom::containers[11] = {
     "stsd"
 };
 
-MP4::Atom::Atom(File *file)
+MP4::Atom::Atom(File *file) :
+  file(file),
+  headerLength(8),
+  unread(false)
 {
-  children.setAutoDelete(true);
+  childAtoms.setAutoDelete(true);
 
   offset = file->tell();
   ByteVector header = file->readBlock(8);
@@ -64,6 +67,7 @@ MP4::Atom::Atom(File *file)
     if(longLength <= LONG_MAX) {
       // The actual length fits in long. That's always the case if long is 64-bit.
       length = static_cast<long>(longLength);
+      headerLength = 16;
     }
     else {
       debug("MP4: 64-bit atoms are not supported");
@@ -82,21 +86,13 @@ MP4::Atom::Atom(File *file)
 
   name = header.mid(4, 4);
 
+  // The children of containers are read when they are first asked for, so
+  // that reading the tag does not walk the sample tables or the fragments.
+
   for(int i = 0; i < numContainers; i++) {
     if(name == containers[i]) {
-      if(name == "meta") {
-        file->seek(4, File::Current);
-      }
-      else if(name == "stsd") {
-        file->seek(8, File::Current);
-      }
-      while(file->tell() < offset + length) {
-        MP4::Atom *child = new MP4::Atom(file);
-        children.append(child);
-        if(child->length == 0)
-          return;
-      }
-      return;
+      unread = true;
+      break;
     }
   }
 
@@ -107,13 +103,68 @@ MP4::Atom::~Atom()
 {
 }
 
+MP4::AtomList &
+MP4::Atom::children()
+{
+  if(unread)
+    readChildren();
+  return childAtoms;
+}
+
+bool
+MP4::Atom::hasUnreadChildren() const
+{
+  return unread;
+}
+
+void
+MP4::Atom::readAll()
+{
+  for(AtomList::ConstIterator it = children().begin(); it != children().end(); ++it)
+    (*it)->readAll();
+}
+
+bool
+MP4::Atom::isValid() const
+{
+  if(length == 0)
+    return false;
+
+  for(AtomList::ConstIterator it = childAtoms.begin(); it != childAtoms.end(); ++it) {
+    if(!(*it)->isValid())
+      return false;
+  }
+
+  return true;
+}
+
+void
+MP4::Atom::readChildren()
+{
+  unread = false;
+
+  file->seek(offset + headerLength);
+  if(name == "meta") {
+    file->seek(4, File::Current);
+  }
+  else if(name == "stsd") {
+    file->seek(8, File::Current);
+  }
+  while(file->tell() < offset + length) {
+    MP4::Atom *child = new MP4::Atom(file);
+    childAtoms.append(child);
+    if(child->length == 0)
+      return;
+  }
+}
+
 MP4::Atom *
 MP4::Atom::find(const char *name1, const char *name2, const char *name3, const char *name4)
 {
   if(name1 == 0) {
     return this;
   }
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::ConstIterator it = children().begin(); it != children().end(); ++it) {
     if((*it)->name == name1) {
       return (*it)->find(name2, name3, name4);
     }
@@ -125,7 +176,7 @@ MP4::AtomList
 MP4::Atom::findall(const char *name, bool recursive)
 {
   MP4::AtomList result;
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::ConstIterator it = children().begin(); it != children().end(); ++it) {
     if((*it)->name == name) {
       result.append(*it);
     }
@@ -143,7 +194,7 @@ MP4::Atom::path(MP4::AtomList &path, const char *name1, const char *name2, const
   if(name1 == 0) {
     return true;
   }
-  for(AtomList::ConstIterator it = children.begin(); it != children.end(); ++it) {
+  for(AtomList::ConstIterator it = children().begin(); it != children().end(); ++it) {
     if((*it)->name == name1) {
       return (*it)->path(path, name2, name3);
     }
@@ -74,6 +74,7 @@ namespace TagLib {
 
     typedef TagLib::List<AtomData> AtomDataList;
 
+    //! An atom whose children are only read from the file when they are used
     class Atom
     {
     public:
@@ -82,11 +83,42 @@ namespace TagLib {
       Atom *find(const char *name1, const char *name2 = 0, const char *name3 = 0, const char *name4 = 0);
       bool path(AtomList &path, const char *name1, const char *name2 = 0, const char *name3 = 0);
       AtomList findall(const char *name, bool recursive = false);
+
+      /*!
+       * Returns the child atoms, reading them from the file at the current
+       * \a offset on first use.
+       */
+      AtomList &children();
+
+      /*!
+       * Returns true if this is a container whose children have not been
+       * read yet.
+       */
+      bool hasUnreadChildren() const;
+
+      /*!
+       * Reads all the atoms below this one, so that they stay valid when the
+       * file is changed.
+       */
+      void readAll();
+
+      /*!
+       * Returns false if this atom, or one of the atoms below it that have
+       * been read so far, could not be parsed.
+       */
+      bool isValid() const;
+
       long offset;
       long length;
       TagLib::ByteVector name;
-      AtomList children;
     private:
+      void readChildren();
+
+      File *file;
+      long headerLength;
+      bool unread;
+      AtomList childAtoms;
+
       static const int numContainers = 11;
       static const char *containers[11];
     };
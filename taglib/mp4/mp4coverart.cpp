@@ -30,6 +30,25 @@
 
 using namespace TagLib;
 
+namespace
+{
+  String mimeType(MP4::CoverArt::Format format)
+  {
+    switch(format) {
+    case MP4::CoverArt::JPEG:
+      return "image/jpeg";
+    case MP4::CoverArt::PNG:
+      return "image/png";
+    case MP4::CoverArt::BMP:
+      return "image/bmp";
+    case MP4::CoverArt::GIF:
+      return "image/gif";
+    default:
+      return String();
+    }
+  }
+}
+
 class MP4::CoverArt::CoverArtPrivate : public RefCounter
 {
 public:
@@ -39,6 +58,9 @@ public:
 
   Format format;
   ByteVector data;
+
+  // Refers to the data in the file until it has been read.
+  PictureHandle handle;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +74,13 @@ MP4::CoverArt::CoverArt(Format format, const ByteVector &data) :
   d->data = data;
 }
 
+MP4::CoverArt::CoverArt(Format format, TagLib::File *file, long offset, unsigned int size) :
+  d(new CoverArtPrivate())
+{
+  d->format = format;
+  d->handle = PictureHandle(file, offset, size, mimeType(format));
+}
+
 MP4::CoverArt::CoverArt(const CoverArt &item) :
   d(item.d)
 {
@@ -89,5 +118,18 @@ MP4::CoverArt::format() const
 ByteVector
 MP4::CoverArt::data() const
 {
+  if(!d->handle.isNull()) {
+    d->data = d->handle.data();
+    d->handle = PictureHandle();
+  }
   return d->data;
 }
+
+PictureHandle
+MP4::CoverArt::handle() const
+{
+  if(!d->handle.isNull())
+    return d->handle;
+
+  return PictureHandle(d->data, mimeType(d->format));
+}
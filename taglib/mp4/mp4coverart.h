@@ -28,11 +28,14 @@
 
 #include "tlist.h"
 #include "tbytevector.h"
+#include "tpicturehandle.h"
 #include "taglib_export.h"
 #include "mp4atom.h"
 
 namespace TagLib {
 
+  class File;
+
   namespace MP4 {
 
     class TAGLIB_EXPORT CoverArt
@@ -50,6 +53,13 @@ namespace TagLib {
       };
 
       CoverArt(Format format, const ByteVector &data);
+
+      /*!
+       * Constructs cover art whose \a size bytes of image data at \a offset in
+       * \a file are only read when data() is first called.
+       */
+      CoverArt(Format format, TagLib::File *file, long offset, unsigned int size);
+
       ~CoverArt();
 
       CoverArt(const CoverArt &item);
@@ -70,6 +80,12 @@ namespace TagLib {
       //! The image data
       ByteVector data() const;
 
+      /*!
+       * Returns a handle for the image.  If the data has not been read yet,
+       * the handle refers to it in the file.
+       */
+      PictureHandle handle() const;
+
     private:
       class CoverArtPrivate;
       CoverArtPrivate *d;
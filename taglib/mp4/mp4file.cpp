@@ -34,14 +34,12 @@ using namespace TagLib;
 
 namespace
 {
+  // Only checks the atoms that have been read so far.
+
   bool checkValid(const MP4::AtomList &list)
   {
     for(MP4::AtomList::ConstIterator it = list.begin(); it != list.end(); ++it) {
-
-      if((*it)->length == 0)
-        return false;
-
-      if(!checkValid((*it)->children))
+      if(!(*it)->isValid())
         return false;
     }
 
@@ -69,20 +67,20 @@ public:
   MP4::Properties *properties;
 };
 
-MP4::File::File(FileName file, bool readProperties, AudioProperties::ReadStyle) :
+MP4::File::File(FileName file, bool readProperties, AudioProperties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle) :
+MP4::File::File(IOStream *stream, bool readProperties, AudioProperties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MP4::File::~File()
@@ -118,12 +116,20 @@ MP4::File::audioProperties() const
 }
 
 void
-MP4::File::read(bool readProperties)
+MP4::File::read(bool readProperties, AudioProperties::ReadStyle propertiesStyle)
 {
   if(!isValid())
     return;
 
   d->atoms = new Atoms(this);
+
+  // Only the top-level atoms are read up front.  The ones of the tag are read
+  // here, so that they are checked too.
+
+  MP4::Atom *ilst = d->atoms->find("moov", "udta", "meta", "ilst");
+  if(ilst)
+    ilst->children();
+
   if(!checkValid(d->atoms->atoms)) {
     setValid(false);
     return;
@@ -135,9 +141,9 @@ MP4::File::read(bool readProperties)
     return;
   }
 
-  d->tag = new Tag(this, d->atoms);
+  d->tag = new Tag(this, d->atoms, (propertiesStyle & AudioProperties::LazyTags) != 0);
   if(readProperties) {
-    d->properties = new Properties(this, d->atoms);
+    d->properties = new Properties(this, d->atoms, propertiesStyle);
   }
 }
 
@@ -154,6 +160,11 @@ MP4::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before mdat is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   return d->tag->save();
 }
 
@@ -52,7 +52,9 @@ namespace TagLib {
        * Constructs an MP4 file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, only the signature flags and the
+       * AudioProperties::LazyTags flag of \a propertiesStyle are used.  With
+       * the latter the cover art images are only read when they are needed.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle audioPropertiesStyle = Properties::Average);
@@ -64,7 +66,9 @@ namespace TagLib {
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, only the signature flags and the
+       * AudioProperties::LazyTags flag of \a propertiesStyle are used.  With
+       * the latter the cover art images are only read when they are needed.
        */
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle audioPropertiesStyle = Properties::Average);
@@ -121,7 +125,7 @@ namespace TagLib {
       bool hasMP4Tag() const;
 
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, AudioProperties::ReadStyle propertiesStyle);
 
       class FilePrivate;
       FilePrivate *d;
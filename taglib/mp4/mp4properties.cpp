@@ -51,7 +51,7 @@ public:
   int bitsPerSample;
   bool encrypted;
   Codec codec;
-  ByteVector signature;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,7 +62,7 @@ MP4::Properties::Properties(File *file, MP4::Atoms *atoms, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file, atoms);
+  read(file, atoms, style);
 }
 
 MP4::Properties::~Properties()
@@ -127,7 +127,7 @@ MP4::Properties::codec() const
 ByteVector
 MP4::Properties::signature() const
 {
-  return d->signature;
+  return d->signature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,7 +135,7 @@ MP4::Properties::signature() const
 ////////////////////////////////////////////////////////////////////////////////
 
 void
-MP4::Properties::read(File *file, Atoms *atoms)
+MP4::Properties::read(File *file, Atoms *atoms, ReadStyle style)
 {
   MP4::Atom *moov = atoms->find("moov");
   if(!moov) {
@@ -147,7 +147,7 @@ MP4::Properties::read(File *file, Atoms *atoms)
   if(!mdat) {
     debug("MP4: Atom 'mdat' not found");
   } else {
-    d->signature = taglib_make_signature(file, mdat->offset, mdat->length);
+    d->signature.setRegion(file, mdat->offset, mdat->length, style);
   }
 
   MP4::Atom *trak = 0;
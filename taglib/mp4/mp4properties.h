@@ -112,7 +112,7 @@ namespace TagLib {
       Codec codec() const;
 
     private:
-      void read(File *file, Atoms *atoms);
+      void read(File *file, Atoms *atoms, ReadStyle style);
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <climits>
+
 #include <tdebug.h>
 #include <tstring.h>
 #include <tpropertymap.h>
@@ -32,16 +34,144 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // Chunk offset tables can hold hundreds of thousands of entries, so they
+  // are patched in memory and written back as a single block.  data starts
+  // with the entry count.  The entries are decoded by hand to keep the loops
+  // simple enough for the compiler to vectorize.  Returns false if no entry
+  // was changed.
+
+  unsigned int entryCount(const ByteVector &data, unsigned int entrySize)
+  {
+    if(data.size() < 4)
+      return 0;
+
+    const unsigned int count = data.toUInt();
+    const unsigned int available = (data.size() - 4) / entrySize;
+    if(count > available) {
+      debug("MP4: Chunk offset table is truncated.");
+      return available;
+    }
+    return count;
+  }
+
+  bool shiftOffsets32(ByteVector &data, long delta, long offset)
+  {
+    const unsigned int count = entryCount(data, 4);
+    unsigned char *p = reinterpret_cast<unsigned char *>(data.data()) + 4;
+    const unsigned int threshold = static_cast<unsigned int>(offset);
+    const unsigned int shift = static_cast<unsigned int>(delta);
+
+    bool changed = false;
+    for(unsigned int i = 0; i < count; ++i, p += 4) {
+      unsigned int o = (static_cast<unsigned int>(p[0]) << 24) |
+                       (static_cast<unsigned int>(p[1]) << 16) |
+                       (static_cast<unsigned int>(p[2]) << 8)  |
+                       (static_cast<unsigned int>(p[3]));
+      if(o > threshold) {
+        o += shift;
+        p[0] = static_cast<unsigned char>(o >> 24);
+        p[1] = static_cast<unsigned char>(o >> 16);
+        p[2] = static_cast<unsigned char>(o >> 8);
+        p[3] = static_cast<unsigned char>(o);
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  bool shiftOffsets64(ByteVector &data, long delta, long offset)
+  {
+    const unsigned int count = entryCount(data, 8);
+    unsigned char *p = reinterpret_cast<unsigned char *>(data.data()) + 4;
+    const long long threshold = offset;
+
+    bool changed = false;
+    for(unsigned int i = 0; i < count; ++i, p += 8) {
+      unsigned long long o = 0;
+      for(int j = 0; j < 8; ++j)
+        o = (o << 8) | p[j];
+      if(static_cast<long long>(o) > threshold) {
+        o += static_cast<unsigned long long>(static_cast<long long>(delta));
+        for(int j = 7; j >= 0; --j) {
+          p[j] = static_cast<unsigned char>(o);
+          o >>= 8;
+        }
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  // A 'free' or 'skip' atom and the containers it is in, outermost first.
+
+  struct FreeAtom
+  {
+    MP4::Atom *atom;
+    MP4::AtomList parents;
+  };
+
+  bool isFree(const MP4::Atom *atom)
+  {
+    return atom->name == "free" || atom->name == "skip";
+  }
+
+  void findFreeAtoms(const MP4::AtomList &atoms, MP4::AtomList &parents,
+                     List<FreeAtom> &freeAtoms)
+  {
+    for(MP4::AtomList::ConstIterator it = atoms.begin(); it != atoms.end(); ++it) {
+      if(isFree(*it)) {
+        const FreeAtom freeAtom = { *it, parents };
+        freeAtoms.append(freeAtom);
+      }
+      else if(!(*it)->children().isEmpty()) {
+        parents.append(*it);
+        findFreeAtoms((*it)->children(), parents, freeAtoms);
+        parents.erase(--parents.end());
+      }
+    }
+  }
+
+  // Moves the atoms that start in [begin, end) by delta bytes.  Children that
+  // have not been read yet are found from the new offset of their parent.
+
+  void moveAtoms(const MP4::AtomList &atoms, long begin, long end, long delta)
+  {
+    for(MP4::AtomList::ConstIterator it = atoms.begin(); it != atoms.end(); ++it) {
+      if((*it)->offset >= begin && (*it)->offset < end)
+        (*it)->offset += delta;
+      if(!(*it)->hasUnreadChildren())
+        moveAtoms((*it)->children(), begin, end, delta);
+    }
+  }
+
+  void removeAtom(MP4::AtomList &atoms, MP4::Atom *atom)
+  {
+    MP4::AtomList::Iterator it = atoms.find(atom);
+    if(it != atoms.end()) {
+      atoms.erase(it);
+      delete atom;
+    }
+  }
+}
+
 class MP4::Tag::TagPrivate
 {
 public:
   TagPrivate() :
     file(0),
-    atoms(0) {}
+    atoms(0),
+    lazyCoverArt(false),
+    paddingSize(-1),
+    savedInPlace(false) {}
 
   TagLib::File *file;
   Atoms *atoms;
   ItemMap items;
+  bool lazyCoverArt;
+  int paddingSize;
+  bool savedInPlace;
 };
 
 MP4::Tag::Tag() :
@@ -55,13 +185,31 @@ MP4::Tag::Tag(TagLib::File *file, MP4::Atoms *atoms) :
   d->file = file;
   d->atoms = atoms;
 
-  MP4::Atom *ilst = atoms->find("moov", "udta", "meta", "ilst");
+  read();
+}
+
+MP4::Tag::Tag(TagLib::File *file, MP4::Atoms *atoms, bool lazyCoverArt) :
+  d(new TagPrivate())
+{
+  d->file = file;
+  d->atoms = atoms;
+  d->lazyCoverArt = lazyCoverArt;
+
+  read();
+}
+
+void
+MP4::Tag::read()
+{
+  TagLib::File *file = d->file;
+
+  MP4::Atom *ilst = d->atoms->find("moov", "udta", "meta", "ilst");
   if(!ilst) {
     //debug("Atom moov.udta.meta.ilst not found.");
     return;
   }
 
-  for(AtomList::ConstIterator it = ilst->children.begin(); it != ilst->children.end(); ++it) {
+  for(AtomList::ConstIterator it = ilst->children().begin(); it != ilst->children().end(); ++it) {
     MP4::Atom *atom = *it;
     file->seek(atom->offset + 8);
     if(atom->name == "----") {
@@ -284,6 +432,43 @@ void
 MP4::Tag::parseCovr(const MP4::Atom *atom)
 {
   MP4::CoverArtList value;
+
+  if(d->lazyCoverArt) {
+
+    // Only read the header of each data atom and leave the image in the file.
+
+    long pos = atom->offset + 8;
+    const long end = atom->offset + atom->length;
+    while(pos + 16 <= end) {
+      d->file->seek(pos);
+      const ByteVector header = d->file->readBlock(16);
+      const long length = static_cast<long>(header.toUInt(0U));
+      if(length < 16 || pos + length > end) {
+        debug("MP4: Too short atom");
+        break;
+      }
+
+      const ByteVector name = header.mid(4, 4);
+      const int flags = static_cast<int>(header.toUInt(8U));
+      if(name != "data") {
+        debug("MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
+        break;
+      }
+      if(flags == TypeJPEG || flags == TypePNG || flags == TypeBMP ||
+         flags == TypeGIF || flags == TypeImplicit) {
+        value.append(MP4::CoverArt(MP4::CoverArt::Format(flags), d->file,
+                                   pos + 16, static_cast<unsigned int>(length - 16)));
+      }
+      else {
+        debug("MP4: Unknown covr format " + String::number(flags));
+      }
+      pos += length;
+    }
+    if(!value.isEmpty())
+      addItem(atom->name, value);
+    return;
+  }
+
   ByteVector data = d->file->readBlock(atom->length - 8);
   unsigned int pos = 0;
   while(pos < data.size()) {
@@ -460,6 +645,8 @@ MP4::Tag::renderFreeForm(const String &name, const MP4::Item &item) const
 bool
 MP4::Tag::save()
 {
+  d->savedInPlace = false;
+
   ByteVector data;
   for(MP4::ItemMap::ConstIterator it = d->items.begin(); it != d->items.end(); ++it) {
     const String name = it->first;
@@ -501,6 +688,24 @@ MP4::Tag::save()
   }
   data = renderAtom("ilst", data);
 
+  // Atoms that have not been read yet cannot be found after the file has
+  // been changed, so the ones whose offsets get updated are read now.
+
+  MP4::Atom *moov = d->atoms->find("moov");
+  if(moov)
+    moov->readAll();
+  MP4::Atom *moof = d->atoms->find("moof");
+  if(moof)
+    moof->readAll();
+
+  // Only the atoms that were used were checked when the file was opened.  A
+  // broken one further down would make the offset updates write garbage.
+
+  if((moov && !moov->isValid()) || (moof && !moof->isValid())) {
+    debug("MP4::Tag::save() -- Invalid atom found; the file is left unchanged.");
+    return false;
+  }
+
   AtomList path = d->atoms->path("moov", "udta", "meta", "ilst");
   if(path.size() == 4) {
     saveExisting(data, path);
@@ -553,16 +758,9 @@ MP4::Tag::updateOffsets(long delta, long offset)
       }
       d->file->seek(atom->offset + 12);
       ByteVector data = d->file->readBlock(atom->length - 12);
-      unsigned int count = data.toUInt();
-      d->file->seek(atom->offset + 16);
-      unsigned int pos = 4;
-      while(count--) {
-        long o = static_cast<long>(data.toUInt(pos));
-        if(o > offset) {
-          o += delta;
-        }
-        d->file->writeBlock(ByteVector::fromUInt(o));
-        pos += 4;
+      if(shiftOffsets32(data, delta, offset)) {
+        d->file->seek(atom->offset + 12);
+        d->file->writeBlock(data);
       }
     }
 
@@ -574,16 +772,9 @@ MP4::Tag::updateOffsets(long delta, long offset)
       }
       d->file->seek(atom->offset + 12);
       ByteVector data = d->file->readBlock(atom->length - 12);
-      unsigned int count = data.toUInt();
-      d->file->seek(atom->offset + 16);
-      unsigned int pos = 4;
-      while(count--) {
-        long long o = data.toLongLong(pos);
-        if(o > offset) {
-          o += delta;
-        }
-        d->file->writeBlock(ByteVector::fromLongLong(o));
-        pos += 8;
+      if(shiftOffsets64(data, delta, offset)) {
+        d->file->seek(atom->offset + 12);
+        d->file->writeBlock(data);
       }
     }
   }
@@ -617,7 +808,7 @@ MP4::Tag::saveNew(ByteVector data)
   data = renderAtom("meta", ByteVector(4, '\0') +
                     renderAtom("hdlr", ByteVector(8, '\0') + ByteVector("mdirappl") +
                                ByteVector(9, '\0')) +
-                    data + padIlst(data));
+                    data + padIlst(data, d->paddingSize));
 
   AtomList path = d->atoms->path("moov", "udta");
   if(path.size() != 2) {
@@ -634,7 +825,7 @@ MP4::Tag::saveNew(ByteVector data)
   // Insert the newly created atoms into the tree to keep it up-to-date.
 
   d->file->seek(offset);
-  path.back()->children.prepend(new Atom(d->file));
+  path.back()->children().prepend(new Atom(d->file));
 }
 
 void
@@ -647,10 +838,10 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
   long length = ilst->length;
 
   MP4::Atom *meta = *(--it);
-  AtomList::ConstIterator index = meta->children.find(ilst);
+  AtomList::ConstIterator index = meta->children().find(ilst);
 
   // check if there is an atom before 'ilst', and possibly use it as padding
-  if(index != meta->children.begin()) {
+  if(index != meta->children().begin()) {
     AtomList::ConstIterator prevIndex = index;
     prevIndex--;
     MP4::Atom *prev = *prevIndex;
@@ -662,7 +853,7 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
   // check if there is an atom after 'ilst', and possibly use it as padding
   AtomList::ConstIterator nextIndex = index;
   nextIndex++;
-  if(nextIndex != meta->children.end()) {
+  if(nextIndex != meta->children().end()) {
     MP4::Atom *next = *nextIndex;
     if(next->name == "free") {
       length += next->length;
@@ -671,7 +862,10 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
 
   long delta = data.size() - length;
   if(delta > 0 || (delta < 0 && delta > -8)) {
-    data.append(padIlst(data));
+    if(saveToFreeAtom(data, path, offset, length))
+      return;
+
+    data.append(padIlst(data, d->paddingSize));
     delta = data.size() - length;
   }
   else if(delta < 0) {
@@ -685,6 +879,163 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
     updateParents(path, delta, 1);
     updateOffsets(delta, offset);
   }
+  else {
+    d->savedInPlace = true;
+  }
+}
+
+bool
+MP4::Tag::saveToFreeAtom(ByteVector data, const AtomList &path, long offset, long length)
+{
+  // Look for a 'free' or 'skip' atom that can take up the growth of the tag
+  // without moving anything outside 'moov', so either inside 'moov' or right
+  // next to it.  The atoms between it and 'ilst' are moved instead of the
+  // rest of the file.
+
+  MP4::Atom *moov = path.front();
+  MP4::Atom *ilst = path.back();
+
+  List<FreeAtom> freeAtoms;
+  AtomList parents;
+  parents.append(moov);
+  findFreeAtoms(moov->children(), parents, freeAtoms);
+
+  AtomList::Iterator moovIt = d->atoms->atoms.find(moov);
+  if(moovIt != d->atoms->atoms.begin()) {
+    AtomList::Iterator prev = moovIt;
+    --prev;
+    if(isFree(*prev)) {
+      const FreeAtom freeAtom = { *prev, AtomList() };
+      freeAtoms.append(freeAtom);
+    }
+  }
+  AtomList::Iterator next = moovIt;
+  if(++next != d->atoms->atoms.end() && isFree(*next)) {
+    const FreeAtom freeAtom = { *next, AtomList() };
+    freeAtoms.append(freeAtom);
+  }
+
+  // The whole free atom goes to the padding after 'ilst', so what is left
+  // has to be empty or large enough for an atom header.  Among the atoms
+  // that fit, the nearest one needs the fewest bytes moved.
+
+  const FreeAtom *best = 0;
+  long bestDistance = 0;
+  for(List<FreeAtom>::ConstIterator it = freeAtoms.begin(); it != freeAtoms.end(); ++it) {
+    const MP4::Atom *atom = it->atom;
+    if(atom->offset >= offset && atom->offset < offset + length)
+      continue;
+
+    const long padding = length + atom->length - static_cast<long>(data.size());
+    if(padding < 0 || (padding > 0 && padding < 8))
+      continue;
+
+    const long distance = atom->offset > offset
+      ? atom->offset - (offset + length)
+      : offset - (atom->offset + atom->length);
+    if(!best || distance < bestDistance) {
+      best = &(*it);
+      bestDistance = distance;
+    }
+  }
+
+  if(!best)
+    return false;
+
+  MP4::Atom *freeAtom = best->atom;
+  const long freeLength = freeAtom->length;
+  const long padding = length + freeLength - static_cast<long>(data.size());
+  if(padding > 0)
+    data.append(padIlst(data, padding - 8));
+
+  if(freeAtom->offset > offset) {
+    const long begin = offset + length;
+    d->file->seek(begin);
+    const ByteVector between = d->file->readBlock(freeAtom->offset - begin);
+    d->file->seek(offset);
+    d->file->writeBlock(data + between);
+
+    moveAtoms(d->atoms->atoms, begin, freeAtom->offset, freeLength);
+  }
+  else {
+    const long begin = freeAtom->offset + freeLength;
+    d->file->seek(begin);
+    const ByteVector between = d->file->readBlock(offset - begin);
+    d->file->seek(freeAtom->offset);
+    d->file->writeBlock(between + data);
+
+    moveAtoms(d->atoms->atoms, begin, offset, -freeLength);
+    offset -= freeLength;
+  }
+
+  // Only the containers that hold just one of the two atoms change in size.
+
+  AtomList ilstParents = path;
+  ilstParents.erase(--ilstParents.end());
+  AtomList freeParents = best->parents;
+
+  for(AtomList::ConstIterator it = ilstParents.begin(); it != ilstParents.end(); ++it) {
+    if(!freeParents.contains(*it)) {
+      AtomList parent;
+      parent.append(*it);
+      updateParents(parent, freeLength);
+      (*it)->length += freeLength;
+    }
+  }
+  for(AtomList::ConstIterator it = freeParents.begin(); it != freeParents.end(); ++it) {
+    if(!ilstParents.contains(*it)) {
+      AtomList parent;
+      parent.append(*it);
+      updateParents(parent, -freeLength);
+      (*it)->length -= freeLength;
+    }
+  }
+
+  // Bring the atom tree up to date: the free atoms that were used are gone,
+  // and 'ilst' is followed by the new padding.
+
+  MP4::Atom *meta = ilstParents.back();
+  for(AtomList::Iterator it = meta->children().begin(); it != meta->children().end();) {
+    if(*it != ilst && isFree(*it) &&
+       (*it)->offset >= offset && (*it)->offset < offset + static_cast<long>(data.size())) {
+      delete *it;
+      it = meta->children().erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  removeAtom(freeParents.isEmpty() ? d->atoms->atoms : freeParents.back()->children(), freeAtom);
+
+  ilst->offset = offset;
+  ilst->length = data.size() - (padding > 0 ? padding : 0);
+
+  if(padding > 0) {
+    d->file->seek(ilst->offset + ilst->length);
+    AtomList::Iterator ilstIt = meta->children().find(ilst);
+    meta->children().insert(++ilstIt, new Atom(d->file));
+  }
+
+  d->savedInPlace = true;
+  return true;
+}
+
+void
+MP4::Tag::setPaddingSize(unsigned int size)
+{
+  d->paddingSize = size > static_cast<unsigned int>(INT_MAX) ? INT_MAX : static_cast<int>(size);
+}
+
+unsigned int
+MP4::Tag::paddingSize() const
+{
+  return d->paddingSize < 0 ? 0 : static_cast<unsigned int>(d->paddingSize);
+}
+
+bool
+MP4::Tag::savedInPlace() const
+{
+  return d->savedInPlace;
 }
 
 String
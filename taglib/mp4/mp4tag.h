@@ -50,6 +50,13 @@ namespace TagLib {
     public:
         Tag();
         Tag(TagLib::File *file, Atoms *atoms);
+
+        /*!
+         * Reads the tag from \a file.  If \a lazyCoverArt is true the cover
+         * art images are only read from the file when their data is needed.
+         */
+        // BIC: merge with the above constructor
+        Tag(TagLib::File *file, Atoms *atoms, bool lazyCoverArt);
         virtual ~Tag();
         bool save();
 
@@ -106,7 +113,34 @@ namespace TagLib {
         void removeUnsupportedProperties(const StringList& properties);
         PropertyMap setProperties(const PropertyMap &properties);
 
+        /*!
+         * Sets the number of padding bytes in the 'free' atom that is written
+         * after the tag when it is created or has to grow, so that later saves
+         * can be done in place.  The atom takes another 8 bytes for its header.
+         * Sizes above INT_MAX are clamped to INT_MAX.  By default the tag and
+         * its padding are rounded up to a multiple of 1024 bytes.
+         *
+         * \see savedInPlace()
+         */
+        void setPaddingSize(unsigned int size);
+
+        /*!
+         * Returns the padding size set with setPaddingSize(), after clamping,
+         * or 0 if the default is used.
+         */
+        unsigned int paddingSize() const;
+
+        /*!
+         * Returns true if the last call to save() did not have to move any data
+         * outside of 'moov'.  This is the case when the tag fits into its old
+         * space and padding, or into a 'free' or 'skip' atom inside 'moov' or
+         * next to it.  Otherwise the rest of the file, usually including 'mdat',
+         * had to be moved.
+         */
+        bool savedInPlace() const;
+
     private:
+        void read();
         AtomDataList parseData2(const Atom *atom, int expectedFlags = -1,
                                 bool freeForm = false);
         ByteVectorList parseData(const Atom *atom, int expectedFlags = -1,
@@ -143,6 +177,7 @@ namespace TagLib {
 
         void saveNew(ByteVector data);
         void saveExisting(ByteVector data, const AtomList &path);
+        bool saveToFreeAtom(ByteVector data, const AtomList &path, long offset, long length);
 
         void addItem(const String &name, const Item &value);
 
@@ -79,20 +79,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPC::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPC::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-MPC::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+MPC::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPC::File::~File()
@@ -135,6 +135,11 @@ bool MPC::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before the audio data is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   // Possibly strip ID3v2 tag
 
   if(!d->ID3v2Header && d->ID3v2Location >= 0) {
@@ -261,7 +266,7 @@ bool MPC::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPC::File::read(bool readProperties)
+void MPC::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -314,6 +319,6 @@ void MPC::File::read(bool readProperties)
       seek(0);
     }
 
-    d->properties = new Properties(this, streamLength);
+    d->properties = new Properties(this, streamLength, propertiesStyle);
   }
 }
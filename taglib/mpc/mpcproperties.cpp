@@ -30,6 +30,7 @@
 
 #include "mpcproperties.h"
 #include "mpcfile.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 
@@ -61,6 +62,7 @@ public:
   unsigned int albumGain;
   unsigned int albumPeak;
   String       flags;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +80,8 @@ MPC::Properties::Properties(File *file, long streamLength, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
+  const long streamOffset = file->tell();
+
   ByteVector magic = file->readBlock(4);
   if(magic == "MPCK") {
     // Musepack version 8
@@ -87,6 +91,8 @@ MPC::Properties::Properties(File *file, long streamLength, ReadStyle style) :
     // Musepack version 7 or older, fixed size header
     readSV7(magic + file->readBlock(MPC::HeaderSize - 4), streamLength);
   }
+
+  d->signature.setRegion(file, streamOffset, streamLength, style);
 }
 
 MPC::Properties::~Properties()
@@ -159,6 +165,11 @@ int MPC::Properties::albumPeak() const
   return d->albumPeak;
 }
 
+ByteVector MPC::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -27,10 +27,49 @@
 
 #include <tstringlist.h>
 #include <tdebug.h>
+#include <id3v2tag.h>
 
 using namespace TagLib;
 using namespace ID3v2;
 
+namespace
+{
+  // Converts the fixed image format of an ID3v2.2 PIC frame to a MIME type.
+
+  String mimeTypeFromImageFormat(const ByteVector &format)
+  {
+    const String fixedString = String(format, String::Latin1);
+    if(fixedString.upper() == "JPG")
+      return "image/jpeg";
+    if(fixedString.upper() == "PNG")
+      return "image/png";
+
+    debug("probably unsupported image type");
+    return "image/" + fixedString;
+  }
+
+  // Like Frame::readStringField(), but returns false and leaves \a position
+  // alone if the delimiter of the string is missing.
+
+  bool readDelimitedString(const ByteVector &data, String::Type encoding, int &position,
+                           String &value)
+  {
+    const ByteVector delimiter = Frame::textDelimiter(encoding);
+    const int end = data.find(delimiter, position, delimiter.size());
+    if(end < position)
+      return false;
+
+    const ByteVector text = data.mid(position, end - position);
+    if(encoding == String::Latin1)
+      value = ID3v2::Tag::latin1StringHandler()->parse(text);
+    else
+      value = String(text, encoding);
+
+    position = end + delimiter.size();
+    return true;
+  }
+}
+
 class AttachedPictureFrame::AttachedPictureFramePrivate
 {
 public:
@@ -178,6 +217,28 @@ AttachedPictureFrame::AttachedPictureFrame(const ByteVector &data, Header *h) :
   parseFields(fieldData(data));
 }
 
+int AttachedPictureFrame::parsePictureFields(const ByteVector &data, String &mimeType,
+                                             int &type, String &description) // static
+{
+  if(data.size() < 5)
+    return -1;
+
+  const String::Type encoding = String::Type(data[0]);
+
+  int pos = 1;
+
+  if(!readDelimitedString(data, String::Latin1, pos, mimeType) ||
+     static_cast<unsigned int>(pos) + 1 >= data.size())
+    return -1;
+
+  type = static_cast<unsigned char>(data[pos++]);
+
+  if(!readDelimitedString(data, encoding, pos, description))
+    return -1;
+
+  return pos;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // support for ID3v2.2 PIC frames
 ////////////////////////////////////////////////////////////////////////////////
@@ -193,17 +254,9 @@ void AttachedPictureFrameV22::parseFields(const ByteVector &data)
 
   int pos = 1;
 
-  String fixedString = String(data.mid(pos, 3), String::Latin1);
-  pos += 3;
   // convert fixed string image type to mime string
-  if (fixedString.upper() == "JPG") {
-    d->mimeType = "image/jpeg";
-  } else if (fixedString.upper() == "PNG") {
-    d->mimeType = "image/png";
-  } else {
-    debug("probably unsupported image type");
-    d->mimeType = "image/" + fixedString;
-  }
+  d->mimeType = mimeTypeFromImageFormat(data.mid(pos, 3));
+  pos += 3;
 
   d->type = (TagLib::ID3v2::AttachedPictureFrame::Type)data[pos++];
   d->description = readStringField(data, d->textEncoding, &pos);
@@ -223,3 +276,24 @@ AttachedPictureFrameV22::AttachedPictureFrameV22(const ByteVector &data, Header
   newHeader->setFrameSize(h->frameSize());
   setHeader(newHeader, true);
 }
+
+int AttachedPictureFrameV22::parsePictureFields(const ByteVector &data, String &mimeType,
+                                                int &type, String &description) // static
+{
+  if(data.size() < 5)
+    return -1;
+
+  const String::Type encoding = String::Type(data[0]);
+
+  int pos = 1;
+
+  mimeType = mimeTypeFromImageFormat(data.mid(pos, 3));
+  pos += 3;
+
+  type = static_cast<unsigned char>(data[pos++]);
+
+  if(!readDelimitedString(data, encoding, pos, description))
+    return -1;
+
+  return pos;
+}
@@ -46,6 +46,7 @@ namespace TagLib {
     class TAGLIB_EXPORT AttachedPictureFrame : public Frame
     {
       friend class FrameFactory;
+      friend class Tag;
 
     public:
 
@@ -213,6 +214,15 @@ namespace TagLib {
       AttachedPictureFrame &operator=(const AttachedPictureFrame &);
       AttachedPictureFrame(const ByteVector &data, Header *h);
 
+      /*!
+       * Parses the fields in front of the image data of an APIC frame from
+       * \a data, which may end anywhere after them.  Returns the position of
+       * the image data in \a data, or -1 if the fields do not end within
+       * \a data.
+       */
+      static int parsePictureFields(const ByteVector &data, String &mimeType,
+                                    int &type, String &description);
+
     };
 
     //! support for ID3v2.2 PIC frames
@@ -222,7 +232,15 @@ namespace TagLib {
       virtual void parseFields(const ByteVector &data);
     private:
       AttachedPictureFrameV22(const ByteVector &data, Header *h);
+
+      /*!
+       * Like AttachedPictureFrame::parsePictureFields(), for a PIC frame.
+       */
+      static int parsePictureFields(const ByteVector &data, String &mimeType,
+                                    int &type, String &description);
+
       friend class FrameFactory;
+      friend class Tag;
     };
   }
 }
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <cstring>
+
 #include <tdebug.h>
 #include <tzlib.h>
 
@@ -85,16 +87,167 @@ namespace
   }
 }
 
+namespace
+{
+  // Frame IDs are compared as integers holding the characters of the ID, the
+  // first one in the most significant byte.  The three character IDs of
+  // ID3v2.2 leave the least significant byte zero.
+
+#define FRAME_KEY(a, b, c, d) \
+  ((static_cast<unsigned int>(a) << 24) | (static_cast<unsigned int>(b) << 16) | \
+   (static_cast<unsigned int>(c) << 8)  |  static_cast<unsigned int>(d))
+
+  unsigned int frameKey(const char *id, size_t length)
+  {
+    unsigned int key = 0;
+    for(size_t i = 0; i < 4; ++i)
+      key = (key << 8) | (i < length ? static_cast<unsigned char>(id[i]) : 0);
+    return key;
+  }
+
+  unsigned int frameKey(const ByteVector &id)
+  {
+    return frameKey(id.data(), id.size());
+  }
+
+  unsigned int frameKey(const char *id)
+  {
+    return frameKey(id, ::strlen(id));
+  }
+
+  // Frame conversion table ID3v2.2 -> 2.4, sorted by the ID3v2.2 ID
+  const char *frameConversion2[][2] = {
+    { "BUF", "RBUF" },
+    { "CNT", "PCNT" },
+    { "COM", "COMM" },
+    { "CRA", "AENC" },
+    { "ETC", "ETCO" },
+    { "GEO", "GEOB" },
+    { "IPL", "TIPL" },
+    { "MCI", "MCDI" },
+    { "MLL", "MLLT" },
+    { "MVI", "MVIN" }, // Apple iTunes nonstandard
+    { "MVN", "MVNM" }, // Apple iTunes nonstandard
+    { "PCS", "PCST" }, // Apple iTunes nonstandard
+    { "POP", "POPM" },
+    { "REV", "RVRB" },
+    { "SLT", "SYLT" },
+    { "STC", "SYTC" },
+    { "TAL", "TALB" },
+    { "TBP", "TBPM" },
+    { "TCM", "TCOM" },
+    { "TCO", "TCON" },
+    { "TCP", "TCMP" },
+    { "TCR", "TCOP" },
+    { "TCT", "TCAT" }, // Apple iTunes nonstandard
+    { "TDR", "TDRL" }, // Apple iTunes nonstandard
+    { "TDS", "TDES" }, // Apple iTunes nonstandard
+    { "TDY", "TDLY" },
+    { "TEN", "TENC" },
+    { "TFT", "TFLT" },
+    { "TID", "TGID" }, // Apple iTunes nonstandard
+    { "TKE", "TKEY" },
+    { "TLA", "TLAN" },
+    { "TLE", "TLEN" },
+    { "TMT", "TMED" },
+    { "TOA", "TOAL" },
+    { "TOF", "TOFN" },
+    { "TOL", "TOLY" },
+    { "TOR", "TDOR" },
+    { "TOT", "TOAL" },
+    { "TP1", "TPE1" },
+    { "TP2", "TPE2" },
+    { "TP3", "TPE3" },
+    { "TP4", "TPE4" },
+    { "TPA", "TPOS" },
+    { "TPB", "TPUB" },
+    { "TRC", "TSRC" },
+    { "TRD", "TDRC" },
+    { "TRK", "TRCK" },
+    { "TS2", "TSO2" },
+    { "TSA", "TSOA" },
+    { "TSC", "TSOC" },
+    { "TSP", "TSOP" },
+    { "TSS", "TSSE" },
+    { "TST", "TSOT" },
+    { "TT1", "TIT1" },
+    { "TT2", "TIT2" },
+    { "TT3", "TIT3" },
+    { "TXT", "TOLY" },
+    { "TXX", "TXXX" },
+    { "TYE", "TDRC" },
+    { "UFI", "UFID" },
+    { "ULT", "USLT" },
+    { "WAF", "WOAF" },
+    { "WAR", "WOAR" },
+    { "WAS", "WOAS" },
+    { "WCM", "WCOM" },
+    { "WCP", "WCOP" },
+    { "WFD", "WFED" }, // Apple iTunes nonstandard
+    { "WPB", "WPUB" },
+    { "WXX", "WXXX" },
+  };
+  const size_t frameConversion2Size = sizeof(frameConversion2) / sizeof(frameConversion2[0]);
+
+  // Frame conversion table ID3v2.3 -> 2.4, sorted by the ID3v2.3 ID
+  const char *frameConversion3[][2] = {
+    { "IPLS", "TIPL" },
+    { "TORY", "TDOR" },
+    { "TYER", "TDRC" },
+  };
+  const size_t frameConversion3Size = sizeof(frameConversion3) / sizeof(frameConversion3[0]);
+
+  // Returns the ID3v2.4 ID for the frame \a key of \a version, or null if
+  // the ID is not converted.
+
+  const char *convertedFrameID(unsigned int key, unsigned int version)
+  {
+    const char *(*table)[2];
+    size_t size;
+
+    if(version == 2) {
+      table = frameConversion2;
+      size  = frameConversion2Size;
+    }
+    else if(version == 3) {
+      table = frameConversion3;
+      size  = frameConversion3Size;
+    }
+    else {
+      return 0;
+    }
+
+    size_t low  = 0;
+    size_t high = size;
+    while(low < high) {
+      const size_t middle = low + (high - low) / 2;
+      const unsigned int middleKey = frameKey(table[middle][0]);
+      if(middleKey == key)
+        return table[middle][1];
+      else if(middleKey < key)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    return 0;
+  }
+}
+
 class FrameFactory::FrameFactoryPrivate
 {
 public:
   FrameFactoryPrivate() :
     defaultEncoding(String::Latin1),
-    useDefaultEncoding(false) {}
+    useDefaultEncoding(false),
+    frameFilterMode(FrameFactory::SkipListedFrames) {}
 
   String::Type defaultEncoding;
   bool useDefaultEncoding;
 
+  ByteVectorList frameFilter;
+  FrameFactory::FrameFilterMode frameFilterMode;
+
   template <class T> void setTextEncoding(T *frame)
   {
     if(useDefaultEncoding)
@@ -189,33 +342,46 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // updateFrame() might have updated the frame ID.
 
-  frameID = header->frameID();
+  const unsigned int key = frameKey(header->frameID());
 
-  // This is where things get necissarily nasty.  Here we determine which
-  // Frame subclass (or if none is found simply an Frame) based
-  // on the frame ID.  Since there are a lot of possibilities, that means
-  // a lot of if blocks.
+  // Here we determine which Frame subclass (or if none is found simply an
+  // UnknownFrame) based on the frame ID.  The IDs are switched on as
+  // integers since this is done for every frame of every tag.
 
-  // Text Identification (frames 4.2)
+  switch(key) {
 
-  // Apple proprietary WFED (Podcast URL), MVNM (Movement Name), MVIN (Movement Number) are in fact text frames.
-  if(frameID.startsWith("T") || frameID == "WFED" || frameID == "MVNM" || frameID == "MVIN") {
+  // Text Identification (frames 4.2)
 
-    TextIdentificationFrame *f = frameID != "TXXX"
-      ? new TextIdentificationFrame(data, header)
-      : new UserTextIdentificationFrame(data, header);
+  case FRAME_KEY('T', 'X', 'X', 'X'):
+  {
+    UserTextIdentificationFrame *f = new UserTextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
+  }
 
+  case FRAME_KEY('T', 'C', 'O', 'N'):
+  {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
     d->setTextEncoding(f);
+    updateGenre(f);
+    return f;
+  }
 
-    if(frameID == "TCON")
-      updateGenre(f);
+  // Apple proprietary WFED (Podcast URL), MVNM (Movement Name), MVIN (Movement Number) are in fact text frames.
 
+  case FRAME_KEY('W', 'F', 'E', 'D'):
+  case FRAME_KEY('M', 'V', 'N', 'M'):
+  case FRAME_KEY('M', 'V', 'I', 'N'):
+  {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
     return f;
   }
 
   // Comments (frames 4.10)
 
-  if(frameID == "COMM") {
+  case FRAME_KEY('C', 'O', 'M', 'M'):
+  {
     CommentsFrame *f = new CommentsFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -223,7 +389,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Attached Picture (frames 4.14)
 
-  if(frameID == "APIC") {
+  case FRAME_KEY('A', 'P', 'I', 'C'):
+  {
     AttachedPictureFrame *f = new AttachedPictureFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -231,7 +398,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // ID3v2.2 Attached Picture
 
-  if(frameID == "PIC") {
+  case FRAME_KEY('P', 'I', 'C', 0):
+  {
     AttachedPictureFrame *f = new AttachedPictureFrameV22(data, header);
     d->setTextEncoding(f);
     return f;
@@ -239,38 +407,36 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Relative Volume Adjustment (frames 4.11)
 
-  if(frameID == "RVA2")
+  case FRAME_KEY('R', 'V', 'A', '2'):
     return new RelativeVolumeFrame(data, header);
 
   // Unique File Identifier (frames 4.1)
 
-  if(frameID == "UFID")
+  case FRAME_KEY('U', 'F', 'I', 'D'):
     return new UniqueFileIdentifierFrame(data, header);
 
   // General Encapsulated Object (frames 4.15)
 
-  if(frameID == "GEOB") {
+  case FRAME_KEY('G', 'E', 'O', 'B'):
+  {
     GeneralEncapsulatedObjectFrame *f = new GeneralEncapsulatedObjectFrame(data, header);
     d->setTextEncoding(f);
     return f;
   }
 
-  // URL link (frames 4.3)
+  // User defined URL link (frames 4.3.2)
 
-  if(frameID.startsWith("W")) {
-    if(frameID != "WXXX") {
-      return new UrlLinkFrame(data, header);
-    }
-    else {
-      UserUrlLinkFrame *f = new UserUrlLinkFrame(data, header);
-      d->setTextEncoding(f);
-      return f;
-    }
+  case FRAME_KEY('W', 'X', 'X', 'X'):
+  {
+    UserUrlLinkFrame *f = new UserUrlLinkFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
   }
 
   // Unsynchronized lyric/text transcription (frames 4.8)
 
-  if(frameID == "USLT") {
+  case FRAME_KEY('U', 'S', 'L', 'T'):
+  {
     UnsynchronizedLyricsFrame *f = new UnsynchronizedLyricsFrame(data, header);
     if(d->useDefaultEncoding)
       f->setTextEncoding(d->defaultEncoding);
@@ -279,7 +445,8 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Synchronised lyrics/text (frames 4.9)
 
-  if(frameID == "SYLT") {
+  case FRAME_KEY('S', 'Y', 'L', 'T'):
+  {
     SynchronizedLyricsFrame *f = new SynchronizedLyricsFrame(data, header);
     if(d->useDefaultEncoding)
       f->setTextEncoding(d->defaultEncoding);
@@ -288,22 +455,23 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Event timing codes (frames 4.5)
 
-  if(frameID == "ETCO")
+  case FRAME_KEY('E', 'T', 'C', 'O'):
     return new EventTimingCodesFrame(data, header);
 
   // Popularimeter (frames 4.17)
 
-  if(frameID == "POPM")
+  case FRAME_KEY('P', 'O', 'P', 'M'):
     return new PopularimeterFrame(data, header);
 
   // Private (frames 4.27)
 
-  if(frameID == "PRIV")
+  case FRAME_KEY('P', 'R', 'I', 'V'):
     return new PrivateFrame(data, header);
 
   // Ownership (frames 4.22)
 
-  if(frameID == "OWNE") {
+  case FRAME_KEY('O', 'W', 'N', 'E'):
+  {
     OwnershipFrame *f = new OwnershipFrame(data, header);
     d->setTextEncoding(f);
     return f;
@@ -311,19 +479,36 @@ Frame *FrameFactory::createFrame(const ByteVector &origData, Header *tagHeader)
 
   // Chapter (ID3v2 chapters 1.0)
 
-  if(frameID == "CHAP")
+  case FRAME_KEY('C', 'H', 'A', 'P'):
     return new ChapterFrame(tagHeader, data, header);
 
   // Table of contents (ID3v2 chapters 1.0)
 
-  if(frameID == "CTOC")
+  case FRAME_KEY('C', 'T', 'O', 'C'):
     return new TableOfContentsFrame(tagHeader, data, header);
 
   // Apple proprietary PCST (Podcast)
 
-  if(frameID == "PCST")
+  case FRAME_KEY('P', 'C', 'S', 'T'):
     return new PodcastFrame(data, header);
 
+  default:
+    break;
+  }
+
+  // Text Identification (frames 4.2)
+
+  if((key >> 24) == 'T') {
+    TextIdentificationFrame *f = new TextIdentificationFrame(data, header);
+    d->setTextEncoding(f);
+    return f;
+  }
+
+  // URL link (frames 4.3)
+
+  if((key >> 24) == 'W')
+    return new UrlLinkFrame(data, header);
+
   return new UnknownFrame(data, header);
 }
 
@@ -369,6 +554,54 @@ void FrameFactory::setDefaultTextEncoding(String::Type encoding)
   d->defaultEncoding = encoding;
 }
 
+void FrameFactory::setFrameFilter(const ByteVectorList &frameIDs, FrameFilterMode mode)
+{
+  d->frameFilter = frameIDs;
+  d->frameFilterMode = mode;
+}
+
+bool FrameFactory::hasFrameFilter() const
+{
+  return !d->frameFilter.isEmpty() || d->frameFilterMode == ReadListedFrames;
+}
+
+bool FrameFactory::acceptsFrame(const ByteVector &frameID, unsigned int version) const
+{
+  if(!hasFrameFilter())
+    return true;
+
+  // Match against the ID3v2.4 name of the frame.
+
+  const ByteVector id = upgradedFrameID(frameID, version);
+
+  bool listed = false;
+  for(ByteVectorList::ConstIterator it = d->frameFilter.begin(); it != d->frameFilter.end(); ++it) {
+    if(id.startsWith(*it)) {
+      listed = true;
+      break;
+    }
+  }
+
+  return listed == (d->frameFilterMode == ReadListedFrames);
+}
+
+ByteVector FrameFactory::upgradedFrameID(const ByteVector &frameID, unsigned int version)
+{
+  ByteVector id = frameID;
+
+  if(version == 3 && id.size() == 4 && id[3] == '\0') {
+    // iTunes v2.3 tags store v2.2 frames
+    id = id.mid(0, 3);
+    version = 2;
+  }
+
+  const char *converted = convertedFrameID(frameKey(id), version);
+  if(converted)
+    return converted;
+
+  return id;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -383,110 +616,23 @@ FrameFactory::~FrameFactory()
   delete d;
 }
 
-namespace
-{
-  // Frame conversion table ID3v2.2 -> 2.4
-  const char *frameConversion2[][2] = {
-    { "BUF", "RBUF" },
-    { "CNT", "PCNT" },
-    { "COM", "COMM" },
-    { "CRA", "AENC" },
-    { "ETC", "ETCO" },
-    { "GEO", "GEOB" },
-    { "IPL", "TIPL" },
-    { "MCI", "MCDI" },
-    { "MLL", "MLLT" },
-    { "POP", "POPM" },
-    { "REV", "RVRB" },
-    { "SLT", "SYLT" },
-    { "STC", "SYTC" },
-    { "TAL", "TALB" },
-    { "TBP", "TBPM" },
-    { "TCM", "TCOM" },
-    { "TCO", "TCON" },
-    { "TCP", "TCMP" },
-    { "TCR", "TCOP" },
-    { "TDY", "TDLY" },
-    { "TEN", "TENC" },
-    { "TFT", "TFLT" },
-    { "TKE", "TKEY" },
-    { "TLA", "TLAN" },
-    { "TLE", "TLEN" },
-    { "TMT", "TMED" },
-    { "TOA", "TOAL" },
-    { "TOF", "TOFN" },
-    { "TOL", "TOLY" },
-    { "TOR", "TDOR" },
-    { "TOT", "TOAL" },
-    { "TP1", "TPE1" },
-    { "TP2", "TPE2" },
-    { "TP3", "TPE3" },
-    { "TP4", "TPE4" },
-    { "TPA", "TPOS" },
-    { "TPB", "TPUB" },
-    { "TRC", "TSRC" },
-    { "TRD", "TDRC" },
-    { "TRK", "TRCK" },
-    { "TS2", "TSO2" },
-    { "TSA", "TSOA" },
-    { "TSC", "TSOC" },
-    { "TSP", "TSOP" },
-    { "TSS", "TSSE" },
-    { "TST", "TSOT" },
-    { "TT1", "TIT1" },
-    { "TT2", "TIT2" },
-    { "TT3", "TIT3" },
-    { "TXT", "TOLY" },
-    { "TXX", "TXXX" },
-    { "TYE", "TDRC" },
-    { "UFI", "UFID" },
-    { "ULT", "USLT" },
-    { "WAF", "WOAF" },
-    { "WAR", "WOAR" },
-    { "WAS", "WOAS" },
-    { "WCM", "WCOM" },
-    { "WCP", "WCOP" },
-    { "WPB", "WPUB" },
-    { "WXX", "WXXX" },
-
-    // Apple iTunes nonstandard frames
-    { "PCS", "PCST" },
-    { "TCT", "TCAT" },
-    { "TDR", "TDRL" },
-    { "TDS", "TDES" },
-    { "TID", "TGID" },
-    { "WFD", "WFED" },
-    { "MVN", "MVNM" },
-    { "MVI", "MVIN" },
-  };
-  const size_t frameConversion2Size = sizeof(frameConversion2) / sizeof(frameConversion2[0]);
-
-  // Frame conversion table ID3v2.3 -> 2.4
-  const char *frameConversion3[][2] = {
-    { "TORY", "TDOR" },
-    { "TYER", "TDRC" },
-    { "IPLS", "TIPL" },
-  };
-  const size_t frameConversion3Size = sizeof(frameConversion3) / sizeof(frameConversion3[0]);
-}
-
 bool FrameFactory::updateFrame(Frame::Header *header) const
 {
-  const ByteVector frameID = header->frameID();
+  const unsigned int key = frameKey(header->frameID());
 
   switch(header->version()) {
 
   case 2: // ID3v2.2
   {
-    if(frameID == "CRM" ||
-       frameID == "EQU" ||
-       frameID == "LNK" ||
-       frameID == "RVA" ||
-       frameID == "TIM" ||
-       frameID == "TSI" ||
-       frameID == "TDA")
-    {
-      debug("ID3v2.4 no longer supports the frame type " + String(frameID) +
+    switch(key) {
+    case FRAME_KEY('C', 'R', 'M', 0):
+    case FRAME_KEY('E', 'Q', 'U', 0):
+    case FRAME_KEY('L', 'N', 'K', 0):
+    case FRAME_KEY('R', 'V', 'A', 0):
+    case FRAME_KEY('T', 'I', 'M', 0):
+    case FRAME_KEY('T', 'S', 'I', 0):
+    case FRAME_KEY('T', 'D', 'A', 0):
+      debug("ID3v2.4 no longer supports the frame type " + String(header->frameID()) +
             ".  It will be discarded from the tag.");
       return false;
     }
@@ -494,36 +640,30 @@ bool FrameFactory::updateFrame(Frame::Header *header) const
     // ID3v2.2 only used 3 bytes for the frame ID, so we need to convert all of
     // the frames to their 4 byte ID3v2.4 equivalent.
 
-    for(size_t i = 0; i < frameConversion2Size; ++i) {
-      if(frameID == frameConversion2[i][0]) {
-        header->setFrameID(frameConversion2[i][1]);
-        break;
-      }
-    }
+    const char *converted = convertedFrameID(key, 2);
+    if(converted)
+      header->setFrameID(converted);
 
     break;
   }
 
   case 3: // ID3v2.3
   {
-    if(frameID == "EQUA" ||
-       frameID == "RVAD" ||
-       frameID == "TIME" ||
-       frameID == "TRDA" ||
-       frameID == "TSIZ" ||
-       frameID == "TDAT")
-    {
-      debug("ID3v2.4 no longer supports the frame type " + String(frameID) +
+    switch(key) {
+    case FRAME_KEY('E', 'Q', 'U', 'A'):
+    case FRAME_KEY('R', 'V', 'A', 'D'):
+    case FRAME_KEY('T', 'I', 'M', 'E'):
+    case FRAME_KEY('T', 'R', 'D', 'A'):
+    case FRAME_KEY('T', 'S', 'I', 'Z'):
+    case FRAME_KEY('T', 'D', 'A', 'T'):
+      debug("ID3v2.4 no longer supports the frame type " + String(header->frameID()) +
             ".  It will be discarded from the tag.");
       return false;
     }
 
-    for(size_t i = 0; i < frameConversion3Size; ++i) {
-      if(frameID == frameConversion3[i][0]) {
-        header->setFrameID(frameConversion3[i][1]);
-        break;
-      }
-    }
+    const char *converted = convertedFrameID(key, 3);
+    if(converted)
+      header->setFrameID(converted);
 
     break;
   }
@@ -533,7 +673,7 @@ bool FrameFactory::updateFrame(Frame::Header *header) const
     // This should catch a typo that existed in TagLib up to and including
     // version 1.1 where TRDC was used for the year rather than TDRC.
 
-    if(frameID == "TRDC")
+    if(key == FRAME_KEY('T', 'R', 'D', 'C'))
       header->setFrameID("TDRC");
 
     break;
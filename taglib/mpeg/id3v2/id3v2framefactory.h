@@ -28,6 +28,7 @@
 
 #include "taglib_export.h"
 #include "tbytevector.h"
+#include "tbytevectorlist.h"
 #include "id3v2frame.h"
 #include "id3v2header.h"
 
@@ -123,6 +124,66 @@ namespace TagLib {
        */
       void setDefaultTextEncoding(String::Type encoding);
 
+      /*!
+       * Selects how the frame IDs given to setFrameFilter() are used.
+       */
+      enum FrameFilterMode {
+        //! Only the listed frames are read
+        ReadListedFrames,
+        //! All frames except the listed ones are read
+        SkipListedFrames
+      };
+
+      /*!
+       * Restricts the frames that are read from tags parsed with this factory.
+       * Skipped frames are stepped over using their header without reading
+       * their bodies.  Frame IDs are compared to the ID3v2.4 name of each frame
+       * and IDs shorter than four characters match as prefixes, so
+       * <tt>setFrameFilter(ByteVectorList::split("T COMM", " "),
+       * ReadListedFrames)</tt> reads only the text frames and comments.
+       *
+       * Skipped frames are read back when they are asked for by ID, for
+       * example through Tag::frameList(const ByteVector &) or the setters of
+       * Tag, and they are all read when the tag is saved, which requires the
+       * file to still be open.  Passing an empty list with SkipListedFrames
+       * (the default) removes the filter.
+       *
+       * \warning The filter belongs to this factory.  Setting it on instance()
+       * changes how every ID3v2 tag in the process is read, including the ones
+       * FileRef and other libraries open, and is not synchronized with tags
+       * being read on other threads.  Use a factory of your own (a subclass,
+       * as the constructor is protected) and pass it to the File instead.
+       *
+       * \note Tags read from a ByteVector, and ID3v2.3 tags using
+       * unsynchronisation, are always read completely.
+       *
+       * \see acceptsFrame()
+       */
+      void setFrameFilter(const ByteVectorList &frameIDs,
+                          FrameFilterMode mode = SkipListedFrames);
+
+      /*!
+       * Returns true if a frame filter is set.
+       *
+       * \see setFrameFilter()
+       */
+      bool hasFrameFilter() const;
+
+      /*!
+       * Returns true if frames with the ID \a frameID in a tag of the ID3v2
+       * major version \a version pass the frame filter.
+       *
+       * \see setFrameFilter()
+       */
+      bool acceptsFrame(const ByteVector &frameID, unsigned int version = 4) const;
+
+      /*!
+       * Returns the ID3v2.4 ID of frames with the ID \a frameID in a tag of
+       * the ID3v2 major version \a version, or \a frameID if it is not
+       * renamed.
+       */
+      static ByteVector upgradedFrameID(const ByteVector &frameID, unsigned int version);
+
     protected:
       /*!
        * Constructs a frame factory.  Because this is a singleton this method is
@@ -43,6 +43,7 @@
 #include "frames/uniquefileidentifierframe.h"
 #include "frames/unsynchronizedlyricsframe.h"
 #include "frames/unknownframe.h"
+#include "frames/attachedpictureframe.h"
 
 using namespace TagLib;
 using namespace ID3v2;
@@ -54,6 +55,88 @@ namespace
 
   const long MinPaddingSize = 1024;
   const long MaxPaddingSize = 1024 * 1024;
+
+  // The amount of tag data that is read at a time when frames are filtered.
+  const unsigned int FrameReadSize = 4096;
+
+  bool isValidFrameID(const ByteVector &frameID, unsigned int version)
+  {
+    if(frameID.size() != (version < 3 ? 3U : 4U))
+      return false;
+
+    for(unsigned int i = 0; i < frameID.size(); ++i) {
+      const char c = frameID[i];
+      if((c < 'A' || c > 'Z') && (c < '0' || c > '9') && !(version == 3 && i == 3 && c == '\0'))
+        return false;
+    }
+    return true;
+  }
+
+  // Reads the body of a tag from its file in small windows, so that data
+  // which isn't needed can be stepped over.
+
+  class FrameDataReader
+  {
+  public:
+    FrameDataReader(File *file, long offset, unsigned int length) :
+      file(file),
+      offset(offset),
+      length(length),
+      bufferPosition(0) {}
+
+    ByteVector read(unsigned int position, unsigned int size)
+    {
+      if(position >= length)
+        return ByteVector();
+
+      size = std::min(size, length - position);
+
+      if(position >= bufferPosition && position + size <= bufferPosition + buffer.size())
+        return buffer.mid(position - bufferPosition, size);
+
+      file->seek(offset + position);
+
+      if(size > FrameReadSize)
+        return file->readBlock(size);
+
+      bufferPosition = position;
+      buffer = file->readBlock(std::min(FrameReadSize, length - position));
+      return buffer.mid(0, size);
+    }
+
+  private:
+    File *file;
+    const long offset;
+    const unsigned int length;
+
+    ByteVector buffer;
+    unsigned int bufferPosition;
+  };
+
+  struct SkippedFrame
+  {
+    SkippedFrame() :
+      offset(0),
+      size(0),
+      frameSize(0) {}
+
+    SkippedFrame(const ByteVector &frameID, const ByteVector &upgradedID, long offset,
+                 unsigned int size, unsigned int frameSize) :
+      frameID(frameID),
+      upgradedID(upgradedID),
+      offset(offset),
+      size(size),
+      frameSize(frameSize) {}
+
+    ByteVector frameID;
+    // The ID3v2.4 ID, which the frame gets when it is read
+    ByteVector upgradedID;
+    // The position of the frame header and the amount of data to read for it
+    long offset;
+    unsigned int size;
+    // The size of the frame without its header
+    unsigned int frameSize;
+  };
 }
 
 class ID3v2::Tag::TagPrivate
@@ -86,6 +169,9 @@ public:
 
   FrameListMap frameListMap;
   FrameList frameList;
+
+  // Frames rejected by the factory's filter, which are read back on render.
+  List<SkippedFrame> skippedFrames;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -134,6 +220,8 @@ ID3v2::Tag::~Tag()
 
 String ID3v2::Tag::title() const
 {
+  readSkippedFrames("TIT2");
+
   if(!d->frameListMap["TIT2"].isEmpty())
     return d->frameListMap["TIT2"].front()->toString();
   return String();
@@ -141,6 +229,8 @@ String ID3v2::Tag::title() const
 
 String ID3v2::Tag::artist() const
 {
+  readSkippedFrames("TPE1");
+
   if(!d->frameListMap["TPE1"].isEmpty())
     return d->frameListMap["TPE1"].front()->toString();
   return String();
@@ -148,6 +238,8 @@ String ID3v2::Tag::artist() const
 
 String ID3v2::Tag::album() const
 {
+  readSkippedFrames("TALB");
+
   if(!d->frameListMap["TALB"].isEmpty())
     return d->frameListMap["TALB"].front()->toString();
   return String();
@@ -155,6 +247,8 @@ String ID3v2::Tag::album() const
 
 String ID3v2::Tag::comment() const
 {
+  readSkippedFrames("COMM");
+
   const FrameList &comments = d->frameListMap["COMM"];
 
   if(comments.isEmpty())
@@ -177,6 +271,8 @@ String ID3v2::Tag::genre() const
   // should be separated by " / " instead of " ".  For the moment to keep
   // the behavior the same as released versions it is being left with " ".
 
+  readSkippedFrames("TCON");
+
   if(d->frameListMap["TCON"].isEmpty() ||
      !dynamic_cast<TextIdentificationFrame *>(d->frameListMap["TCON"].front()))
   {
@@ -216,6 +312,8 @@ String ID3v2::Tag::genre() const
 
 unsigned int ID3v2::Tag::year() const
 {
+  readSkippedFrames("TDRC");
+
   if(!d->frameListMap["TDRC"].isEmpty())
     return d->frameListMap["TDRC"].front()->toString().substr(0, 4).toInt();
   return 0;
@@ -223,6 +321,8 @@ unsigned int ID3v2::Tag::year() const
 
 unsigned int ID3v2::Tag::track() const
 {
+  readSkippedFrames("TRCK");
+
   if(!d->frameListMap["TRCK"].isEmpty())
     return d->frameListMap["TRCK"].front()->toString().toInt();
   return 0;
@@ -250,6 +350,8 @@ void ID3v2::Tag::setComment(const String &s)
     return;
   }
 
+  readSkippedFrames("COMM");
+
   if(!d->frameListMap["COMM"].isEmpty())
     d->frameListMap["COMM"].front()->setText(s);
   else {
@@ -305,7 +407,7 @@ void ID3v2::Tag::setTrack(unsigned int i)
 
 bool ID3v2::Tag::isEmpty() const
 {
-  return d->frameList.isEmpty();
+  return d->frameList.isEmpty() && d->skippedFrames.isEmpty();
 }
 
 Header *ID3v2::Tag::header() const
@@ -325,16 +427,19 @@ Footer *ID3v2::Tag::footer() const
 
 const FrameListMap &ID3v2::Tag::frameListMap() const
 {
+  readSkippedFrames();
   return d->frameListMap;
 }
 
 const FrameList &ID3v2::Tag::frameList() const
 {
+  readSkippedFrames();
   return d->frameList;
 }
 
 const FrameList &ID3v2::Tag::frameList(const ByteVector &frameID) const
 {
+  readSkippedFrames(frameID);
   return d->frameListMap[frameID];
 }
 
@@ -364,12 +469,102 @@ void ID3v2::Tag::removeFrames(const ByteVector &id)
   FrameList l = d->frameListMap[id];
   for(FrameList::ConstIterator it = l.begin(); it != l.end(); ++it)
     removeFrame(*it, true);
+
+  for(List<SkippedFrame>::Iterator it = d->skippedFrames.begin(); it != d->skippedFrames.end();) {
+    if(it->upgradedID == id)
+      it = d->skippedFrames.erase(it);
+    else
+      ++it;
+  }
+}
+
+PictureHandleList ID3v2::Tag::pictureHandles() const
+{
+  PictureHandleList handles;
+
+  const FrameListMap::ConstIterator pictures = d->frameListMap.find("APIC");
+  if(pictures != d->frameListMap.end()) {
+    for(FrameList::ConstIterator it = pictures->second.begin(); it != pictures->second.end(); ++it) {
+      const AttachedPictureFrame *frame = dynamic_cast<const AttachedPictureFrame *>(*it);
+      if(frame) {
+        handles.append(PictureHandle(frame->picture(), frame->mimeType(), frame->type(),
+                                     frame->description()));
+      }
+    }
+  }
+
+  if(!d->file || !d->file->isOpen())
+    return handles;
+
+  const unsigned int version = d->header.majorVersion();
+  const unsigned int headerSize = Frame::headerSize(version);
+
+  for(List<SkippedFrame>::ConstIterator it = d->skippedFrames.begin(); it != d->skippedFrames.end(); ++it) {
+    if(it->frameID != "APIC" && !it->frameID.startsWith("PIC"))
+      continue;
+
+    d->file->seek(it->offset);
+    const ByteVector data = d->file->readBlock(std::min(it->size, FrameReadSize));
+    const Frame::Header header(data, version);
+
+    // Read the fields in front of the image, unless the frame data has to be
+    // decoded first.
+
+    bool stored = !header.compression() && !header.encryption() &&
+                  !(version >= 4 && (header.unsynchronisation() || d->header.unsynchronisation()));
+
+    unsigned int fieldsOffset = headerSize;
+    unsigned int fieldsLength = it->frameSize;
+    if(header.dataLengthIndicator()) {
+      if(it->frameSize < 4) {
+        stored = false;
+      }
+      else {
+        fieldsOffset += 4;
+        fieldsLength = std::min(SynchData::toUInt(data.mid(headerSize, 4)), it->frameSize - 4);
+      }
+    }
+
+    String mimeType;
+    String description;
+    int type = 0;
+    int position = -1;
+
+    if(stored) {
+      const ByteVector fields = data.mid(fieldsOffset, fieldsLength);
+      if(version < 3 || it->frameID.size() == 3 || it->frameID[3] == '\0')
+        position = AttachedPictureFrameV22::parsePictureFields(fields, mimeType, type, description);
+      else
+        position = AttachedPictureFrame::parsePictureFields(fields, mimeType, type, description);
+    }
+
+    if(position >= 0 && static_cast<unsigned int>(position) <= fieldsLength) {
+      handles.append(PictureHandle(d->file, it->offset + fieldsOffset + position,
+                                   fieldsLength - position, mimeType, type, description));
+      continue;
+    }
+
+    // Otherwise read and decode the whole frame.
+
+    d->file->seek(it->offset);
+    Frame *frame = d->factory->createFrame(d->file->readBlock(it->size), &d->header);
+    const AttachedPictureFrame *picture = dynamic_cast<const AttachedPictureFrame *>(frame);
+    if(picture) {
+      handles.append(PictureHandle(picture->picture(), picture->mimeType(), picture->type(),
+                                   picture->description()));
+    }
+    delete frame;
+  }
+
+  return handles;
 }
 
 PropertyMap ID3v2::Tag::properties() const
 {
+  // Frames skipped by the frame filter are left out.
+
   PropertyMap properties;
-  for(FrameList::ConstIterator it = frameList().begin(); it != frameList().end(); ++it) {
+  for(FrameList::ConstIterator it = d->frameList.begin(); it != d->frameList.end(); ++it) {
     PropertyMap props = (*it)->asProperties();
     properties.merge(props);
   }
@@ -425,7 +620,11 @@ PropertyMap ID3v2::Tag::setProperties(const PropertyMap &origProps)
   PropertyMap tiplProperties;
   PropertyMap tmclProperties;
   Frame::splitProperties(origProps, properties, tiplProperties, tmclProperties);
-  for(FrameListMap::ConstIterator it = frameListMap().begin(); it != frameListMap().end(); ++it){
+
+  // Compare against the same frames as properties(), so that frames skipped by
+  // the frame filter are not read back only to be deleted.
+
+  for(FrameListMap::ConstIterator it = d->frameListMap.begin(); it != d->frameListMap.end(); ++it){
     for(FrameList::ConstIterator lit = it->second.begin(); lit != it->second.end(); ++lit){
       PropertyMap frameProperties = (*lit)->asProperties();
       if(it->first == "TIPL") {
@@ -579,6 +778,10 @@ ByteVector ID3v2::Tag::render(int version) const
     version = 4;
   }
 
+  // Frames that were skipped while reading have to be written back.
+
+  readSkippedFrames();
+
   // TODO: Render the extended header.
 
   // Downgrade the frames that ID3v2.3 doesn't support.
@@ -681,8 +884,17 @@ void ID3v2::Tag::read()
   // If the tag size is 0, then this is an invalid tag (tags must contain at
   // least one frame)
 
-  if(d->header.tagSize() != 0)
-    parse(d->file->readBlock(d->header.tagSize()));
+  if(d->header.tagSize() != 0) {
+
+    // Frames can only be stepped over in the file if their sizes refer to the
+    // data as it is stored.
+
+    if(d->factory->hasFrameFilter() &&
+       !(d->header.unsynchronisation() && d->header.majorVersion() <= 3))
+      readFrames();
+    else
+      parse(d->file->readBlock(d->header.tagSize()));
+  }
 
   // Look for duplicate ID3v2 tags and treat them as an extra blank of this one.
   // It leads to overwriting them with zero when saving the tag.
@@ -709,6 +921,140 @@ void ID3v2::Tag::read()
   }
 }
 
+void ID3v2::Tag::readFrames()
+{
+  // This follows parse(), but reads the frames from the file as it goes so
+  // that the bodies of frames rejected by the frame filter are never read.
+
+  const unsigned int version = d->header.majorVersion();
+  const unsigned int headerSize = Frame::headerSize(version);
+  const long dataOffset = d->tagOffset + Header::size();
+  const unsigned int dataSize = d->header.tagSize();
+
+  FrameDataReader reader(d->file, dataOffset, dataSize);
+
+  unsigned int frameDataPosition = 0;
+  unsigned int frameDataLength = dataSize;
+
+  if(d->header.extendedHeader()) {
+    if(!d->extendedHeader)
+      d->extendedHeader = new ExtendedHeader();
+    d->extendedHeader->setData(reader.read(0, 4));
+    if(d->extendedHeader->size() <= frameDataLength) {
+      frameDataPosition += d->extendedHeader->size();
+      frameDataLength -= d->extendedHeader->size();
+    }
+  }
+
+  if(d->header.footerPresent() && Footer::size() <= frameDataLength)
+    frameDataLength -= Footer::size();
+
+  while(frameDataPosition + headerSize < frameDataLength) {
+
+    const ByteVector headerData = reader.read(frameDataPosition, headerSize);
+
+    if(headerData.at(0) == 0) {
+      if(d->header.footerPresent()) {
+        debug("Padding *and* a footer found.  This is not allowed by the spec.");
+      }
+
+      break;
+    }
+
+    const Frame::Header header(headerData, version);
+    unsigned int frameSize = header.frameSize();
+
+#ifndef NO_ITUNES_HACKS
+    // The same check as in Frame::Header, which can't see past the header here.
+    if(version >= 4 && frameSize > 127) {
+      const unsigned int next = frameDataPosition + headerSize;
+      if(!isValidFrameID(reader.read(next + frameSize, 4), 4)) {
+        const unsigned int uintSize = headerData.toUInt(4U);
+        if(isValidFrameID(reader.read(next + uintSize, 4), 4))
+          frameSize = uintSize;
+      }
+    }
+#endif
+
+    if(!d->factory->acceptsFrame(header.frameID(), version)) {
+      if(!isValidFrameID(header.frameID(), version) || frameSize == 0 ||
+         frameSize > dataSize - frameDataPosition)
+        return;
+
+      d->skippedFrames.append(SkippedFrame(header.frameID(),
+                                           FrameFactory::upgradedFrameID(header.frameID(), version),
+                                           dataOffset + frameDataPosition,
+                                           std::min(headerSize + frameSize + 4,
+                                                    dataSize - frameDataPosition),
+                                           frameSize));
+      frameDataPosition += headerSize + frameSize;
+      continue;
+    }
+
+    // Include the ID of the following frame for the check above.
+
+    Frame *frame = d->factory->createFrame(
+      reader.read(frameDataPosition, headerSize + frameSize + 4), &d->header);
+
+    if(!frame)
+      return;
+
+    if(frame->size() <= 0) {
+      delete frame;
+      return;
+    }
+
+    frameDataPosition += frame->size() + headerSize;
+    addFrame(frame);
+  }
+
+  d->factory->rebuildAggregateFrames(this);
+}
+
+void ID3v2::Tag::readSkippedFrames() const
+{
+  readSkippedFrames(ByteVector::null);
+}
+
+void ID3v2::Tag::readSkippedFrames(const ByteVector &frameID) const
+{
+  if(d->skippedFrames.isEmpty())
+    return;
+
+  if(!d->file || !d->file->isOpen()) {
+    debug("ID3v2::Tag::readSkippedFrames() -- The file is closed. Skipped frames are lost.");
+    d->skippedFrames.clear();
+    return;
+  }
+
+  // An empty ID reads all of them.
+
+  List<SkippedFrame> skippedFrames;
+  for(List<SkippedFrame>::Iterator it = d->skippedFrames.begin(); it != d->skippedFrames.end();) {
+    if(frameID.isEmpty() || it->upgradedID == frameID) {
+      skippedFrames.append(*it);
+      it = d->skippedFrames.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  for(List<SkippedFrame>::ConstIterator it = skippedFrames.begin(); it != skippedFrames.end(); ++it) {
+    d->file->seek(it->offset);
+    const ByteVector data = d->file->readBlock(it->size);
+
+    Frame *frame = 0;
+    if(data.startsWith(it->frameID))
+      frame = d->factory->createFrame(data, &d->header);
+
+    if(frame)
+      const_cast<Tag *>(this)->addFrame(frame);
+    else
+      debug("ID3v2::Tag::readSkippedFrames() -- Could not read back a skipped frame.");
+  }
+}
+
 void ID3v2::Tag::parse(const ByteVector &origData)
 {
   ByteVector data = origData;
@@ -783,6 +1129,8 @@ void ID3v2::Tag::setTextFrame(const ByteVector &id, const String &value)
     return;
   }
 
+  readSkippedFrames(id);
+
   if(!d->frameListMap[id].isEmpty())
     d->frameListMap[id].front()->setText(value);
   else {
@@ -31,6 +31,7 @@
 #include "tstring.h"
 #include "tlist.h"
 #include "tmap.h"
+#include "tpicturehandle.h"
 #include "taglib_export.h"
 
 #include "id3v2framefactory.h"
@@ -290,6 +291,32 @@ namespace TagLib {
        */
       void removeFrames(const ByteVector &id);
 
+      /*!
+       * Returns handles for the attached pictures (APIC frames) of the tag.
+       *
+       * Pictures that were read with the tag are returned from memory.  If
+       * APIC frames were skipped by the frame filter of the factory, only the
+       * fields in front of the image are read from the file and the handle
+       * refers to the image data in the file.
+       *
+       * \see FrameFactory::setFrameFilter()
+       */
+      PictureHandleList pictureHandles() const;
+
+      /*!
+       * Reads the frames that were skipped by the frame filter of the factory
+       * from the file, so that they no longer depend on it.  The files call
+       * this before they change anything when they are saved.  Frames that
+       * are asked for by ID, and all frames that are asked for through
+       * frameList() or frameListMap(), are read automatically.
+       *
+       * \note This requires the file to still be open and unchanged; otherwise
+       * the skipped frames are dropped.
+       *
+       * \see FrameFactory::setFrameFilter()
+       */
+      void readSkippedFrames() const;
+
       /*!
        * Implements the unified property interface -- export function.
        * This function does some work to translate the hard-specified ID3v2
@@ -318,6 +345,8 @@ namespace TagLib {
        *  the frame's ID and, in case of a frame ID which is allowed to appear more than
        *  once, the description, separated by a "/".
        *
+       * \note Frames skipped by the frame filter of the factory are left out,
+       * unless they have been read back.
        */
       PropertyMap properties() const;
 
@@ -337,6 +366,9 @@ namespace TagLib {
       /*!
        * Implements the unified property interface -- import function.
        * See the comments in properties().
+       *
+       * \note Like properties() this only looks at the frames that have been
+       * read, so frames skipped by the frame filter of the factory are kept.
        */
       PropertyMap setProperties(const PropertyMap &);
 
@@ -402,6 +434,9 @@ namespace TagLib {
       Tag(const Tag &);
       Tag &operator=(const Tag &);
 
+      void readFrames();
+      void readSkippedFrames(const ByteVector &frameID) const;
+
       class TagPrivate;
       TagPrivate *d;
     };
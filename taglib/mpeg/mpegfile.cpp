@@ -34,6 +34,9 @@
 
 #include "mpegfile.h"
 #include "mpegheader.h"
+#include "mpegframeheader.h"
+#include "mpegframewalker.h"
+#include "mpegscanner.h"
 #include "mpegutils.h"
 #include "tpropertymap.h"
 
@@ -42,6 +45,66 @@ using namespace TagLib;
 namespace
 {
   enum { ID3v2Index = 0, APEIndex = 1, ID3v1Index = 2 };
+
+  // Reads the frame header at \a offset into \a header, taking it from
+  // \a buffer, which holds the data at \a bufferOffset.  If it lies past the
+  // end of the buffer, the following blocks of \a blockSize bytes are
+  // appended to it, so that a scan finds them there instead of reading them
+  // again.
+
+  bool frameHeaderAt(File *file, ByteVector &buffer, long bufferOffset,
+                     long offset, unsigned int blockSize, unsigned int &header)
+  {
+    while(offset + 4 > bufferOffset + static_cast<long>(buffer.size())) {
+      file->seek(bufferOffset + buffer.size());
+      const ByteVector block = file->readBlock(blockSize);
+      if(block.isEmpty())
+        return false;
+
+      buffer.append(block);
+    }
+
+    header = buffer.toUInt(offset - bufferOffset, true);
+    return true;
+  }
+
+  // Returns the length of the frame at \a offset if its header is valid and
+  // the next frame is consistent with it, or 0 otherwise.  This is the check
+  // that MPEG::Header does when checkLength is true, but the headers are
+  // taken from the scan buffer and decoded without allocating anything.
+
+  int validFrameLength(File *file, ByteVector &buffer, long bufferOffset,
+                       long offset, unsigned int blockSize)
+  {
+    unsigned int data;
+    MPEG::FrameHeader header;
+    if(!frameHeaderAt(file, buffer, bufferOffset, offset, blockSize, data) ||
+       !MPEG::parseFrameHeader(data, header))
+      return 0;
+
+    unsigned int nextData;
+    if(!frameHeaderAt(file, buffer, bufferOffset, offset + header.frameLength, blockSize, nextData) ||
+       !MPEG::isSameStream(data, nextData))
+      return 0;
+
+    return header.frameLength;
+  }
+
+  // Removes the first \a offset bytes of \a buffer, which holds the data at
+  // \a position, once they are more than \a blockSize.  Otherwise a scan that
+  // keeps finding candidates would keep appending to the same buffer.
+
+  void dropScannedData(ByteVector &buffer, long &position, unsigned int &offset,
+                       unsigned int blockSize)
+  {
+    if(offset < blockSize)
+      return;
+
+    const ByteVector &data = buffer;
+    buffer = ByteVector(data.data() + offset, data.size() - offset);
+    position += offset;
+    offset = 0;
+  }
 }
 
 class MPEG::File::FilePrivate
@@ -54,6 +117,7 @@ public:
     APELocation(-1),
     APEOriginalSize(0),
     ID3v1Location(-1),
+    ID3v2Pending(false),
     properties(0) {}
 
   ~FilePrivate()
@@ -71,39 +135,43 @@ public:
 
   long ID3v1Location;
 
+  // Set while the ID3v2 tag has been located but not yet read.
+  bool ID3v2Pending;
+
   TagUnion tag;
 
   Properties *properties;
+  SeekIndex seekIndex;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 MPEG::File::~File()
@@ -113,16 +181,19 @@ MPEG::File::~File()
 
 TagLib::Tag *MPEG::File::tag() const
 {
+  readID3v2Tag();
   return &d->tag;
 }
 
 PropertyMap MPEG::File::properties() const
 {
+  readID3v2Tag();
   return d->tag.properties();
 }
 
 void MPEG::File::removeUnsupportedProperties(const StringList &properties)
 {
+  readID3v2Tag();
   d->tag.removeUnsupportedProperties(properties);
 }
 
@@ -168,6 +239,19 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
     return false;
   }
 
+  // A lazy signature has to be taken before the audio data is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
+  // So does a deferred ID3v2 tag, including the frames skipped by the frame
+  // filter.
+
+  readID3v2Tag();
+
+  if(ID3v2Tag())
+    ID3v2Tag()->readSkippedFrames();
+
   // Create the tags if we've been asked to.
 
   if(duplicateTags) {
@@ -273,6 +357,7 @@ bool MPEG::File::save(int tags, bool stripOthers, int id3v2Version, bool duplica
 
 ID3v2::Tag *MPEG::File::ID3v2Tag(bool create)
 {
+  readID3v2Tag();
   return d->tag.access<ID3v2::Tag>(ID3v2Index, create);
 }
 
@@ -298,6 +383,16 @@ bool MPEG::File::strip(int tags, bool freeMemory)
     return false;
   }
 
+  if(tags & ID3v2) {
+
+    // A deferred tag has to be kept if the caller still wants it in memory.
+
+    if(freeMemory)
+      d->ID3v2Pending = false;
+    else
+      readID3v2Tag();
+  }
+
   if((tags & ID3v2) && d->ID3v2Location >= 0) {
     removeBlock(d->ID3v2Location, d->ID3v2OriginalSize);
 
@@ -346,47 +441,66 @@ void MPEG::File::setID3v2FrameFactory(const ID3v2::FrameFactory *factory)
 
 long MPEG::File::nextFrameOffset(long position)
 {
-  ByteVector frameSyncBytes(2, '\0');
+  // The buffer holds the data at position.  The frame checks may append the
+  // following blocks to it, which are then scanned as well.
+
+  ByteVector buffer;
+  unsigned int offset = 0;
 
   while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
+    const int index = Scanner::findFrameSync(buffer, offset);
+    if(index >= 0) {
+      if(validFrameLength(this, buffer, position, position + index, bufferSize()) > 0)
+        return position + index;
+
+      offset = index + 1;
+      dropScannedData(buffer, position, offset, bufferSize());
+      continue;
+    }
 
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return position + i - 1;
-      }
+    // Keep the last byte, which may be the first one of a frame sync.
+
+    if(!buffer.isEmpty()) {
+      position += buffer.size() - 1;
+      buffer = buffer.mid(buffer.size() - 1);
     }
 
-    position += bufferSize();
+    seek(position + buffer.size());
+    const ByteVector block = readBlock(bufferSize());
+    if(block.isEmpty())
+      return -1;
+
+    buffer.append(block);
+    offset = 0;
   }
 }
 
 long MPEG::File::previousFrameOffset(long position)
 {
-  ByteVector frameSyncBytes(2, '\0');
+  ByteVector buffer;
 
   while(position > 0) {
-    const long bufferLength = std::min<long>(position, bufferSize());
-    position -= bufferLength;
+    const long blockLength = std::min<long>(position, bufferSize());
+    position -= blockLength;
+
+    // Keep the start of the data that was read before, which follows this
+    // block, so that the second byte of a frame sync and usually the next
+    // frame of a candidate are in the buffer as well.
 
     seek(position);
-    const ByteVector buffer = readBlock(bufferLength);
-
-    for(int i = buffer.size() - 1; i >= 0; --i) {
-      frameSyncBytes[1] = frameSyncBytes[0];
-      frameSyncBytes[0] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i, true);
-        if(header.isValid())
-          return position + i + header.frameLength();
-      }
+    const ByteVector block = readBlock(blockLength);
+    if(block.isEmpty())
+      return -1;
+
+    buffer = block + buffer.mid(0, bufferSize());
+
+    int index = Scanner::rfindFrameSync(buffer, block.size() - 1);
+    while(index >= 0) {
+      const int frameLength = validFrameLength(this, buffer, position, position + index, bufferSize());
+      if(frameLength > 0)
+        return position + index + frameLength;
+
+      index = (index > 0) ? Scanner::rfindFrameSync(buffer, index - 1) : -1;
     }
   }
 
@@ -398,7 +512,7 @@ long MPEG::File::firstFrameOffset()
   long position = 0;
 
   if(hasID3v2Tag())
-    position = d->ID3v2Location + ID3v2Tag()->header()->completeTagSize();
+    position = d->ID3v2Location + d->ID3v2OriginalSize;
 
   return nextFrameOffset(position);
 }
@@ -417,6 +531,71 @@ long MPEG::File::lastFrameOffset()
   return previousFrameOffset(position);
 }
 
+MPEG::SeekIndex MPEG::File::seekIndex(unsigned int interval)
+{
+  if(d->seekIndex.isValid() || interval == 0)
+    return d->seekIndex;
+
+  const long lastOffset = lastFrameOffset();
+  const long firstOffset = firstFrameOffset();
+
+  FrameHeader firstHeader;
+  if(lastOffset < 0 || firstOffset < 0 || !readFrameHeader(this, firstOffset, firstHeader)) {
+    debug("MPEG::File::seekIndex() -- Could not find the MPEG frames.");
+    return d->seekIndex;
+  }
+
+  // lastFrameOffset() points to the final frame, or to the end of the stream.
+
+  FrameHeader lastHeader;
+  const long end = lastOffset + (readFrameHeader(this, lastOffset, lastHeader) ? lastHeader.frameLength : 0);
+
+  List<SeekIndex::Entry> entries;
+  const FrameTotals totals = walkStream(this, firstOffset, end, firstHeader, interval, &entries);
+
+  if(!entries.isEmpty())
+    d->seekIndex = SeekIndex(interval, firstHeader.sampleRate, totals.samples, entries);
+
+  return d->seekIndex;
+}
+
+void MPEG::File::setSeekIndex(const SeekIndex &index)
+{
+  d->seekIndex = index;
+}
+
+long MPEG::File::frameOffsetForSample(unsigned long long sample, unsigned long long *frameSample)
+{
+  const SeekIndex index = seekIndex();
+  if(!index.isValid() || sample >= index.totalSamples())
+    return -1;
+
+  const long firstOffset = firstFrameOffset();
+  FrameHeader firstHeader;
+  if(firstOffset < 0 || !readFrameHeader(this, firstOffset, firstHeader))
+    return -1;
+
+  // Step through the frames after the entry, in blocks that usually hold
+  // all of them.
+
+  const SeekIndex::Entry entry = index.find(sample);
+  FrameWalker walker(this, firstOffset + static_cast<long>(entry.offset), length(),
+                     firstHeader.data, bufferSize() * 16);
+
+  unsigned long long position = entry.sample;
+  while(walker.next()) {
+    const unsigned int samples = walker.header().samplesPerFrame;
+    if(sample < position + samples) {
+      if(frameSample)
+        *frameSample = position;
+      return walker.offset();
+    }
+    position += samples;
+  }
+
+  return -1;
+}
+
 bool MPEG::File::hasID3v1Tag() const
 {
   return (d->ID3v1Location >= 0);
@@ -436,15 +615,26 @@ bool MPEG::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::File::read(bool readProperties)
+void MPEG::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   // Look for an ID3v2 tag
 
   d->ID3v2Location = findID3v2();
 
   if(d->ID3v2Location >= 0) {
-    d->tag.set(ID3v2Index, new ID3v2::Tag(this, d->ID3v2Location, d->ID3v2FrameFactory));
-    d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
+    if(readStyle & Properties::LazyTags) {
+
+      // Only the header is needed to skip the tag; the frames are read by
+      // readID3v2Tag() when the tag is first accessed.
+
+      seek(d->ID3v2Location);
+      const ID3v2::Header header(readBlock(ID3v2::Header::size()));
+      d->ID3v2OriginalSize = header.completeTagSize();
+    }
+    else {
+      d->tag.set(ID3v2Index, new ID3v2::Tag(this, d->ID3v2Location, d->ID3v2FrameFactory));
+      d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
+    }
   }
 
   // Look for an ID3v1 tag
@@ -465,14 +655,33 @@ void MPEG::File::read(bool readProperties)
   }
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, readStyle);
 
   // Make sure that we have our default tag types available.
 
-  ID3v2Tag(true);
+  if(readStyle & Properties::LazyTags)
+    d->ID3v2Pending = true;
+  else
+    ID3v2Tag(true);
+
   ID3v1Tag(true);
 }
 
+void MPEG::File::readID3v2Tag() const
+{
+  if(!d->ID3v2Pending)
+    return;
+
+  d->ID3v2Pending = false;
+
+  if(d->ID3v2Location >= 0 && isOpen()) {
+    File *file = const_cast<File *>(this);
+    d->tag.set(ID3v2Index, new ID3v2::Tag(file, d->ID3v2Location, d->ID3v2FrameFactory));
+  }
+
+  d->tag.access<ID3v2::Tag>(ID3v2Index, true);
+}
+
 long MPEG::File::findID3v2()
 {
   if(!isValid())
@@ -492,32 +701,38 @@ long MPEG::File::findID3v2()
 
   // Look for an ID3v2 tag until reaching the first valid MPEG frame.
 
-  ByteVector frameSyncBytes(2, '\0');
-  ByteVector tagHeaderBytes(3, '\0');
+  ByteVector buffer;
   long position = 0;
+  unsigned int offset = 0;
 
   while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
+    const int index = Scanner::findFrameSyncOrTag(buffer, offset);
+    if(index >= 0) {
+      if(buffer.containsAt(headerID, index))
+        return position + index;
 
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return -1;
-      }
+      if(validFrameLength(this, buffer, position, position + index, bufferSize()) > 0)
+        return -1;
 
-      tagHeaderBytes[0] = tagHeaderBytes[1];
-      tagHeaderBytes[1] = tagHeaderBytes[2];
-      tagHeaderBytes[2] = buffer[i];
-      if(tagHeaderBytes == headerID)
-        return position + i - 2;
+      offset = index + 1;
+      dropScannedData(buffer, position, offset, bufferSize());
+      continue;
     }
 
-    position += bufferSize();
+    // Keep the last two bytes, which may be the start of a frame sync or a
+    // tag identifier.
+
+    if(buffer.size() > 2) {
+      position += buffer.size() - 2;
+      buffer = buffer.mid(buffer.size() - 2);
+    }
+
+    seek(position + buffer.size());
+    const ByteVector block = readBlock(bufferSize());
+    if(block.isEmpty())
+      return -1;
+
+    buffer.append(block);
+    offset = 0;
   }
 }
@@ -31,6 +31,7 @@
 #include "tag.h"
 
 #include "mpegproperties.h"
+#include "mpegseekindex.h"
 
 namespace TagLib {
 
@@ -74,7 +75,10 @@ namespace TagLib {
        * Constructs an MPEG file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle includes AudioProperties::LazyTags only the
+       * ID3v2 header is read here; the frames are read on the first call to
+       * tag(), properties() or ID3v2Tag(), which requires the file to still
+       * be open.
        *
        * \deprecated This constructor will be dropped in favor of the one below
        * in a future version.
@@ -89,7 +93,10 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle includes AudioProperties::LazyTags only the
+       * ID3v2 header is read here; the frames are read on the first call to
+       * tag(), properties() or ID3v2Tag(), which requires the file to still
+       * be open.
        */
       // BIC: merge with the above constructor
       File(FileName file, ID3v2::FrameFactory *frameFactory,
@@ -106,7 +113,10 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * If \a propertiesStyle includes AudioProperties::LazyTags only the
+       * ID3v2 header is read here; the frames are read on the first call to
+       * tag(), properties() or ID3v2Tag(), which requires the file to still
+       * be open.
        */
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
@@ -349,6 +359,36 @@ namespace TagLib {
        */
       long lastFrameOffset();
 
+      /*!
+       * Returns the seek index of the stream.  If the file has none yet, all
+       * the frames are walked to build one with an entry every \a interval
+       * frames.  An index that was built while reading the properties with
+       * the Accurate style, or set with setSeekIndex(), is returned as it is.
+       *
+       * Returns an invalid index if the stream has no frames.
+       *
+       * \see frameOffsetForSample()
+       */
+      SeekIndex seekIndex(unsigned int interval = SeekIndex::DefaultInterval);
+
+      /*!
+       * Sets the seek index of the stream to \a index, for example one that
+       * was rendered and stored when the file was read before, so that seeks
+       * do not have to walk the stream again.
+       */
+      void setSeekIndex(const SeekIndex &index);
+
+      /*!
+       * Returns the position in the file of the frame that contains \a sample,
+       * counted per channel from the start of the stream, or -1 if the stream
+       * is shorter.  If \a frameSample is not null, it is set to the number of
+       * samples before that frame.
+       *
+       * This looks up the nearest entry of seekIndex() and then steps through
+       * at most interval() frame headers.
+       */
+      long frameOffsetForSample(unsigned long long sample, unsigned long long *frameSample = 0);
+
       /*!
        * Returns whether or not the file on disk actually has an ID3v1 tag.
        *
@@ -374,7 +414,8 @@ namespace TagLib {
       File(const File &);
       File &operator=(const File &);
 
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle readStyle);
+      void readID3v2Tag() const;
       long findID3v2();
 
       class FilePrivate;
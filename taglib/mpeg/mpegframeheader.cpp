@@ -0,0 +1,118 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include "mpegframeheader.h"
+#include "mpegheader.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // Indexed by the version bits: 2.5, reserved, 2 and 1.
+
+  const signed char versions[4] = {
+    MPEG::Header::Version2_5, -1, MPEG::Header::Version2, MPEG::Header::Version1
+  };
+
+  // Indexed by the layer bits: reserved, III, II and I.
+
+  const unsigned char layers[4] = { 0, 3, 2, 1 };
+
+  const unsigned short bitrates[2][3][16] = {
+    { // Version 1
+      { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }, // layer 1
+      { 0, 32, 48, 56, 64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 384, 0 }, // layer 2
+      { 0, 32, 40, 48, 56,  64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 0 }  // layer 3
+    },
+    { // Version 2 or 2.5
+      { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }, // layer 1
+      { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }, // layer 2
+      { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }  // layer 3
+    }
+  };
+
+  const unsigned short sampleRates[3][4] = {
+    { 44100, 48000, 32000, 0 }, // Version 1
+    { 22050, 24000, 16000, 0 }, // Version 2
+    { 11025, 12000, 8000,  0 }  // Version 2.5
+  };
+
+  const unsigned short samplesPerFrame[3][2] = {
+    // MPEG1, 2/2.5
+    {  384,   384 }, // Layer I
+    { 1152,  1152 }, // Layer II
+    { 1152,   576 }  // Layer III
+  };
+
+  const unsigned char paddingSizes[3] = { 4, 1, 1 };
+
+  inline bool fail(const char **error, const char *message)
+  {
+    if(error)
+      *error = message;
+    return false;
+  }
+}
+
+bool MPEG::parseFrameHeader(unsigned int data, FrameHeader &header, const char **error)
+{
+  // Check for the MPEG synch bits.  0xFF in the second byte is possible in
+  // theory, but it's very unlikely.
+
+  if((data & 0xFFE00000) != 0xFFE00000 || (data & 0x00FF0000) == 0x00FF0000)
+    return fail(error, "MPEG header did not match MPEG synch.");
+
+  const signed char version = versions[(data >> 19) & 0x03];
+  if(version < 0)
+    return fail(error, "Invalid MPEG version bits.");
+
+  const unsigned char layer = layers[(data >> 17) & 0x03];
+  if(layer == 0)
+    return fail(error, "Invalid MPEG layer bits.");
+
+  const int versionIndex = (version == Header::Version1) ? 0 : 1;
+  const int layerIndex   = layer - 1;
+
+  const unsigned short bitrate = bitrates[versionIndex][layerIndex][(data >> 12) & 0x0F];
+  if(bitrate == 0)
+    return fail(error, "Invalid bit rate.");
+
+  const unsigned short sampleRate = sampleRates[version][(data >> 10) & 0x03];
+  if(sampleRate == 0)
+    return fail(error, "Invalid sample rate.");
+
+  header.data            = data;
+  header.bitrate         = bitrate;
+  header.sampleRate      = sampleRate;
+  header.samplesPerFrame = samplesPerFrame[layerIndex][versionIndex];
+  header.version         = static_cast<unsigned char>(version);
+  header.layer           = layer;
+
+  // The longest frame, 2881 bytes of MPEG 2.5 layer II at 160 kb/s and 8 kHz,
+  // fits in the 16 bits.
+
+  header.frameLength = static_cast<unsigned short>(
+    static_cast<unsigned int>(header.samplesPerFrame) * bitrate * 125 / sampleRate);
+
+  if(header.isPadded())
+    header.frameLength += paddingSizes[layerIndex];
+
+  return true;
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGFRAMEHEADER_H
+#define TAGLIB_MPEGFRAMEHEADER_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  namespace MPEG {
+
+    //! A decoded MPEG frame header that can be copied freely
+
+    /*!
+     * This is what MPEG::Header holds, without the reference counted private
+     * data, so that the frame scans and the properties can decode a header
+     * on the stack.  The fields that are plain bits of the header are read
+     * from \a data when they are needed.
+     */
+
+    struct FrameHeader
+    {
+      //! The first four bytes of the frame, the most significant one first
+      unsigned int data;
+      //! In kb/s
+      unsigned short bitrate;
+      //! In Hz
+      unsigned short sampleRate;
+      //! In bytes, including the padding
+      unsigned short frameLength;
+      unsigned short samplesPerFrame;
+      //! An MPEG::Header::Version
+      unsigned char version;
+      //! Between 1 and 3
+      unsigned char layer;
+
+      bool protectionEnabled() const { return (data & 0x00010000) == 0; }
+      bool isPadded() const { return (data & 0x00000200) != 0; }
+      //! An MPEG::Header::ChannelMode
+      int channelMode() const { return (data >> 6) & 0x03; }
+      bool isCopyrighted() const { return (data & 0x00000008) != 0; }
+      bool isOriginal() const { return (data & 0x00000004) != 0; }
+    };
+
+    /*!
+     * Decodes \a data, the first four bytes of a frame with the most
+     * significant one first, into \a header.  Returns false if it is not a
+     * valid frame header, and points \a error at the reason if it is not
+     * null.  This does not allocate anything.
+     */
+    TAGLIB_EXPORT bool parseFrameHeader(unsigned int data, FrameHeader &header,
+                                        const char **error = 0);
+  }
+}
+
+#endif
+
+#endif
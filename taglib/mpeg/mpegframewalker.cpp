@@ -0,0 +1,138 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include "mpegframewalker.h"
+#include "mpegfile.h"
+#include "mpegutils.h"
+
+using namespace TagLib;
+
+MPEG::FrameWalker::FrameWalker(File *file, long offset, long end, unsigned int streamHeader,
+                               unsigned int blockSize) :
+  file(file),
+  end(end),
+  streamHeader(streamHeader),
+  blockSize(blockSize),
+  bufferOffset(offset),
+  frameOffset(-1),
+  nextOffset(offset)
+{
+  frameHeader.data            = 0;
+  frameHeader.bitrate         = 0;
+  frameHeader.sampleRate      = 0;
+  frameHeader.frameLength     = 0;
+  frameHeader.samplesPerFrame = 0;
+  frameHeader.version         = 0;
+  frameHeader.layer           = 0;
+}
+
+bool MPEG::FrameWalker::next()
+{
+  while(nextOffset >= 0 && nextOffset < end) {
+    unsigned int data;
+    if(!readHeader(data))
+      break;
+
+    FrameHeader header;
+    if(!parseFrameHeader(data, header) || !isSameStream(streamHeader, data)) {
+      nextOffset = file->nextFrameOffset(nextOffset + 1);
+      continue;
+    }
+
+    frameOffset = nextOffset;
+    frameHeader = header;
+    nextOffset += header.frameLength;
+    return true;
+  }
+
+  nextOffset = -1;
+  return false;
+}
+
+long MPEG::FrameWalker::offset() const
+{
+  return frameOffset;
+}
+
+const MPEG::FrameHeader &MPEG::FrameWalker::header() const
+{
+  return frameHeader;
+}
+
+bool MPEG::readFrameHeader(File *file, long offset, FrameHeader &header)
+{
+  file->seek(offset);
+  const ByteVector data = file->readBlock(4);
+
+  return data.size() == 4 && parseFrameHeader(data.toUInt(0, true), header);
+}
+
+MPEG::FrameTotals MPEG::walkStream(File *file, long firstOffset, long end,
+                                   const FrameHeader &firstHeader,
+                                   unsigned int interval, List<SeekIndex::Entry> *entries)
+{
+  FrameTotals totals;
+
+  FrameWalker walker(file, firstOffset, end, firstHeader.data);
+  while(walker.next()) {
+    if(entries && interval > 0 && totals.frames % interval == 0) {
+      const SeekIndex::Entry entry = { walker.offset() - firstOffset, totals.samples };
+      entries->append(entry);
+    }
+
+    totals.frames++;
+    totals.samples += walker.header().samplesPerFrame;
+    totals.bytes   += walker.header().frameLength;
+  }
+
+  return totals;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool MPEG::FrameWalker::readHeader(unsigned int &data)
+{
+  const long bufferEnd = bufferOffset + buffer.size();
+
+  if(nextOffset < bufferOffset || nextOffset + 4 > bufferEnd) {
+
+    // Keep the rest of the buffer and read the next block after it.
+
+    if(nextOffset >= bufferOffset && nextOffset < bufferEnd) {
+      const ByteVector &current = buffer;
+      buffer = ByteVector(current.data() + (nextOffset - bufferOffset), bufferEnd - nextOffset);
+    }
+    else {
+      buffer.clear();
+    }
+    bufferOffset = nextOffset;
+
+    file->seek(bufferOffset + buffer.size());
+    buffer.append(file->readBlock(blockSize));
+
+    if(buffer.size() < 4)
+      return false;
+  }
+
+  data = buffer.toUInt(nextOffset - bufferOffset, true);
+  return true;
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGFRAMEWALKER_H
+#define TAGLIB_MPEGFRAMEWALKER_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tbytevector.h"
+#include "tlist.h"
+#include "mpegframeheader.h"
+#include "mpegseekindex.h"
+
+namespace TagLib {
+
+  namespace MPEG {
+
+    class File;
+
+    //! Follows the chain of frames of an MPEG stream
+
+    /*!
+     * The frames are read in blocks of \a blockSize bytes, since the walk
+     * needs the header of every frame anyway.  Large blocks keep a walk over
+     * the whole stream close to the speed of a sequential read.  Only the
+     * frames that belong to the same stream as \a streamHeader are visited;
+     * anything else between them is skipped by looking for the next frame.
+     */
+
+    class FrameWalker
+    {
+    public:
+      FrameWalker(File *file, long offset, long end, unsigned int streamHeader,
+                  unsigned int blockSize = 256 * 1024);
+
+      /*!
+       * Moves to the next frame that starts before the end of the walk, or
+       * to the first one on the first call.  Returns false if there is none.
+       */
+      bool next();
+
+      /*!
+       * Returns the position of the current frame in the file.
+       */
+      long offset() const;
+
+      /*!
+       * Returns the header of the current frame.
+       */
+      const FrameHeader &header() const;
+
+    private:
+      bool readHeader(unsigned int &data);
+
+      File *file;
+      long end;
+      unsigned int streamHeader;
+      unsigned int blockSize;
+
+      ByteVector buffer;
+      long bufferOffset;
+
+      long frameOffset;
+      long nextOffset;
+      FrameHeader frameHeader;
+    };
+
+    /*!
+     * Decodes the frame header at \a offset of \a file into \a header,
+     * without checking the next frame.
+     */
+    bool readFrameHeader(File *file, long offset, FrameHeader &header);
+
+    struct FrameTotals
+    {
+      FrameTotals() :
+        frames(0),
+        samples(0),
+        bytes(0) {}
+
+      unsigned long long frames;
+      unsigned long long samples;
+      unsigned long long bytes;
+    };
+
+    /*!
+     * Walks the frames of the stream that starts at \a firstOffset with
+     * \a firstHeader and ends at \a end, and adds them up.  If \a entries
+     * is not null, every \a interval-th frame is appended to it as a seek
+     * index entry.
+     */
+    FrameTotals walkStream(File *file, long firstOffset, long end,
+                           const FrameHeader &firstHeader,
+                           unsigned int interval = 0, List<SeekIndex::Entry> *entries = 0);
+  }
+}
+
+#endif
+
+#endif
@@ -30,6 +30,7 @@
 #include <trefcounter.h>
 
 #include "mpegheader.h"
+#include "mpegframeheader.h"
 #include "mpegutils.h"
 
 using namespace TagLib;
@@ -38,31 +39,19 @@ class MPEG::Header::HeaderPrivate : public RefCounter
 {
 public:
   HeaderPrivate() :
-    isValid(false),
-    version(Version1),
-    layer(0),
-    protectionEnabled(false),
-    bitrate(0),
-    sampleRate(0),
-    isPadded(false),
-    channelMode(Stereo),
-    isCopyrighted(false),
-    isOriginal(false),
-    frameLength(0),
-    samplesPerFrame(0) {}
+    isValid(false)
+  {
+    header.data            = 0;
+    header.bitrate         = 0;
+    header.sampleRate      = 0;
+    header.frameLength     = 0;
+    header.samplesPerFrame = 0;
+    header.version         = Version1;
+    header.layer           = 0;
+  }
 
   bool isValid;
-  Version version;
-  int layer;
-  bool protectionEnabled;
-  int bitrate;
-  int sampleRate;
-  bool isPadded;
-  ChannelMode channelMode;
-  bool isCopyrighted;
-  bool isOriginal;
-  int frameLength;
-  int samplesPerFrame;
+  FrameHeader header;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,7 +61,7 @@ public:
 MPEG::Header::Header(const ByteVector &data) :
   d(new HeaderPrivate())
 {
-  debug("MPEG::Header::Header() - This constructor is no longer used.");
+  d->isValid = parse(data);
 }
 
 MPEG::Header::Header(File *file, long offset, bool checkLength) :
@@ -100,57 +89,57 @@ bool MPEG::Header::isValid() const
 
 MPEG::Header::Version MPEG::Header::version() const
 {
-  return d->version;
+  return static_cast<Version>(d->header.version);
 }
 
 int MPEG::Header::layer() const
 {
-  return d->layer;
+  return d->header.layer;
 }
 
 bool MPEG::Header::protectionEnabled() const
 {
-  return d->protectionEnabled;
+  return d->header.data != 0 && d->header.protectionEnabled();
 }
 
 int MPEG::Header::bitrate() const
 {
-  return d->bitrate;
+  return d->header.bitrate;
 }
 
 int MPEG::Header::sampleRate() const
 {
-  return d->sampleRate;
+  return d->header.sampleRate;
 }
 
 bool MPEG::Header::isPadded() const
 {
-  return d->isPadded;
+  return d->header.isPadded();
 }
 
 MPEG::Header::ChannelMode MPEG::Header::channelMode() const
 {
-  return d->channelMode;
+  return static_cast<ChannelMode>(d->header.channelMode());
 }
 
 bool MPEG::Header::isCopyrighted() const
 {
-  return d->isCopyrighted;
+  return d->header.isCopyrighted();
 }
 
 bool MPEG::Header::isOriginal() const
 {
-  return d->isOriginal;
+  return d->header.isOriginal();
 }
 
 int MPEG::Header::frameLength() const
 {
-  return d->frameLength;
+  return d->header.frameLength;
 }
 
 int MPEG::Header::samplesPerFrame() const
 {
-  return d->samplesPerFrame;
+  return d->header.samplesPerFrame;
 }
 
 MPEG::Header &MPEG::Header::operator=(const Header &h)
@@ -175,129 +164,8 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
   file->seek(offset);
   const ByteVector data = file->readBlock(4);
 
-  if(data.size() < 4) {
-    debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
-    return;
-  }
-
-  // Check for the MPEG synch bytes.
-
-  if(!isFrameSync(data)) {
-    debug("MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
-    return;
-  }
-
-  // Set the MPEG version
-
-  const int versionBits = (static_cast<unsigned char>(data[1]) >> 3) & 0x03;
-
-  if(versionBits == 0)
-    d->version = Version2_5;
-  else if(versionBits == 2)
-    d->version = Version2;
-  else if(versionBits == 3)
-    d->version = Version1;
-  else {
-    debug("MPEG::Header::parse() -- Invalid MPEG version bits.");
-    return;
-  }
-
-  // Set the MPEG layer
-
-  const int layerBits = (static_cast<unsigned char>(data[1]) >> 1) & 0x03;
-
-  if(layerBits == 1)
-    d->layer = 3;
-  else if(layerBits == 2)
-    d->layer = 2;
-  else if(layerBits == 3)
-    d->layer = 1;
-  else {
-    debug("MPEG::Header::parse() -- Invalid MPEG layer bits.");
+  if(!parse(data))
     return;
-  }
-
-  d->protectionEnabled = (static_cast<unsigned char>(data[1] & 0x01) == 0);
-
-  // Set the bitrate
-
-  static const int bitrates[2][3][16] = {
-    { // Version 1
-      { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }, // layer 1
-      { 0, 32, 48, 56, 64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 384, 0 }, // layer 2
-      { 0, 32, 40, 48, 56,  64,  80,  96,  112, 128, 160, 192, 224, 256, 320, 0 }  // layer 3
-    },
-    { // Version 2 or 2.5
-      { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }, // layer 1
-      { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }, // layer 2
-      { 0, 8,  16, 24, 32, 40, 48, 56,  64,  80,  96,  112, 128, 144, 160, 0 }  // layer 3
-    }
-  };
-
-  const int versionIndex = (d->version == Version1) ? 0 : 1;
-  const int layerIndex   = (d->layer > 0) ? d->layer - 1 : 0;
-
-  // The bitrate index is encoded as the first 4 bits of the 3rd byte,
-  // i.e. 1111xxxx
-
-  const int bitrateIndex = (static_cast<unsigned char>(data[2]) >> 4) & 0x0F;
-
-  d->bitrate = bitrates[versionIndex][layerIndex][bitrateIndex];
-
-  if(d->bitrate == 0) {
-    debug("MPEG::Header::parse() -- Invalid bit rate.");
-    return;
-  }
-
-  // Set the sample rate
-
-  static const int sampleRates[3][4] = {
-    { 44100, 48000, 32000, 0 }, // Version 1
-    { 22050, 24000, 16000, 0 }, // Version 2
-    { 11025, 12000, 8000,  0 }  // Version 2.5
-  };
-
-  // The sample rate index is encoded as two bits in the 3nd byte, i.e. xxxx11xx
-
-  const int samplerateIndex = (static_cast<unsigned char>(data[2]) >> 2) & 0x03;
-
-  d->sampleRate = sampleRates[d->version][samplerateIndex];
-
-  if(d->sampleRate == 0) {
-    debug("MPEG::Header::parse() -- Invalid sample rate.");
-    return;
-  }
-
-  // The channel mode is encoded as a 2 bit value at the end of the 3nd byte,
-  // i.e. xxxxxx11
-
-  d->channelMode = static_cast<ChannelMode>((static_cast<unsigned char>(data[3]) >> 6) & 0x03);
-
-  // TODO: Add mode extension for completeness
-
-  d->isOriginal    = ((static_cast<unsigned char>(data[3]) & 0x04) != 0);
-  d->isCopyrighted = ((static_cast<unsigned char>(data[3]) & 0x08) != 0);
-  d->isPadded      = ((static_cast<unsigned char>(data[2]) & 0x02) != 0);
-
-  // Samples per frame
-
-  static const int samplesPerFrame[3][2] = {
-    // MPEG1, 2/2.5
-    {  384,   384 }, // Layer I
-    { 1152,  1152 }, // Layer II
-    { 1152,   576 }  // Layer III
-  };
-
-  d->samplesPerFrame = samplesPerFrame[layerIndex][versionIndex];
-
-  // Calculate the frame length
-
-  static const int paddingSize[3] = { 4, 1, 1 };
-
-  d->frameLength = d->samplesPerFrame * d->bitrate * 125 / d->sampleRate;
-
-  if(d->isPadded)
-    d->frameLength += paddingSize[layerIndex];
 
   if(checkLength) {
 
@@ -308,7 +176,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
     // consistent. Otherwise, we assume that either or both of the frames are
     // broken.
 
-    file->seek(offset + d->frameLength);
+    file->seek(offset + d->header.frameLength);
     const ByteVector nextData = file->readBlock(4);
 
     if(nextData.size() < 4) {
@@ -316,12 +184,7 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
       return;
     }
 
-    const unsigned int HeaderMask = 0xfffe0c00;
-
-    const unsigned int header     = data.toUInt(0, true)     & HeaderMask;
-    const unsigned int nextHeader = nextData.toUInt(0, true) & HeaderMask;
-
-    if(header != nextHeader) {
+    if(!isSameStream(d->header.data, nextData.toUInt(0, true))) {
       debug("MPEG::Header::parse() -- The next frame was not consistent with this frame.");
       return;
     }
@@ -331,3 +194,19 @@ void MPEG::Header::parse(File *file, long offset, bool checkLength)
 
   d->isValid = true;
 }
+
+bool MPEG::Header::parse(const ByteVector &data)
+{
+  if(data.size() < 4) {
+    debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
+    return false;
+  }
+
+  const char *error = 0;
+  if(!parseFrameHeader(data.toUInt(0, true), d->header, &error)) {
+    debug(String("MPEG::Header::parse() -- ") + error);
+    return false;
+  }
+
+  return true;
+}
@@ -48,9 +48,11 @@ namespace TagLib {
     {
     public:
       /*!
-       * Parses an MPEG header based on \a data.
+       * Parses an MPEG header based on the first four bytes of \a data.
        *
-       * \deprecated
+       * \note Unlike the constructor below, this can not check the frame
+       * length against the next frame, so isValid() only tells that the header
+       * itself has legal values.
        */
       Header(const ByteVector &data);
 
@@ -168,6 +170,7 @@ namespace TagLib {
 
     private:
       void parse(File *file, long offset, bool checkLength);
+      bool parse(const ByteVector &data);
 
       class HeaderPrivate;
       HeaderPrivate *d;
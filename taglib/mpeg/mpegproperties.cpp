@@ -28,6 +28,8 @@
 
 #include "mpegproperties.h"
 #include "mpegfile.h"
+#include "mpegframewalker.h"
+#include "mpegseekindex.h"
 #include "xingheader.h"
 #include "apetag.h"
 #include "apefooter.h"
@@ -67,7 +69,7 @@ public:
   bool protectionEnabled;
   bool isCopyrighted;
   bool isOriginal;
-  ByteVector signature;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,7 +80,7 @@ MPEG::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(new PropertiesPrivate())
 {
-  read(file);
+  read(file, style);
 }
 
 MPEG::Properties::~Properties()
@@ -153,63 +155,45 @@ bool MPEG::Properties::isOriginal() const
 
 ByteVector MPEG::Properties::signature() const
 {
-  return d->signature;
+  return d->signature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Properties::read(File *file)
+void MPEG::Properties::read(File *file, ReadStyle style)
 {
   // Since we've likely just looked for the ID3v1 tag, start at the end of the
   // file where we're least likely to have to have to move the disk head.
 
-  long lastFrameOffset = file->lastFrameOffset();
+  const long lastFrameOffset = file->lastFrameOffset();
 
   if(lastFrameOffset < 0) {
     debug("MPEG::Properties::read() -- Could not find a valid last MPEG frame in the stream.");
     return;
   }
 
-  file->seek(lastFrameOffset);
-  Header lastHeader(file->readBlock(4));
+  // lastFrameOffset() points just past the last frame that was verified by its
+  // successor.  Usually the final frame starts there, otherwise the stream
+  // simply ends at that offset.
 
-  long firstFrameOffset = file->firstFrameOffset();
+  FrameHeader lastHeader;
+  const long lastFrameLength
+    = readFrameHeader(file, lastFrameOffset, lastHeader) ? lastHeader.frameLength : 0;
+
+  const long firstFrameOffset = file->firstFrameOffset();
 
   if(firstFrameOffset < 0) {
     debug("MPEG::Properties::read() -- Could not find a valid first MPEG frame in the stream.");
     return;
   }
 
-  if(!lastHeader.isValid()) {
-
-    long pos = lastFrameOffset;
-
-    while(pos > firstFrameOffset) {
-
-      pos = file->previousFrameOffset(pos);
-
-      if(pos < 0)
-        break;
-
-      file->seek(pos);
-      Header header(file->readBlock(4));
-
-      if(header.isValid()) {
-        lastHeader = header;
-        lastFrameOffset = pos;
-        break;
-      }
-    }
-  }
-
   // Now jump back to the front of the file and read what we need from there.
 
-  file->seek(firstFrameOffset);
-  Header firstHeader(file->readBlock(4));
+  FrameHeader firstHeader;
 
-  if(!firstHeader.isValid() || !lastHeader.isValid()) {
+  if(!readFrameHeader(file, firstFrameOffset, firstHeader)) {
     debug("MPEG::Properties::read() -- Page headers were invalid.");
     return;
   }
@@ -218,44 +202,66 @@ void MPEG::Properties::read(File *file)
   // VBR stream.
 
   file->seek(firstFrameOffset);
-  d->xingHeader = new XingHeader(file->readBlock(firstHeader.frameLength()));
+  d->xingHeader = new XingHeader(file->readBlock(firstHeader.frameLength));
   if(!d->xingHeader->isValid()) {
     delete d->xingHeader;
     d->xingHeader = 0;
   }
 
-  if(d->xingHeader && firstHeader.samplesPerFrame() > 0 && firstHeader.sampleRate() > 0) {
+  if(d->xingHeader && firstHeader.samplesPerFrame > 0 && firstHeader.sampleRate > 0) {
 
     // Read the length and the bitrate from the VBR header.
 
-    const double timePerFrame = firstHeader.samplesPerFrame() * 1000.0 / firstHeader.sampleRate();
+    const double timePerFrame = firstHeader.samplesPerFrame * 1000.0 / firstHeader.sampleRate;
     const double length = timePerFrame * d->xingHeader->totalFrames();
 
     d->length  = static_cast<int>(length + 0.5);
     d->bitrate = static_cast<int>(d->xingHeader->totalSize() * 8.0 / length + 0.5);
   }
-  else if(firstHeader.bitrate() > 0) {
+  else {
+
+    // Without a VBR header, the only way to know the length of a VBR stream is
+    // to count its frames, which Accurate reads do.
+
+    // The walk builds the seek index of the file at the same time.
+
+    FrameTotals totals;
+    if((style & ReadStyleLevelMask) == Accurate) {
+      List<SeekIndex::Entry> entries;
+      totals = walkStream(file, firstFrameOffset, lastFrameOffset + lastFrameLength, firstHeader,
+                          SeekIndex::DefaultInterval, &entries);
+      if(!entries.isEmpty()) {
+        file->setSeekIndex(SeekIndex(SeekIndex::DefaultInterval, firstHeader.sampleRate,
+                                     totals.samples, entries));
+      }
+    }
+
+    if(totals.samples > 0) {
+      const double length = totals.samples * 1000.0 / firstHeader.sampleRate;
 
-    // Since there was no valid VBR header found, we hope that we're in a constant
-    // bitrate file.
+      d->length  = static_cast<int>(length + 0.5);
+      d->bitrate = static_cast<int>(totals.bytes * 8.0 / length + 0.5);
+    }
+    else if(firstHeader.bitrate > 0) {
 
-    // TODO: Make this more robust with audio property detection for VBR without a
-    // Xing header.
+      // Otherwise we hope that we're in a constant bitrate file.
 
-    d->bitrate = firstHeader.bitrate();
+      d->bitrate = firstHeader.bitrate;
 
-    const long streamLength = lastFrameOffset - firstFrameOffset + lastHeader.frameLength();
-    if(streamLength > 0)
-      d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+      const long streamLength = lastFrameOffset - firstFrameOffset + lastFrameLength;
+      if(streamLength > 0)
+        d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+    }
   }
 
-  d->sampleRate        = firstHeader.sampleRate();
+  d->sampleRate        = firstHeader.sampleRate;
   d->channels          = firstHeader.channelMode() == Header::SingleChannel ? 1 : 2;
-  d->version           = firstHeader.version();
-  d->layer             = firstHeader.layer();
+  d->version           = static_cast<Header::Version>(firstHeader.version);
+  d->layer             = firstHeader.layer;
+  d->channelMode       = static_cast<Header::ChannelMode>(firstHeader.channelMode());
   d->protectionEnabled = firstHeader.protectionEnabled();
-  d->channelMode       = firstHeader.channelMode();
   d->isCopyrighted     = firstHeader.isCopyrighted();
   d->isOriginal        = firstHeader.isOriginal();
-  d->signature         = taglib_make_signature(file, firstFrameOffset, lastFrameOffset - firstFrameOffset);
+
+  d->signature.setRegion(file, firstFrameOffset, lastFrameOffset - firstFrameOffset, style);
 }
@@ -51,6 +51,11 @@ namespace TagLib {
       /*!
        * Create an instance of MPEG::Properties with the data read from the
        * MPEG::File \a file.
+       *
+       * If the stream has no Xing or VBRI header, the length is estimated from
+       * the bitrate of the first frame, unless \a style is Accurate.  Then all
+       * the frames are counted, which gives the exact length and average
+       * bitrate of VBR streams too, at the cost of reading the whole stream.
        */
       Properties(File *file, ReadStyle style = Average);
 
@@ -146,7 +151,7 @@ namespace TagLib {
       Properties(const Properties &);
       Properties &operator=(const Properties &);
 
-      void read(File *file);
+      void read(File *file, ReadStyle style);
 
       class PropertiesPrivate;
       PropertiesPrivate *d;
@@ -0,0 +1,406 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include "mpegscanner.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# define SCANNER_HAVE_X86
+# include <intrin.h>
+# include <immintrin.h>
+# define SCANNER_SSE2_TARGET
+# define SCANNER_AVX2_TARGET
+#elif (defined(__x86_64__) || defined(__i386__)) && \
+      ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+# define SCANNER_HAVE_X86
+# include <cpuid.h>
+# include <immintrin.h>
+# define SCANNER_SSE2_TARGET __attribute__((target("sse2")))
+# define SCANNER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  typedef int (*ScanFunction)(const unsigned char *data, unsigned int size, unsigned int offset);
+
+  inline bool isSyncAt(const unsigned char *p)
+  {
+    return (p[0] == 0xFF && p[1] != 0xFF && (p[1] & 0xE0) == 0xE0);
+  }
+
+  inline bool isTagAt(const unsigned char *p)
+  {
+    return (p[0] == 'I' && p[1] == 'D' && p[2] == '3');
+  }
+
+  // The scan functions expect the offsets to be valid starting positions,
+  // which is checked by the public functions: offset + 1 < size for the frame
+  // syncs, and offset + 2 < size when looking for tags as well.
+
+  int findSyncScalar(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    for(unsigned int i = offset; i + 1 < size; ++i) {
+      if(isSyncAt(data + i))
+        return i;
+    }
+    return -1;
+  }
+
+  int rfindSyncScalar(const unsigned char *data, unsigned int, unsigned int offset)
+  {
+    for(int i = offset; i >= 0; --i) {
+      if(isSyncAt(data + i))
+        return i;
+    }
+    return -1;
+  }
+
+  int findSyncOrTagScalar(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    for(unsigned int i = offset; i + 2 < size; ++i) {
+      if(isSyncAt(data + i) || isTagAt(data + i))
+        return i;
+    }
+    return -1;
+  }
+
+#ifdef SCANNER_HAVE_X86
+
+  inline unsigned int lowestBit(unsigned int bits)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return index;
+#else
+    return __builtin_ctz(bits);
+#endif
+  }
+
+  inline unsigned int highestBit(unsigned int bits)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, bits);
+    return index;
+#else
+    return 31 - __builtin_clz(bits);
+#endif
+  }
+
+  void cpuid(unsigned int leaf, unsigned int registers[4])
+  {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, leaf, 0);
+    for(int i = 0; i < 4; ++i)
+      registers[i] = static_cast<unsigned int>(info[i]);
+#else
+    __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+  }
+
+  bool hasSSE2()
+  {
+    unsigned int registers[4];
+    cpuid(1, registers);
+    return (registers[3] & (1U << 26)) != 0;
+  }
+
+  bool hasAVX2()
+  {
+    unsigned int registers[4];
+    cpuid(0, registers);
+    if(registers[0] < 7)
+      return false;
+
+    // The OS has to save the YMM registers as well.
+
+    cpuid(1, registers);
+    const unsigned int osxsaveAndAVX = (1U << 27) | (1U << 28);
+    if((registers[2] & osxsaveAndAVX) != osxsaveAndAVX)
+      return false;
+
+#ifdef _MSC_VER
+    const unsigned long long xcr0 = _xgetbv(0);
+#else
+    unsigned int xcr0Low, xcr0High;
+    __asm__ __volatile__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    const unsigned long long xcr0 = xcr0Low;
+#endif
+    if((xcr0 & 0x06) != 0x06)
+      return false;
+
+    cpuid(7, registers);
+    return (registers[1] & (1U << 5)) != 0;
+  }
+
+  // A byte of the result is 0xFF where a frame sync starts at that byte of
+  // a, given b, the same bytes shifted by one.
+
+  SCANNER_SSE2_TARGET
+  inline __m128i syncMask(__m128i a, __m128i b)
+  {
+    const __m128i ff = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i e0 = _mm_set1_epi8(static_cast<char>(0xE0));
+
+    return _mm_and_si128(_mm_cmpeq_epi8(a, ff),
+                         _mm_andnot_si128(_mm_cmpeq_epi8(b, ff),
+                                          _mm_cmpeq_epi8(_mm_and_si128(b, e0), e0)));
+  }
+
+  SCANNER_SSE2_TARGET
+  inline __m128i load(const unsigned char *p)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+
+  SCANNER_SSE2_TARGET
+  int findSyncSSE2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    unsigned int i = offset;
+    for(; i + 17 <= size; i += 16) {
+      const unsigned int bits = _mm_movemask_epi8(syncMask(load(data + i), load(data + i + 1)));
+      if(bits != 0)
+        return i + lowestBit(bits);
+    }
+    return findSyncScalar(data, size, i);
+  }
+
+  SCANNER_SSE2_TARGET
+  int rfindSyncSSE2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    // Positions before end are left to check.  The second byte of the last
+    // position is in data, since offset + 1 < size.
+
+    unsigned int end = offset + 1;
+    for(; end >= 16; end -= 16) {
+      const unsigned int i = end - 16;
+      const unsigned int bits = _mm_movemask_epi8(syncMask(load(data + i), load(data + i + 1)));
+      if(bits != 0)
+        return i + highestBit(bits);
+    }
+    return end > 0 ? rfindSyncScalar(data, size, end - 1) : -1;
+  }
+
+  SCANNER_SSE2_TARGET
+  int findSyncOrTagSSE2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    const __m128i i1 = _mm_set1_epi8('I');
+    const __m128i d2 = _mm_set1_epi8('D');
+    const __m128i three = _mm_set1_epi8('3');
+
+    unsigned int i = offset;
+    for(; i + 18 <= size; i += 16) {
+      const __m128i a = load(data + i);
+      const __m128i b = load(data + i + 1);
+      const __m128i c = load(data + i + 2);
+      const __m128i tag = _mm_and_si128(_mm_cmpeq_epi8(a, i1),
+                                        _mm_and_si128(_mm_cmpeq_epi8(b, d2), _mm_cmpeq_epi8(c, three)));
+      const unsigned int bits = _mm_movemask_epi8(_mm_or_si128(syncMask(a, b), tag));
+      if(bits != 0)
+        return i + lowestBit(bits);
+    }
+    return findSyncOrTagScalar(data, size, i);
+  }
+
+  SCANNER_AVX2_TARGET
+  inline __m256i syncMask(__m256i a, __m256i b)
+  {
+    const __m256i ff = _mm256_set1_epi8(static_cast<char>(0xFF));
+    const __m256i e0 = _mm256_set1_epi8(static_cast<char>(0xE0));
+
+    return _mm256_and_si256(_mm256_cmpeq_epi8(a, ff),
+                            _mm256_andnot_si256(_mm256_cmpeq_epi8(b, ff),
+                                                _mm256_cmpeq_epi8(_mm256_and_si256(b, e0), e0)));
+  }
+
+  SCANNER_AVX2_TARGET
+  inline __m256i load256(const unsigned char *p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+
+  SCANNER_AVX2_TARGET
+  int findSyncAVX2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    unsigned int i = offset;
+    for(; i + 33 <= size; i += 32) {
+      const unsigned int bits
+        = static_cast<unsigned int>(_mm256_movemask_epi8(syncMask(load256(data + i), load256(data + i + 1))));
+      if(bits != 0)
+        return i + lowestBit(bits);
+    }
+    return findSyncSSE2(data, size, i);
+  }
+
+  SCANNER_AVX2_TARGET
+  int rfindSyncAVX2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    unsigned int end = offset + 1;
+    for(; end >= 32; end -= 32) {
+      const unsigned int i = end - 32;
+      const unsigned int bits
+        = static_cast<unsigned int>(_mm256_movemask_epi8(syncMask(load256(data + i), load256(data + i + 1))));
+      if(bits != 0)
+        return i + highestBit(bits);
+    }
+    return end > 0 ? rfindSyncSSE2(data, size, end - 1) : -1;
+  }
+
+  SCANNER_AVX2_TARGET
+  int findSyncOrTagAVX2(const unsigned char *data, unsigned int size, unsigned int offset)
+  {
+    const __m256i i1 = _mm256_set1_epi8('I');
+    const __m256i d2 = _mm256_set1_epi8('D');
+    const __m256i three = _mm256_set1_epi8('3');
+
+    unsigned int i = offset;
+    for(; i + 34 <= size; i += 32) {
+      const __m256i a = load256(data + i);
+      const __m256i b = load256(data + i + 1);
+      const __m256i c = load256(data + i + 2);
+      const __m256i tag = _mm256_and_si256(_mm256_cmpeq_epi8(a, i1),
+                                           _mm256_and_si256(_mm256_cmpeq_epi8(b, d2),
+                                                            _mm256_cmpeq_epi8(c, three)));
+      const unsigned int bits
+        = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(syncMask(a, b), tag)));
+      if(bits != 0)
+        return i + lowestBit(bits);
+    }
+    return findSyncOrTagSSE2(data, size, i);
+  }
+
+#endif // SCANNER_HAVE_X86
+
+  struct Functions
+  {
+    MPEG::Scanner::Backend backend;
+    ScanFunction findSync;
+    ScanFunction rfindSync;
+    ScanFunction findSyncOrTag;
+  };
+
+  const Functions scalarFunctions = {
+    MPEG::Scanner::Scalar, findSyncScalar, rfindSyncScalar, findSyncOrTagScalar
+  };
+
+#ifdef SCANNER_HAVE_X86
+
+  const Functions sse2Functions = {
+    MPEG::Scanner::SSE2, findSyncSSE2, rfindSyncSSE2, findSyncOrTagSSE2
+  };
+
+  const Functions avx2Functions = {
+    MPEG::Scanner::AVX2, findSyncAVX2, rfindSyncAVX2, findSyncOrTagAVX2
+  };
+
+#endif
+
+  const Functions *functionsFor(MPEG::Scanner::Backend backend)
+  {
+    switch(backend) {
+    case MPEG::Scanner::Scalar:
+      return &scalarFunctions;
+#ifdef SCANNER_HAVE_X86
+    case MPEG::Scanner::SSE2:
+      return hasSSE2() ? &sse2Functions : 0;
+    case MPEG::Scanner::AVX2:
+      return hasSSE2() && hasAVX2() ? &avx2Functions : 0;
+#endif
+    default:
+      return 0;
+    }
+  }
+
+  const Functions *bestFunctions()
+  {
+    const MPEG::Scanner::Backend backends[] = {
+      MPEG::Scanner::AVX2, MPEG::Scanner::SSE2
+    };
+
+    for(unsigned int i = 0; i < sizeof(backends) / sizeof(backends[0]); ++i) {
+      const Functions *functions = functionsFor(backends[i]);
+      if(functions)
+        return functions;
+    }
+
+    return &scalarFunctions;
+  }
+
+  const Functions *activeFunctions = bestFunctions();
+
+  inline const unsigned char *bytes(const ByteVector &data)
+  {
+    return reinterpret_cast<const unsigned char *>(data.data());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+int MPEG::Scanner::findFrameSync(const ByteVector &data, unsigned int offset)
+{
+  if(data.size() < 2 || offset > data.size() - 2)
+    return -1;
+
+  return activeFunctions->findSync(bytes(data), data.size(), offset);
+}
+
+int MPEG::Scanner::rfindFrameSync(const ByteVector &data, unsigned int offset)
+{
+  if(data.size() < 2)
+    return -1;
+
+  if(offset > data.size() - 2)
+    offset = data.size() - 2;
+
+  return activeFunctions->rfindSync(bytes(data), data.size(), offset);
+}
+
+int MPEG::Scanner::findFrameSyncOrTag(const ByteVector &data, unsigned int offset)
+{
+  if(data.size() < 3 || offset > data.size() - 3)
+    return -1;
+
+  return activeFunctions->findSyncOrTag(bytes(data), data.size(), offset);
+}
+
+bool MPEG::Scanner::isSupported(Backend backend)
+{
+  return functionsFor(backend) != 0;
+}
+
+MPEG::Scanner::Backend MPEG::Scanner::backend()
+{
+  return activeFunctions->backend;
+}
+
+bool MPEG::Scanner::setBackend(Backend backend)
+{
+  const Functions *functions = functionsFor(backend);
+  if(!functions)
+    return false;
+
+  activeFunctions = functions;
+  return true;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGSCANNER_H
+#define TAGLIB_MPEGSCANNER_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tbytevector.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  namespace MPEG {
+
+    //! Functions that search a buffer for MPEG frame syncs and ID3v2 tags
+
+    /*!
+     * A frame sync candidate is a 0xFF byte followed by a byte whose three
+     * upper bits are set, as isFrameSync() checks it.  These functions look
+     * for candidates 16 or 32 bytes at a time with SSE2 or AVX2 when the CPU
+     * supports them; the candidates still have to be checked by parsing the
+     * header.
+     */
+
+    namespace Scanner
+    {
+      /*!
+       * The implementations of the scanner.
+       */
+      enum Backend {
+        //! Plain C++, available everywhere
+        Scalar,
+        //! 16 bytes at a time
+        SSE2,
+        //! 32 bytes at a time
+        AVX2
+      };
+
+      /*!
+       * Returns the index of the first frame sync candidate in \a data at or
+       * after \a offset, or -1 if there is none.  Only candidates whose two
+       * bytes are both in \a data are found.
+       */
+      TAGLIB_EXPORT int findFrameSync(const ByteVector &data, unsigned int offset = 0);
+
+      /*!
+       * Returns the index of the last frame sync candidate in \a data at or
+       * before \a offset, or -1 if there is none.  The second byte of the
+       * candidate may be after \a offset, but it has to be in \a data.
+       */
+      TAGLIB_EXPORT int rfindFrameSync(const ByteVector &data, unsigned int offset);
+
+      /*!
+       * Returns the index of the first frame sync candidate or "ID3" tag
+       * identifier in \a data at or after \a offset, or -1 if there is none.
+       * Only the indexes that are followed by at least two more bytes are
+       * checked, so that a candidate at the end of a block can be looked for
+       * again once the next block has been appended.
+       */
+      TAGLIB_EXPORT int findFrameSyncOrTag(const ByteVector &data, unsigned int offset = 0);
+
+      /*!
+       * Returns true if \a backend can be used with this build and CPU.
+       */
+      TAGLIB_EXPORT bool isSupported(Backend backend);
+
+      /*!
+       * Returns the backend that is used by the functions above.  By default
+       * this is the fastest supported one.
+       */
+      TAGLIB_EXPORT Backend backend();
+
+      /*!
+       * Makes the functions above use \a backend, which is meant for testing
+       * and benchmarking.  Returns false and leaves the backend unchanged if
+       * it is not supported.
+       *
+       * \warning The backend is a process-wide setting that is not
+       * synchronized.  Like File::setDefaultReadTraceCallback() it must only
+       * be changed while no other thread is using TagLib, typically once at
+       * startup.
+       */
+      TAGLIB_EXPORT bool setBackend(Backend backend);
+    }
+
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include <vector>
+
+#include <tbytevector.h>
+#include <tstring.h>
+#include <tdebug.h>
+#include <trefcounter.h>
+
+#include "mpegseekindex.h"
+
+using namespace TagLib;
+
+namespace
+{
+  // "MPSI" and a version byte, followed by the interval, the sample rate,
+  // the total samples and the number of entries, then the differences of the
+  // offsets and samples of consecutive entries.  All the numbers are stored
+  // with 7 bits per byte, the least significant group first.
+
+  const char identifier[] = "MPSI";
+  const unsigned int identifierSize = 4;
+  const char formatVersion = 1;
+
+  void appendNumber(ByteVector &data, unsigned long long value)
+  {
+    while(value >= 0x80) {
+      data.append(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    data.append(static_cast<char>(value));
+  }
+
+  bool readNumber(const ByteVector &data, unsigned int &offset, unsigned long long &value)
+  {
+    value = 0;
+    for(unsigned int shift = 0; shift < 64; shift += 7) {
+      if(offset >= data.size())
+        return false;
+
+      const unsigned char byte = data[offset++];
+      value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+      if((byte & 0x80) == 0)
+        return true;
+    }
+    return false;
+  }
+}
+
+class MPEG::SeekIndex::SeekIndexPrivate : public RefCounter
+{
+public:
+  SeekIndexPrivate() :
+    interval(0),
+    sampleRate(0),
+    totalSamples(0) {}
+
+  unsigned int interval;
+  unsigned int sampleRate;
+  unsigned long long totalSamples;
+  std::vector<Entry> entries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MPEG::SeekIndex::SeekIndex() :
+  d(new SeekIndexPrivate())
+{
+}
+
+MPEG::SeekIndex::SeekIndex(unsigned int interval, unsigned int sampleRate,
+                           unsigned long long totalSamples, const List<Entry> &entries) :
+  d(new SeekIndexPrivate())
+{
+  d->interval     = interval;
+  d->sampleRate   = sampleRate;
+  d->totalSamples = totalSamples;
+  d->entries.assign(entries.begin(), entries.end());
+}
+
+MPEG::SeekIndex::SeekIndex(const ByteVector &data) :
+  d(new SeekIndexPrivate())
+{
+  if(data.size() < identifierSize + 1 || !data.startsWith(identifier) ||
+     data[identifierSize] != formatVersion) {
+    debug("MPEG::SeekIndex::SeekIndex() -- Unknown seek index format.");
+    return;
+  }
+
+  unsigned int offset = identifierSize + 1;
+  unsigned long long interval, sampleRate, totalSamples, count;
+
+  if(!readNumber(data, offset, interval) || !readNumber(data, offset, sampleRate) ||
+     !readNumber(data, offset, totalSamples) || !readNumber(data, offset, count) ||
+     count > data.size() - offset) {
+    debug("MPEG::SeekIndex::SeekIndex() -- Truncated seek index.");
+    return;
+  }
+
+  std::vector<Entry> entries(static_cast<size_t>(count));
+
+  Entry previous = { 0, 0 };
+  for(size_t i = 0; i < entries.size(); ++i) {
+    unsigned long long offsetDelta, sampleDelta;
+    if(!readNumber(data, offset, offsetDelta) || !readNumber(data, offset, sampleDelta)) {
+      debug("MPEG::SeekIndex::SeekIndex() -- Truncated seek index.");
+      return;
+    }
+
+    entries[i].offset = previous.offset + static_cast<long long>(offsetDelta);
+    entries[i].sample = previous.sample + sampleDelta;
+    previous = entries[i];
+  }
+
+  d->interval     = static_cast<unsigned int>(interval);
+  d->sampleRate   = static_cast<unsigned int>(sampleRate);
+  d->totalSamples = totalSamples;
+  d->entries.swap(entries);
+}
+
+MPEG::SeekIndex::SeekIndex(const SeekIndex &index) :
+  d(index.d)
+{
+  d->ref();
+}
+
+MPEG::SeekIndex::~SeekIndex()
+{
+  if(d->deref())
+    delete d;
+}
+
+MPEG::SeekIndex &MPEG::SeekIndex::operator=(const SeekIndex &index)
+{
+  if(&index == this)
+    return *this;
+
+  if(d->deref())
+    delete d;
+
+  d = index.d;
+  d->ref();
+  return *this;
+}
+
+bool MPEG::SeekIndex::isValid() const
+{
+  return !d->entries.empty();
+}
+
+unsigned int MPEG::SeekIndex::interval() const
+{
+  return d->interval;
+}
+
+unsigned int MPEG::SeekIndex::sampleRate() const
+{
+  return d->sampleRate;
+}
+
+unsigned long long MPEG::SeekIndex::totalSamples() const
+{
+  return d->totalSamples;
+}
+
+unsigned int MPEG::SeekIndex::size() const
+{
+  return static_cast<unsigned int>(d->entries.size());
+}
+
+MPEG::SeekIndex::Entry MPEG::SeekIndex::entry(unsigned int index) const
+{
+  return d->entries[index];
+}
+
+MPEG::SeekIndex::Entry MPEG::SeekIndex::find(unsigned long long sample) const
+{
+  // The first entry after sample, then the one before it.
+
+  size_t low = 0;
+  size_t high = d->entries.size();
+  while(low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if(d->entries[middle].sample <= sample)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return d->entries[low > 0 ? low - 1 : 0];
+}
+
+ByteVector MPEG::SeekIndex::render() const
+{
+  ByteVector data(identifier, identifierSize);
+  data.append(formatVersion);
+
+  appendNumber(data, d->interval);
+  appendNumber(data, d->sampleRate);
+  appendNumber(data, d->totalSamples);
+  appendNumber(data, d->entries.size());
+
+  Entry previous = { 0, 0 };
+  for(std::vector<Entry>::const_iterator it = d->entries.begin(); it != d->entries.end(); ++it) {
+    appendNumber(data, static_cast<unsigned long long>(it->offset - previous.offset));
+    appendNumber(data, it->sample - previous.sample);
+    previous = *it;
+  }
+
+  return data;
+}
@@ -0,0 +1,152 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MPEGSEEKINDEX_H
+#define TAGLIB_MPEGSEEKINDEX_H
+
+#include "taglib_export.h"
+#include "tlist.h"
+
+namespace TagLib {
+
+  class ByteVector;
+
+  namespace MPEG {
+
+    //! A table of frame positions for seeking in an MPEG stream
+
+    /*!
+     * A seek index holds the position of every interval()-th frame of a
+     * stream, as a byte offset and the number of samples before it.  A
+     * seek looks up the entry before the wanted sample and then only has to
+     * step through the few frame headers that follow it.
+     *
+     * The offsets are relative to the first frame of the stream, so that an
+     * index stays valid when the tags in front of the stream change size.
+     * render() turns the index into a compact blob that can be stored and
+     * later read back with the ByteVector constructor.
+     *
+     * \see MPEG::File::seekIndex()
+     */
+
+    class TAGLIB_EXPORT SeekIndex
+    {
+    public:
+      /*!
+       * A frame of the stream.
+       */
+      struct Entry
+      {
+        //! The position of the frame, relative to the first frame
+        long long offset;
+        //! The number of samples per channel before the frame
+        unsigned long long sample;
+      };
+
+      /*!
+       * The number of frames between two entries that MPEG::File uses unless
+       * told otherwise, which is about a second of audio.
+       */
+      enum { DefaultInterval = 32 };
+
+      /*!
+       * Constructs an empty index.
+       */
+      SeekIndex();
+
+      /*!
+       * Constructs an index of \a entries, which are every \a interval-th
+       * frame of a stream of \a totalSamples samples at \a sampleRate Hz.  The
+       * entries have to be in stream order, starting with the first frame.
+       */
+      SeekIndex(unsigned int interval, unsigned int sampleRate,
+                unsigned long long totalSamples, const List<Entry> &entries);
+
+      /*!
+       * Reads an index from \a data, as written by render().  If the data
+       * can not be read, the index is empty and isValid() returns false.
+       */
+      explicit SeekIndex(const ByteVector &data);
+
+      /*!
+       * Does a shallow copy of \a index.
+       */
+      SeekIndex(const SeekIndex &index);
+
+      /*!
+       * Destroys this SeekIndex instance.
+       */
+      virtual ~SeekIndex();
+
+      /*!
+       * Makes a shallow copy of \a index.
+       */
+      SeekIndex &operator=(const SeekIndex &index);
+
+      /*!
+       * Returns true if the index has at least one entry.
+       */
+      bool isValid() const;
+
+      /*!
+       * Returns the number of frames between two entries.
+       */
+      unsigned int interval() const;
+
+      /*!
+       * Returns the sample rate of the stream in Hz.
+       */
+      unsigned int sampleRate() const;
+
+      /*!
+       * Returns the number of samples per channel in the stream.
+       */
+      unsigned long long totalSamples() const;
+
+      /*!
+       * Returns the number of entries.
+       */
+      unsigned int size() const;
+
+      /*!
+       * Returns the entry at \a index, which has to be less than size().
+       */
+      Entry entry(unsigned int index) const;
+
+      /*!
+       * Returns the last entry at or before \a sample, found with a binary
+       * search.  The index must not be empty.
+       */
+      Entry find(unsigned long long sample) const;
+
+      /*!
+       * Renders the index into a compact blob.  The entries are stored as
+       * variable length differences, which takes two to four bytes each.
+       */
+      ByteVector render() const;
+
+    private:
+      class SeekIndexPrivate;
+      SeekIndexPrivate *d;
+    };
+  }
+}
+
+#endif
@@ -54,6 +54,19 @@ namespace TagLib
         return (b1 == 0xFF && b2 != 0xFF && (b2 & 0xE0) == 0xE0);
       }
 
+      /*!
+       * Returns true if the frame headers \a header and \a nextHeader, the
+       * first four bytes of the frames with the most significant one first,
+       * have the same MPEG version, layer and sample rate, as two consecutive
+       * frames of a stream do.
+       */
+      inline bool isSameStream(unsigned int header, unsigned int nextHeader)
+      {
+        const unsigned int HeaderMask = 0xfffe0c00;
+
+        return (header & HeaderMask) == (nextHeader & HeaderMask);
+      }
+
     }
   }
 }
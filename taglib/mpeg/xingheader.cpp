@@ -32,18 +32,73 @@
 
 using namespace TagLib;
 
+namespace
+{
+  enum XingFlags {
+    FramesFlag  = 0x01,
+    BytesFlag   = 0x02,
+    TOCFlag     = 0x04,
+    QualityFlag = 0x08
+  };
+
+  const unsigned int TOCSize = 100;
+  const unsigned int LameTagSize = 36;
+
+  // CRC-16 (polynomial 0x8005, reflected, initial value 0) as used by the
+  // LAME tag to protect the first part of the Info frame.
+
+  unsigned short crc16(const ByteVector &data, unsigned int length)
+  {
+    unsigned short crc = 0;
+    for(unsigned int i = 0; i < length; ++i) {
+      crc ^= static_cast<unsigned char>(data[i]);
+      for(int bit = 0; bit < 8; ++bit)
+        crc = (crc & 1) ? ((crc >> 1) ^ 0xA001) : (crc >> 1);
+    }
+    return crc;
+  }
+
+  bool isLameEncoder(const ByteVector &data, unsigned int offset)
+  {
+    return data.containsAt("LAME", offset) ||
+           data.containsAt("Lavf", offset) ||
+           data.containsAt("Lavc", offset);
+  }
+}
+
 class MPEG::XingHeader::XingHeaderPrivate
 {
 public:
   XingHeaderPrivate() :
     frames(0),
     size(0),
+    quality(-1),
+    lameTag(false),
+    lameTagRevision(0),
+    vbrMethod(0),
+    lowpassFrequency(0),
+    encoderDelay(0),
+    encoderPadding(0),
+    musicLength(0),
+    musicCRC(0),
     type(MPEG::XingHeader::Invalid) {}
 
   unsigned int frames;
   unsigned int size;
   String encoder;
 
+  ByteVector toc;
+  int quality;
+
+  bool lameTag;
+  int lameTagRevision;
+  int vbrMethod;
+  int lowpassFrequency;
+  int encoderDelay;
+  int encoderPadding;
+  unsigned int musicLength;
+  unsigned short musicCRC;
+
   MPEG::XingHeader::HeaderType type;
 };
 
@@ -87,6 +142,82 @@ TagLib::String MPEG::XingHeader::encoderInfo() const
   return d->encoder;
 }
 
+bool MPEG::XingHeader::hasTableOfContents() const
+{
+  return !d->toc.isEmpty();
+}
+
+ByteVector MPEG::XingHeader::tableOfContents() const
+{
+  return d->toc;
+}
+
+long long MPEG::XingHeader::tableOfContentsOffset(double percent) const
+{
+  if(d->toc.isEmpty() || d->size == 0)
+    return -1;
+
+  if(percent < 0.0)
+    percent = 0.0;
+  if(percent > 100.0)
+    percent = 100.0;
+
+  // Linear interpolation between two neighbouring entries, as done by the
+  // Xing reference decoder.
+
+  const unsigned int index = percent < 99.0 ? static_cast<unsigned int>(percent) : 99;
+  const double lower = static_cast<unsigned char>(d->toc[index]);
+  const double upper = index < TOCSize - 1 ? static_cast<unsigned char>(d->toc[index + 1]) : 256.0;
+  const double position = lower + (upper - lower) * (percent - index);
+
+  return static_cast<long long>(position * d->size / 256.0);
+}
+
+int MPEG::XingHeader::quality() const
+{
+  return d->quality;
+}
+
+bool MPEG::XingHeader::hasLameTag() const
+{
+  return d->lameTag;
+}
+
+int MPEG::XingHeader::lameTagRevision() const
+{
+  return d->lameTagRevision;
+}
+
+int MPEG::XingHeader::vbrMethod() const
+{
+  return d->vbrMethod;
+}
+
+int MPEG::XingHeader::lowpassFrequency() const
+{
+  return d->lowpassFrequency;
+}
+
+int MPEG::XingHeader::encoderDelay() const
+{
+  return d->encoderDelay;
+}
+
+int MPEG::XingHeader::encoderPadding() const
+{
+  return d->encoderPadding;
+}
+
+unsigned int MPEG::XingHeader::musicLength() const
+{
+  return d->musicLength;
+}
+
+unsigned short MPEG::XingHeader::musicCRC() const
+{
+  return d->musicCRC;
+}
+
 int MPEG::XingHeader::xingHeaderOffset(TagLib::MPEG::Header::Version /*v*/,
                                        TagLib::MPEG::Header::ChannelMode /*c*/)
 {
@@ -119,11 +250,37 @@ void MPEG::XingHeader::parse(const ByteVector &data)
       return;
     }
 
+    const unsigned int flags = data.toUInt(offset + 4, true);
+
     d->frames = data.toUInt(offset + 8,  true);
     d->size   = data.toUInt(offset + 12, true);
     d->type   = Xing;
-    if (data.size() >= 140 && data.mid(120, 9).startsWith("LAME"))
-      d->encoder = data.mid(120, 9);
+
+    // The optional fields follow in a fixed order; each is only present if
+    // its flag is set.
+
+    unsigned int position = offset + 16;
+
+    if(flags & TOCFlag) {
+      if(data.size() < position + TOCSize) {
+        debug("MPEG::XingHeader::parse() -- Xing header too short for its table of contents.");
+        return;
+      }
+      d->toc = data.mid(position, TOCSize);
+      position += TOCSize;
+    }
+
+    if(flags & QualityFlag) {
+      if(data.size() < position + 4)
+        return;
+      d->quality = static_cast<int>(data.toUInt(position, true));
+      position += 4;
+    }
+
+    // The LAME extension immediately follows the Xing fields.
+
+    if(data.size() >= position + LameTagSize && isLameEncoder(data, position))
+      parseLameTag(data, position);
   }
   else {
 
@@ -146,3 +303,30 @@ void MPEG::XingHeader::parse(const ByteVector &data)
     }
   }
 }
+
+void MPEG::XingHeader::parseLameTag(const ByteVector &data, unsigned int offset)
+{
+  d->encoder = String(data.mid(offset, 9), String::Latin1).stripWhiteSpace();
+
+  // The tag is protected by a CRC of everything in the frame before it; if
+  // that doesn't match the fields below can't be trusted for gapless playback.
+
+  const unsigned short tagCRC = data.toUShort(offset + 34, true);
+  if(crc16(data, offset + 34) != tagCRC) {
+    debug("MPEG::XingHeader::parseLameTag() -- LAME tag CRC mismatch.");
+    return;
+  }
+
+  const unsigned char revision = static_cast<unsigned char>(data[offset + 9]);
+  d->lameTagRevision  = revision >> 4;
+  d->vbrMethod        = revision & 0x0F;
+  d->lowpassFrequency = static_cast<unsigned char>(data[offset + 10]) * 100;
+
+  const unsigned int delayAndPadding = data.toUInt(offset + 21, 3, true);
+  d->encoderDelay   = (delayAndPadding >> 12) & 0x0FFF;
+  d->encoderPadding = delayAndPadding & 0x0FFF;
+
+  d->musicLength = data.toUInt(offset + 28, true);
+  d->musicCRC    = data.toUShort(offset + 32, true);
+  d->lameTag     = true;
+}
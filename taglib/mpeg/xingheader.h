@@ -43,8 +43,9 @@ namespace TagLib {
      * This is a minimalistic implementation of the Xing/VBRI VBR headers.
      * Xing/VBRI headers are often added to VBR (variable bit rate) MP3 streams
      * to make it easy to compute the length and quality of a VBR stream.  Our
-     * implementation is only concerned with the total size of the stream (so
-     * that we can calculate the total playing time and the average bitrate).
+     * implementation reads the total size of the stream (so that we can
+     * calculate the total playing time and the average bitrate), the seek
+     * table of contents and the fields of the LAME extension, if present.
      * It uses <a href="http://home.pcisys.net/~melanson/codecs/mp3extensions.txt">
      * this text</a> and the XMMS sources as references.
      */
@@ -106,17 +107,87 @@ namespace TagLib {
       HeaderType type() const;
 
       /*!
-       * Returns the offset for the start of this Xing header, given the
-       * version and channels of the frame
+       * Returns the Lame encoder info, if any.
+       */
+      String encoderInfo() const;
+
+      /*!
+       * Returns true if the Xing header carries a seek table of contents.
+       */
+      bool hasTableOfContents() const;
+
+      /*!
+       * Returns the 100 entry Xing table of contents, or an empty ByteVector
+       * if there is none.  Entry \e i is the position in the stream of
+       * \e i percent of the playing time, in units of 1/256 of totalSize().
        *
-       * \deprecated Always returns 0.
+       * \see tableOfContentsOffset()
        */
+      ByteVector tableOfContents() const;
 
       /*!
-       * Returns the Lame encoder info, if any.
+       * Returns the byte offset, relative to the start of the first frame,
+       * of \a percent (0 to 100) of the playing time as estimated from the
+       * table of contents, or -1 if there is no table of contents.
+       */
+      long long tableOfContentsOffset(double percent) const;
+
+      /*!
+       * Returns the quality indicator of the Xing header (0 best, 100 worst),
+       * or -1 if it is not present.
+       */
+      int quality() const;
+
+      /*!
+       * Returns true if a LAME extension with a valid CRC follows the Xing
+       * header.  The LAME specific accessors below return 0 otherwise.
+       */
+      bool hasLameTag() const;
+
+      /*!
+       * Returns the revision of the LAME tag.
+       */
+      int lameTagRevision() const;
+
+      /*!
+       * Returns the VBR method recorded in the LAME tag (e.g. 1 for CBR,
+       * 2 for ABR, 3 to 6 for the VBR modes).
+       */
+      int vbrMethod() const;
+
+      /*!
+       * Returns the lowpass filter frequency in Hz, or 0 if unknown.
+       */
+      int lowpassFrequency() const;
+
+      /*!
+       * Returns the number of samples of encoder delay at the start of the
+       * stream.  Together with encoderPadding() this allows gapless playback.
+       */
+      int encoderDelay() const;
+
+      /*!
+       * Returns the number of padding samples at the end of the stream.
+       */
+      int encoderPadding() const;
+
+      /*!
+       * Returns the length in bytes of the stream from the start of this
+       * frame to the end of the last frame, as recorded by the encoder.
+       */
+      unsigned int musicLength() const;
+
+      /*!
+       * Returns the CRC-16 of the audio data as recorded by the encoder.
+       */
+      unsigned short musicCRC() const;
+
+      /*!
+       * Returns the offset for the start of this Xing header, given the
+       * version and channels of the frame
+       *
+       * \deprecated Always returns 0.
        */
-      String encoderInfo() const;
-      
       static int xingHeaderOffset(TagLib::MPEG::Header::Version v,
                                   TagLib::MPEG::Header::ChannelMode c);
 
@@ -125,6 +196,7 @@ namespace TagLib {
       XingHeader &operator=(const XingHeader &);
 
       void parse(const ByteVector &data);
+      void parseLameTag(const ByteVector &data, unsigned int offset);
 
       class XingHeaderPrivate;
       XingHeaderPrivate *d;
@@ -42,6 +42,7 @@ public:
     properties(0),
     streamStart(0),
     streamLength(0),
+    audioOffset(-1),
     scanned(false),
     hasXiphComment(false),
     commentPacket(0) {}
@@ -59,6 +60,7 @@ public:
   ByteVector xiphCommentData;
   long streamStart;
   long streamLength;
+  long audioOffset;
   bool scanned;
 
   bool hasXiphComment;
@@ -115,6 +117,11 @@ Properties *Ogg::FLAC::File::audioProperties() const
 
 bool Ogg::FLAC::File::save()
 {
+  // A lazy signature has to be taken before the audio data is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   d->xiphCommentData = d->comment->render(false);
 
   // Create FLAC metadata-block:
@@ -177,8 +184,11 @@ void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle properties
     d->comment = new Ogg::XiphComment();
 
 
-  if(readProperties)
-    d->properties = new Properties(streamInfoData(), streamLength(), propertiesStyle);
+  if(readProperties) {
+    const long audioLength = d->audioOffset >= 0 ? File::length() - d->audioOffset : 0;
+    d->properties = new Properties(streamInfoData(), this, d->audioOffset, audioLength,
+                                   propertiesStyle);
+  }
 }
 
 ByteVector Ogg::FLAC::File::streamInfoData()
@@ -293,6 +303,7 @@ void Ogg::FLAC::File::scan()
   // End of metadata, now comes the datastream
   d->streamStart = overhead;
   d->streamLength = File::length() - d->streamStart;
+  d->audioOffset = pageOffsetAfterPacket(ipacket);
 
   d->scanned = true;
 }
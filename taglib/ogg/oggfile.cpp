@@ -153,6 +153,18 @@ const Ogg::PageHeader *Ogg::File::lastPageHeader()
   return d->lastPageHeader->isValid() ? d->lastPageHeader : 0;
 }
 
+long Ogg::File::pageOffsetAfterPacket(unsigned int i)
+{
+  if(!readPages(i))
+    return -1;
+
+  List<Page *>::ConstIterator it = d->pages.begin();
+  while(nextPacketIndex(*it) <= i)
+    ++it;
+
+  return (*it)->fileOffset() + (*it)->size();
+}
+
 bool Ogg::File::save()
 {
   if(readOnly()) {
@@ -80,6 +80,13 @@ namespace TagLib {
 
       virtual bool save();
 
+      /*!
+       * Returns the offset of the page following the one in which packet \a i
+       * ends, or -1 if there is none.  For the last header packet of a
+       * stream, this is where the audio data starts.
+       */
+      long pageOffsetAfterPacket(unsigned int i);
+
     protected:
       /*!
        * Constructs an Ogg file from \a file.
@@ -57,20 +57,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 Opus::File::~File()
@@ -100,6 +100,11 @@ Opus::Properties *Opus::File::audioProperties() const
 
 bool Opus::File::save()
 {
+  // A lazy signature has to be taken before the audio pages are moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   if(!d->comment)
     d->comment = new Ogg::XiphComment();
 
@@ -112,7 +117,7 @@ bool Opus::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Opus::File::read(bool readProperties)
+void Opus::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector opusHeaderData = packet(0);
 
@@ -133,5 +138,5 @@ void Opus::File::read(bool readProperties)
   d->comment = new Ogg::XiphComment(commentHeaderData.mid(8));
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
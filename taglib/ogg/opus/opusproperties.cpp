@@ -34,6 +34,7 @@
 
 #include "opusproperties.h"
 #include "opusfile.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 using namespace TagLib::Ogg;
@@ -53,6 +54,7 @@ public:
   int inputSampleRate;
   int channels;
   int opusVersion;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -64,6 +66,12 @@ Opus::Properties::Properties(File *file, ReadStyle style) :
   d(new PropertiesPrivate())
 {
   read(file);
+
+  // The audio data starts on the page after the two header packets.
+
+  const long audioOffset = file->pageOffsetAfterPacket(1);
+  if(audioOffset >= 0)
+    d->signature.setRegion(file, audioOffset, file->length() - audioOffset, style);
 }
 
 Opus::Properties::~Properties()
@@ -114,6 +122,11 @@ int Opus::Properties::opusVersion() const
   return d->opusVersion;
 }
 
+ByteVector Opus::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,20 +57,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 Speex::File::~File()
@@ -100,6 +100,11 @@ Speex::Properties *Speex::File::audioProperties() const
 
 bool Speex::File::save()
 {
+  // A lazy signature has to be taken before the audio pages are moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   if(!d->comment)
     d->comment = new Ogg::XiphComment();
 
@@ -112,7 +117,7 @@ bool Speex::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Speex::File::read(bool readProperties)
+void Speex::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector speexHeaderData = packet(0);
 
@@ -126,5 +131,5 @@ void Speex::File::read(bool readProperties)
   d->comment = new Ogg::XiphComment(commentHeaderData);
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
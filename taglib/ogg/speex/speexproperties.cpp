@@ -34,6 +34,7 @@
 
 #include "speexproperties.h"
 #include "speexfile.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 using namespace TagLib::Ogg;
@@ -59,6 +60,7 @@ public:
   int speexVersion;
   bool vbr;
   int mode;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -70,6 +72,16 @@ Speex::Properties::Properties(File *file, ReadStyle style) :
   d(new PropertiesPrivate())
 {
   read(file);
+
+  // The audio data starts on the page after the header, the comment and the
+  // extra header packets.
+
+  const ByteVector header = file->packet(0);
+  const unsigned int extraHeaders = header.size() >= 72 ? header.toUInt(68, false) : 0;
+
+  const long audioOffset = file->pageOffsetAfterPacket(1 + extraHeaders);
+  if(audioOffset >= 0)
+    d->signature.setRegion(file, audioOffset, file->length() - audioOffset, style);
 }
 
 Speex::Properties::~Properties()
@@ -117,6 +129,11 @@ int Speex::Properties::speexVersion() const
   return d->speexVersion;
 }
 
+ByteVector Speex::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
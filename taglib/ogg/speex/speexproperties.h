@@ -113,6 +113,11 @@ namespace TagLib {
          */
         int speexVersion() const;
 
+        /*!
+         * Returns the SHA1 signature of the audio pages
+         */
+        virtual ByteVector signature() const;
+
       private:
         Properties(const Properties &);
         Properties &operator=(const Properties &);
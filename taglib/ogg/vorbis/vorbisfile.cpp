@@ -63,20 +63,20 @@ namespace TagLib {
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   Ogg::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 Vorbis::File::~File()
@@ -106,6 +106,11 @@ Vorbis::Properties *Vorbis::File::audioProperties() const
 
 bool Vorbis::File::save()
 {
+  // A lazy signature has to be taken before the audio pages are moved.
+
+  if(d->properties)
+    d->properties->signature();
+
   ByteVector v(vorbisCommentHeaderID);
 
   if(!d->comment)
@@ -121,7 +126,7 @@ bool Vorbis::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Vorbis::File::read(bool readProperties)
+void Vorbis::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   ByteVector commentHeaderData = packet(1);
 
@@ -134,5 +139,5 @@ void Vorbis::File::read(bool readProperties)
   d->comment = new Ogg::XiphComment(commentHeaderData.mid(7));
 
   if(readProperties)
-    d->properties = new Properties(this);
+    d->properties = new Properties(this, propertiesStyle);
 }
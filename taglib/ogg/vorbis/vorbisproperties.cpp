@@ -30,6 +30,7 @@
 
 #include "vorbisproperties.h"
 #include "vorbisfile.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 
@@ -54,7 +55,7 @@ public:
   int bitrateMaximum;
   int bitrateNominal;
   int bitrateMinimum;
-  ByteVector signature;
+  TaglibSignature signature;
 };
 
 namespace TagLib {
@@ -74,6 +75,12 @@ Vorbis::Properties::Properties(File *file, ReadStyle style) :
   d(new PropertiesPrivate())
 {
   read(file);
+
+  // The audio data starts on the page after the three header packets.
+
+  const long audioOffset = file->pageOffsetAfterPacket(2);
+  if(audioOffset >= 0)
+    d->signature.setRegion(file, audioOffset, file->length() - audioOffset, style);
 }
 
 Vorbis::Properties::~Properties()
@@ -133,7 +140,7 @@ int Vorbis::Properties::bitrateMinimum() const
 
 ByteVector Vorbis::Properties::signature() const
 {
-  return d->signature;
+  return d->signature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
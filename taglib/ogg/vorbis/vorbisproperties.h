@@ -110,7 +110,7 @@ namespace TagLib {
       virtual int channels() const;
 
       /*!
-       * Returns the SHA1 "signature" of the audio content
+       * Returns the SHA1 signature of the audio pages
        */
       virtual ByteVector signature() const;
 
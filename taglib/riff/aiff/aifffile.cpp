@@ -115,6 +115,16 @@ bool RIFF::AIFF::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before the SSND chunk is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
+  // Frames skipped by the ID3v2 frame filter are read before anything moves.
+
+  if(d->tag)
+    d->tag->readSkippedFrames();
+
   if(d->hasID3v2) {
     removeChunk("ID3 ");
     removeChunk("id3 ");
@@ -157,5 +167,5 @@ void RIFF::AIFF::File::read(bool readProperties, Properties::ReadStyle propertie
     d->tag = new ID3v2::Tag();
 
   if(readProperties)
-    d->properties = new Properties(this, propertiesStyle, this->audioSignature());
+    d->properties = new Properties(this, propertiesStyle, ByteVector());
 }
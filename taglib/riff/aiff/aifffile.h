@@ -61,7 +61,8 @@ namespace TagLib {
          * Constructs an AIFF file from \a file.  If \a readProperties is true the
          * file's audio properties will also be read.
          *
-         * \note In the current implementation, \a propertiesStyle is ignored.
+         * \note In the current implementation, only the signature flags of
+         * \a propertiesStyle are used.
          */
         File(FileName file, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -73,7 +74,8 @@ namespace TagLib {
          * \note TagLib will *not* take ownership of the stream, the caller is
          * responsible for deleting it after the File object.
          *
-         * \note In the current implementation, \a propertiesStyle is ignored.
+         * \note In the current implementation, only the signature flags of
+         * \a propertiesStyle are used.
          */
         File(IOStream *stream, bool readProperties = true,
              Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -25,6 +25,7 @@
 
 #include <tstring.h>
 #include <tdebug.h>
+#include <roon_taglib_utils.h>
 #include "aifffile.h"
 #include "aiffproperties.h"
 
@@ -53,6 +54,7 @@ public:
   unsigned int sampleFrames;
 
   ByteVector signature;
+  TaglibSignature streamSignature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,6 +74,15 @@ RIFF::AIFF::Properties::Properties(File *file, ReadStyle style, const ByteVector
 {
   d->signature = signature;
   read(file);
+
+  if(d->signature.isEmpty()) {
+    for(unsigned int i = 0; i < file->chunkCount(); ++i) {
+      if(file->chunkName(i) == "SSND") {
+        d->streamSignature.setRegion(file, file->chunkOffset(i), file->chunkDataSize(i), style);
+        break;
+      }
+    }
+  }
 }
 
 RIFF::AIFF::Properties::~Properties()
@@ -126,7 +137,10 @@ unsigned int RIFF::AIFF::Properties::sampleFrames() const
 
 ByteVector RIFF::AIFF::Properties::signature() const
 {
-  return d->signature;
+  if(!d->signature.isEmpty())
+    return d->signature;
+
+  return d->streamSignature.value();
 }
 
 bool RIFF::AIFF::Properties::isAiffC() const
@@ -56,7 +56,8 @@ namespace TagLib {
 
         /*!
          * Create an instance of AIFF::Properties with the data read from the
-         * AIFF::File \a file.
+         * AIFF::File \a file.  If \a signature is empty, the signature of the
+         * 'SSND' chunk is taken according to the signature flags of \a style.
          */
         Properties(File *file, ReadStyle style, const ByteVector &signature);
 
@@ -50,7 +50,8 @@ public:
   FilePrivate(Endianness endianness) :
     endianness(endianness),
     size(0),
-    sizeOffset(0) {}
+    sizeOffset(0),
+    audioChunk(-1) {}
 
   const Endianness endianness;
 
@@ -58,7 +59,7 @@ public:
   long sizeOffset;
 
   std::vector<Chunk> chunks;
-  ByteVector audio_signature;
+  int audioChunk;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -264,6 +265,11 @@ void RIFF::File::removeChunk(unsigned int i)
   for(; it != d->chunks.end(); ++it)
     it->offset -= removeSize;
 
+  if(d->audioChunk == static_cast<int>(i))
+    d->audioChunk = -1;
+  else if(d->audioChunk > static_cast<int>(i))
+    d->audioChunk--;
+
   // Update the global size.
 
   updateGlobalSize();
@@ -279,7 +285,11 @@ void RIFF::File::removeChunk(const ByteVector &name)
 
 ByteVector RIFF::File::audioSignature() const
 {
-    return d->audio_signature;
+  if(d->audioChunk < 0)
+    return ByteVector();
+
+  return taglib_make_signature(const_cast<File *>(this),
+                               chunkOffset(d->audioChunk), chunkDataSize(d->audioChunk));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -344,7 +354,7 @@ void RIFF::File::read()
   for (uint i = 0; i < chunkCount(); i++) {
     if (chunkName(i) == "SSND" || // aiff data chunk
         chunkName(i) == "data") { // wave data chunk
-      d->audio_signature = taglib_make_signature(this, chunkOffset(i), chunkDataSize(i));
+      d->audioChunk = i;
     }
   }
 }
@@ -139,6 +139,12 @@ namespace TagLib {
        */
       void removeChunk(const ByteVector &name);
 
+      /*!
+       * Returns the signature of the audio ("data" or "SSND") chunk.
+       *
+       * \note This reads the whole chunk.  WAV::Properties and
+       * AIFF::Properties take a lazy signature of the chunk instead.
+       */
       ByteVector audioSignature() const;
 
     private:
@@ -64,20 +64,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-RIFF::WAV::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+RIFF::WAV::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   RIFF::File(file, LittleEndian),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+RIFF::WAV::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   RIFF::File(stream, LittleEndian),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 RIFF::WAV::File::~File()
@@ -149,6 +149,16 @@ bool RIFF::WAV::File::save(TagTypes tags, bool stripOthers, int id3v2Version)
     return false;
   }
 
+  // A lazy signature has to be taken before the data chunk is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
+  // Frames skipped by the ID3v2 frame filter are read before anything moves.
+
+  if(ID3v2Tag())
+    ID3v2Tag()->readSkippedFrames();
+
   if(stripOthers)
     strip(static_cast<TagTypes>(AllTags & ~tags));
 
@@ -187,7 +197,7 @@ bool RIFF::WAV::File::hasInfoTag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void RIFF::WAV::File::read(bool readProperties)
+void RIFF::WAV::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   for(unsigned int i = 0; i < chunkCount(); ++i) {
     const ByteVector name = chunkName(i);
@@ -221,7 +231,7 @@ void RIFF::WAV::File::read(bool readProperties)
     d->tag.set(InfoIndex, new RIFF::Info::Tag());
 
   if(readProperties)
-    d->properties = new Properties(this, Properties::Average, this->audioSignature());
+    d->properties = new Properties(this, propertiesStyle, ByteVector());
 }
 
 void RIFF::WAV::File::removeTagChunks(TagTypes tags)
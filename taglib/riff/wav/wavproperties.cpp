@@ -24,6 +24,7 @@
  ***************************************************************************/
 
 #include <tdebug.h>
+#include <roon_taglib_utils.h>
 #include "wavfile.h"
 #include "wavproperties.h"
 
@@ -59,6 +60,7 @@ public:
   int bitsPerSample;
   unsigned int sampleFrames;
   ByteVector signature;
+  TaglibSignature streamSignature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -85,6 +87,15 @@ TagLib::RIFF::WAV::Properties::Properties(File *file, ReadStyle style, const Byt
 {
   d->signature = signature;
   read(file);
+
+  if(d->signature.isEmpty()) {
+    for(unsigned int i = 0; i < file->chunkCount(); ++i) {
+      if(file->chunkName(i) == "data") {
+        d->streamSignature.setRegion(file, file->chunkOffset(i), file->chunkDataSize(i), style);
+        break;
+      }
+    }
+  }
 }
 
 RIFF::WAV::Properties::~Properties()
@@ -144,7 +155,10 @@ int RIFF::WAV::Properties::format() const
 
 ByteVector RIFF::WAV::Properties::signature() const
 {
-  return d->signature;
+  if(!d->signature.isEmpty())
+    return d->signature;
+
+  return d->streamSignature.value();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
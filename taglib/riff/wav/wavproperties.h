@@ -67,7 +67,8 @@ namespace TagLib {
 
         /*!
          * Create an instance of WAV::Properties with the data read from the
-         * WAV::File \a file.
+         * WAV::File \a file.  If \a signature is empty, the signature of the
+         * 'data' chunk is taken according to the signature flags of \a style.
          */
         Properties(File *file, ReadStyle style, const ByteVector &signature);
 
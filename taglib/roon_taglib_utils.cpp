@@ -1,4 +1,6 @@
 #include <roon_taglib_utils.h>
+#include <oggfile.h>
+#include <oggpageheader.h>
 #include <SHA1.h>
 
 #define CHUNK_SIZE 32 * 1024
@@ -9,33 +11,28 @@ ByteVector taglib_make_signature(File *f, unsigned long long offset, unsigned lo
     CSHA1 sha1;
     sha1.Reset();
 
-    f->clear();
-
+    // fetch the samples as one batch, without moving the file position
+    List<IOStream::Range> ranges;
     if (length < 3 * CHUNK_SIZE)
     {
-        f->seek(offset);
-        ByteVector b = f->readBlock(length);
-        if (b.isNull()) return ByteVector::null;
-        sha1.Update((const unsigned char *)b.data(), length);
+        ranges.append(IOStream::Range(offset, length));
     }
     else
     {
-        f->seek(offset);
-        ByteVector b = f->readBlock(CHUNK_SIZE);
-        if (b.isNull()) return ByteVector::null;
-        sha1.Update((const unsigned char *)b.data(), CHUNK_SIZE);
-
-        f->seek(offset + length / 2);
-        b = f->readBlock(CHUNK_SIZE);
-        if (b.isNull()) return ByteVector::null;
-        sha1.Update((const unsigned char *)b.data(), CHUNK_SIZE);
-
-        f->seek(offset + length - CHUNK_SIZE);
-        b = f->readBlock(CHUNK_SIZE);
-        if (b.isNull()) return ByteVector::null;
-        sha1.Update((const unsigned char *)b.data(), CHUNK_SIZE);
+        ranges.append(IOStream::Range(offset, CHUNK_SIZE));
+        ranges.append(IOStream::Range(offset + length / 2, CHUNK_SIZE));
+        ranges.append(IOStream::Range(offset + length - CHUNK_SIZE, CHUNK_SIZE));
     }
 
+    unsigned long long expected = 0;
+    for (List<IOStream::Range>::ConstIterator it = ranges.begin(); it != ranges.end(); ++it)
+        expected += it->length;
+
+    // a short read would give a plausible but wrong signature
+    const ByteVector data = f->readBlocks(ranges);
+    if (data.size() != expected) return ByteVector::null;
+    sha1.Update((const unsigned char *)data.data(), data.size());
+
     // write data length as 64-bit little-endian bytes
     unsigned char b;
     b =  length & 0x00000000000000ffULL;        sha1.Update(&b, 1);
@@ -93,3 +90,118 @@ ByteVector taglib_make_signature(const ByteVector &bv)
     ByteVector ret((const char *)buf, sizeof(buf));
     return ret;
 }
+
+// compute signature of the page payloads from offset to offset+length in the
+// Ogg file f, sampling the pages found at the same positions as above
+ByteVector taglib_make_ogg_signature(Ogg::File *f, unsigned long long offset, unsigned long long length)
+{
+    CSHA1 sha1;
+    sha1.Reset();
+
+    const unsigned long long end = offset + length;
+
+    unsigned long long starts[3] = { offset, offset + length / 2, end - CHUNK_SIZE };
+    unsigned long long budget = CHUNK_SIZE;
+    int count = 3;
+    if (length < 3 * CHUNK_SIZE)
+    {
+        budget = length;
+        count = 1;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        long pos = f->find("OggS", static_cast<long>(starts[i]));
+        unsigned long long remaining = budget;
+
+        while (pos >= 0 && static_cast<unsigned long long>(pos) < end && remaining > 0)
+        {
+            const Ogg::PageHeader header(f, pos);
+            if (!header.isValid())
+                break;
+
+            const unsigned long long dataOffset = pos + header.size();
+            unsigned long long dataSize = header.dataSize();
+            if (dataOffset + dataSize > end)
+                dataSize = end > dataOffset ? end - dataOffset : 0;
+            if (dataSize > remaining)
+                dataSize = remaining;
+
+            f->seek(static_cast<long>(dataOffset));
+            const ByteVector data = f->readBlock(static_cast<size_t>(dataSize));
+            if (data.size() != dataSize) return ByteVector::null;
+            sha1.Update((const unsigned char *)data.data(), data.size());
+
+            remaining -= dataSize;
+            pos = static_cast<long>(dataOffset + header.dataSize());
+        }
+    }
+
+    // write data length as 64-bit little-endian bytes
+    unsigned char b;
+    b =  length & 0x00000000000000ffULL;        sha1.Update(&b, 1);
+    b = (length & 0x000000000000ff00ULL) >> 8;  sha1.Update(&b, 1);
+    b = (length & 0x0000000000ff0000ULL) >> 16; sha1.Update(&b, 1);
+    b = (length & 0x00000000ff000000ULL) >> 24; sha1.Update(&b, 1);
+    b = (length & 0x000000ff00000000ULL) >> 32; sha1.Update(&b, 1);
+    b = (length & 0x0000ff0000000000ULL) >> 40; sha1.Update(&b, 1);
+    b = (length & 0x00ff000000000000ULL) >> 48; sha1.Update(&b, 1);
+    b = (length & 0xff00000000000000ULL) >> 56; sha1.Update(&b, 1);
+
+    sha1.Final();
+
+    unsigned char buf[20];
+    if (!sha1.GetHash(buf)) return ByteVector::null;
+    ByteVector ret((const char *)buf, sizeof(buf));
+    return ret;
+}
+
+TaglibSignature::TaglibSignature() :
+    file(0),
+    offset(0),
+    length(0),
+    pending(false)
+{
+}
+
+void TaglibSignature::setRegion(File *f, unsigned long long offset, unsigned long long length,
+                                AudioProperties::ReadStyle style)
+{
+    this->file = f;
+    this->offset = offset;
+    this->length = length;
+    this->signature = ByteVector::null;
+    this->pending = false;
+
+    if (style & AudioProperties::NoSignature)
+        return;
+
+    if (style & AudioProperties::LazySignature)
+        pending = true;
+    else
+        signature = make();
+}
+
+void TaglibSignature::resolve() const
+{
+    if (!pending) return;
+
+    pending = false;
+    if (file && file->isOpen())
+        signature = make();
+}
+
+ByteVector TaglibSignature::value() const
+{
+    resolve();
+    return signature;
+}
+
+ByteVector TaglibSignature::make() const
+{
+    Ogg::File *oggFile = dynamic_cast<Ogg::File *>(file);
+    if (oggFile)
+        return taglib_make_ogg_signature(oggFile, offset, length);
+
+    return taglib_make_signature(file, offset, length);
+}
@@ -8,6 +8,9 @@
 #include "taglib_export.h"
 #include <tfile.h>
 #include <tbytevector.h>
+#include <audioproperties.h>
+
+namespace TagLib { namespace Ogg { class File; } }
 
 using namespace TagLib;
 
@@ -17,6 +20,40 @@ ByteVector taglib_make_signature(File *f, unsigned long long offset, unsigned lo
 TAGLIB_EXPORT
 ByteVector taglib_make_signature(const ByteVector &bv);
 
+// Same as above over the payload of the Ogg pages in a region of an Ogg file.
+// The page headers are skipped, since their sequence numbers and checksums
+// change when the pages of the header packets are rewritten.
+TAGLIB_EXPORT
+ByteVector taglib_make_ogg_signature(Ogg::File *f, unsigned long long offset, unsigned long long length);
+
+// Signature of a region of a file.  Depending on the signature flags of the
+// ReadStyle it is computed as soon as the region is set, on the first call to
+// value(), or never.  Regions of Ogg files are hashed with
+// taglib_make_ogg_signature().  The file is not owned and has to outlive any
+// lazy computation.
+class TAGLIB_EXPORT TaglibSignature
+{
+public:
+  TaglibSignature();
+
+  void setRegion(File *f, unsigned long long offset, unsigned long long length,
+                 AudioProperties::ReadStyle style);
+
+  // Computes a pending lazy signature now, e.g. before the file is modified.
+  void resolve() const;
+
+  ByteVector value() const;
+
+private:
+  ByteVector make() const;
+
+  File *file;
+  unsigned long long offset;
+  unsigned long long length;
+  mutable bool pending;
+  mutable ByteVector signature;
+};
+
 // #ifdef __cplusplus
 // }
 // #endif
@@ -28,12 +28,16 @@
 #include "tstring.h"
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "trefcounter.h"
+
+#include <algorithm>
 
 #ifdef _WIN32
 # include <windows.h>
 # include <io.h>
 #else
 # include <stdio.h>
+# include <time.h>
 # include <unistd.h>
 #endif
 
@@ -62,17 +66,85 @@
 #include "s3mfile.h"
 #include "itfile.h"
 #include "xmfile.h"
+#include "dsffile.h"
+#include "dfffile.h"
 #include "mp4file.h"
 
 using namespace TagLib;
 
+namespace
+{
+  // Not synchronized, see File::setDefaultReadTraceCallback().
+
+  File::ReadTraceCallback defaultTraceCallback = 0;
+  void *defaultTraceData = 0;
+  bool defaultIOTiming = false;
+
+  unsigned long long monotonicNanoseconds()
+  {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    const unsigned long long f = frequency.QuadPart;
+    const unsigned long long c = counter.QuadPart;
+    return (c / f) * 1000000000ULL + (c % f) * 1000000000ULL / f;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#endif
+  }
+
+  // Adds the time until it goes out of scope to the given counter, if
+  // enabled.  Otherwise the clock is not read at all.
+
+  class IOTimer
+  {
+  public:
+    IOTimer(unsigned long long &total, bool enabled) :
+      total(total),
+      enabled(enabled),
+      start(enabled ? monotonicNanoseconds() : 0) {}
+
+    ~IOTimer()
+    {
+      if(enabled)
+        total += monotonicNanoseconds() - start;
+    }
+
+  private:
+    unsigned long long &total;
+    const bool enabled;
+    const unsigned long long start;
+  };
+}
+
+class File::FileReference : public RefCounter
+{
+public:
+  explicit FileReference(File *file) :
+    file(file) {}
+
+  File *file;
+};
+
 class File::FilePrivate
 {
 public:
   FilePrivate(IOStream *stream, bool owner) :
     stream(stream),
     streamOwner(owner),
-    valid(true) {}
+    valid(true),
+    reference(0),
+    lastReadEnd(-1),
+    traceCallback(defaultTraceCallback),
+    traceData(defaultTraceData),
+    timing(defaultIOTiming)
+  {
+    resetStatistics();
+  }
 
   ~FilePrivate()
   {
@@ -80,9 +152,41 @@ public:
       delete stream;
   }
 
+  void resetStatistics()
+  {
+    statistics.readCalls = 0;
+    statistics.bytesRead = 0;
+    statistics.seekCalls = 0;
+    statistics.regions = 0;
+    statistics.writeCalls = 0;
+    statistics.bytesWritten = 0;
+    statistics.ioNanoseconds = 0;
+    lastReadEnd = -1;
+  }
+
+  void countRead(const File *file, long offset, unsigned long length)
+  {
+    statistics.readCalls++;
+    statistics.bytesRead += length;
+
+    if(offset != lastReadEnd)
+      statistics.regions++;
+    lastReadEnd = offset + static_cast<long>(length);
+
+    if(traceCallback)
+      traceCallback(file, offset, length, traceData);
+  }
+
   IOStream *stream;
   bool streamOwner;
   bool valid;
+  FileReference *reference;
+
+  IOStatistics statistics;
+  long lastReadEnd;
+  ReadTraceCallback traceCallback;
+  void *traceData;
+  bool timing;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +205,7 @@ File::File(IOStream *stream) :
 
 File::~File()
 {
+  detachReference();
   delete d;
 }
 
@@ -148,6 +253,10 @@ PropertyMap File::properties() const
     return dynamic_cast<const MP4::File* >(this)->properties();
   if(dynamic_cast<const ASF::File* >(this))
     return dynamic_cast<const ASF::File* >(this)->properties();
+  if(dynamic_cast<const DSFFile* >(this))
+    return dynamic_cast<const DSFFile* >(this)->properties();
+  if(dynamic_cast<const DFFFile* >(this))
+    return dynamic_cast<const DFFFile* >(this)->properties();
   return tag()->properties();
 }
 
@@ -177,6 +286,10 @@ void File::removeUnsupportedProperties(const StringList &properties)
     dynamic_cast<MP4::File* >(this)->removeUnsupportedProperties(properties);
   else if(dynamic_cast<ASF::File* >(this))
     dynamic_cast<ASF::File* >(this)->removeUnsupportedProperties(properties);
+  else if(dynamic_cast<DSFFile* >(this))
+    dynamic_cast<DSFFile* >(this)->removeUnsupportedProperties(properties);
+  else if(dynamic_cast<DFFFile* >(this))
+    dynamic_cast<DFFFile* >(this)->removeUnsupportedProperties(properties);
   else
     tag()->removeUnsupportedProperties(properties);
 }
@@ -219,17 +332,55 @@ PropertyMap File::setProperties(const PropertyMap &properties)
     return dynamic_cast<MP4::File* >(this)->setProperties(properties);
   else if(dynamic_cast<ASF::File* >(this))
     return dynamic_cast<ASF::File* >(this)->setProperties(properties);
+  else if(dynamic_cast<DSFFile* >(this))
+    return dynamic_cast<DSFFile* >(this)->setProperties(properties);
+  else if(dynamic_cast<DFFFile* >(this))
+    return properties; // DSDIFF has no tags
   else
     return tag()->setProperties(properties);
 }
 
 ByteVector File::readBlock(unsigned long length)
 {
-  return d->stream->readBlock(length);
+  ByteVector data;
+  long offset;
+  {
+    IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+    offset = d->stream->tell();
+    data = d->stream->readBlock(length);
+  }
+
+  d->countRead(this, offset, data.size());
+  return data;
+}
+
+ByteVector File::readBlocks(const List<IOStream::Range> &ranges)
+{
+  ByteVector data;
+  {
+    IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+    data = d->stream->readBlocks(ranges);
+  }
+
+  // Split the result up into the blocks that were actually read.
+
+  unsigned long remaining = data.size();
+  for(List<IOStream::Range>::ConstIterator it = ranges.begin(); it != ranges.end() && remaining > 0; ++it) {
+    const unsigned long length = std::min(it->length, remaining);
+    d->countRead(this, it->offset, length);
+    remaining -= length;
+  }
+
+  return data;
 }
 
 void File::writeBlock(const ByteVector &data)
 {
+  IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+  d->statistics.writeCalls++;
+  d->statistics.bytesWritten += data.size();
+
+  detachReference();
   d->stream->writeBlock(data);
 }
 
@@ -405,11 +556,20 @@ long File::rfind(const ByteVector &pattern, long fromOffset, const ByteVector &b
 
 void File::insert(const ByteVector &data, unsigned long start, unsigned long replace)
 {
+  IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+  d->statistics.writeCalls++;
+  d->statistics.bytesWritten += data.size();
+
+  detachReference();
   d->stream->insert(data, start, replace);
 }
 
 void File::removeBlock(unsigned long start, unsigned long length)
 {
+  IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+  d->statistics.writeCalls++;
+
+  detachReference();
   d->stream->removeBlock(start, length);
 }
 
@@ -430,11 +590,18 @@ bool File::isValid() const
 
 void File::seek(long offset, Position p)
 {
+  IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+  d->statistics.seekCalls++;
+
   d->stream->seek(offset, IOStream::Position(p));
 }
 
 void File::truncate(long length)
 {
+  IOTimer timer(d->statistics.ioNanoseconds, d->timing);
+  d->statistics.writeCalls++;
+
+  detachReference();
   d->stream->truncate(length);
 }
 
@@ -453,6 +620,38 @@ long File::length()
   return d->stream->length();
 }
 
+File::IOStatistics File::ioStatistics() const
+{
+  return d->statistics;
+}
+
+void File::resetIOStatistics()
+{
+  d->resetStatistics();
+}
+
+void File::setReadTraceCallback(ReadTraceCallback callback, void *userData)
+{
+  d->traceCallback = callback;
+  d->traceData = userData;
+}
+
+void File::setDefaultReadTraceCallback(ReadTraceCallback callback, void *userData) // static
+{
+  defaultTraceCallback = callback;
+  defaultTraceData = userData;
+}
+
+void File::setIOTiming(bool enable)
+{
+  d->timing = enable;
+}
+
+void File::setDefaultIOTiming(bool enable) // static
+{
+  defaultIOTiming = enable;
+}
+
 bool File::isReadable(const char *file)
 {
 
@@ -497,3 +696,37 @@ void File::setValid(bool valid)
   d->valid = valid;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+File::FileReference *File::reference()
+{
+  if(!d->reference)
+    d->reference = new FileReference(this);
+
+  d->reference->ref();
+  return d->reference;
+}
+
+File *File::referencedFile(const FileReference *reference) // static
+{
+  return reference ? reference->file : 0;
+}
+
+void File::releaseReference(FileReference *reference) // static
+{
+  if(reference && reference->deref())
+    delete reference;
+}
+
+void File::detachReference()
+{
+  if(!d->reference)
+    return;
+
+  d->reference->file = 0;
+  releaseReference(d->reference);
+  d->reference = 0;
+}
+
@@ -62,6 +62,40 @@ namespace TagLib {
       End
     };
 
+    /*!
+     * Counters of the I/O done through a File since it was constructed or
+     * since the last call to resetIOStatistics().
+     *
+     * \see ioStatistics()
+     */
+    struct IOStatistics
+    {
+      //! Number of reads; readBlocks() counts each block as one read
+      unsigned long long readCalls;
+      //! Number of bytes returned by the reads
+      unsigned long long bytesRead;
+      //! Number of seek() calls
+      unsigned long long seekCalls;
+      //! Number of reads that did not start where the previous read ended
+      unsigned long long regions;
+      //! Number of writeBlock(), insert(), removeBlock() and truncate() calls
+      unsigned long long writeCalls;
+      //! Number of bytes passed to writeBlock() and insert()
+      unsigned long long bytesWritten;
+      //! Time spent in the calls above, in nanoseconds; only measured while
+      //! timing is enabled with setIOTiming()
+      unsigned long long ioNanoseconds;
+    };
+
+    /*!
+     * A function that is called after each read with the \a offset and the
+     * \a length of the data that was read from \a file.
+     *
+     * \see setReadTraceCallback()
+     */
+    typedef void (*ReadTraceCallback)(const File *file, long offset, unsigned long length,
+                                      void *userData);
+
     /*!
      * Destroys this File instance.
      */
@@ -140,6 +174,14 @@ namespace TagLib {
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads the blocks described by \a ranges in one batch without moving the
+     * get pointer.
+     *
+     * \see IOStream::readBlocks()
+     */
+    ByteVector readBlocks(const List<IOStream::Range> &ranges);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -240,6 +282,53 @@ namespace TagLib {
      */
     long length();
 
+    /*!
+     * Returns the I/O counters of this file.  Since files are parsed in their
+     * constructors, this includes the cost of opening the file.
+     */
+    IOStatistics ioStatistics() const;
+
+    /*!
+     * Resets all I/O counters to zero.
+     */
+    void resetIOStatistics();
+
+    /*!
+     * Sets a function that is called with \a userData after each read from this
+     * file.  Pass a null \a callback to stop tracing.
+     *
+     * \see setDefaultReadTraceCallback()
+     */
+    void setReadTraceCallback(ReadTraceCallback callback, void *userData = 0);
+
+    /*!
+     * Sets the read trace callback that files constructed afterwards start
+     * with, so that the reads done while parsing a file can be traced too.
+     *
+     * \warning This is a process-wide setting that is not synchronized.  It
+     * must only be changed while no other thread is opening files, typically
+     * once at startup.
+     */
+    static void setDefaultReadTraceCallback(ReadTraceCallback callback, void *userData = 0);
+
+    /*!
+     * Enables or disables measuring the time spent in I/O calls, which is
+     * reported as IOStatistics::ioNanoseconds.  This reads a clock twice per
+     * call, so it is off by default; the other counters are always kept.
+     *
+     * \see setDefaultIOTiming()
+     */
+    void setIOTiming(bool enable);
+
+    /*!
+     * Sets whether files constructed afterwards measure the time spent in
+     * I/O calls, so that the time taken to parse a file is included.
+     *
+     * \warning Like setDefaultReadTraceCallback() this is process-wide and
+     * not synchronized.
+     */
+    static void setDefaultIOTiming(bool enable);
+
     /*!
      * Returns true if \a file can be opened for reading.  If the file does not
      * exist, this will return false.
@@ -297,6 +386,18 @@ namespace TagLib {
     File(const File &);
     File &operator=(const File &);
 
+    friend class PictureHandle;
+
+    // Picture handles refer to the file through a shared FileReference, which
+    // is let go when the file is written to or destroyed.  referencedFile()
+    // returns null after that.
+
+    class FileReference;
+    FileReference *reference();
+    static File *referencedFile(const FileReference *reference);
+    static void releaseReference(FileReference *reference);
+    void detachReference();
+
     class FilePrivate;
     FilePrivate *d;
   };
@@ -23,6 +23,10 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
 #include "tfilestream.h"
 #include "tstring.h"
 #include "tdebug.h"
@@ -31,6 +35,7 @@
 # include <windows.h>
 #else
 # include <stdio.h>
+# include <sys/stat.h>
 # include <unistd.h>
 #endif
 
@@ -38,6 +43,10 @@ using namespace TagLib;
 
 namespace
 {
+  // Size of the read-ahead window of new streams.
+
+  const unsigned int DefaultReadAheadSize = 16 * 1024;
+
 #ifdef _WIN32
 
   // Uses Win32 native API instead of POSIX API to reduce the resource consumption.
@@ -63,10 +72,10 @@ namespace
     CloseHandle(file);
   }
 
-  size_t readFile(FileHandle file, ByteVector &buffer)
+  size_t readFile(FileHandle file, char *data, size_t size)
   {
     DWORD length;
-    if(ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &length, NULL))
+    if(ReadFile(file, data, static_cast<DWORD>(size), &length, NULL))
       return static_cast<size_t>(length);
     else
       return 0;
@@ -81,6 +90,38 @@ namespace
       return 0;
   }
 
+  long fileLength(FileHandle file)
+  {
+    LARGE_INTEGER fileSize;
+
+    if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart <= LONG_MAX)
+      return static_cast<long>(fileSize.QuadPart);
+    else
+      return -1;
+  }
+
+  bool seekFile(FileHandle file, long offset, IOStream::Position p)
+  {
+    LARGE_INTEGER liOffset;
+    liOffset.QuadPart = offset;
+
+    return (SetFilePointerEx(file, liOffset, NULL, static_cast<DWORD>(p)) != 0);
+  }
+
+  // Note that this moves the file pointer of a synchronous handle.
+
+  size_t readFileAt(FileHandle file, char *data, size_t size, long offset)
+  {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+
+    DWORD length;
+    if(ReadFile(file, data, static_cast<DWORD>(size), &length, &overlapped))
+      return static_cast<size_t>(length);
+    else
+      return 0;
+  }
+
 #else   // _WIN32
 
   struct FileNameHandle : public std::string
@@ -103,9 +144,9 @@ namespace
     fclose(file);
   }
 
-  size_t readFile(FileHandle file, ByteVector &buffer)
+  size_t readFile(FileHandle file, char *data, size_t size)
   {
-    return fread(buffer.data(), sizeof(char), buffer.size(), file);
+    return fread(data, sizeof(char), size, file);
   }
 
   size_t writeFile(FileHandle file, const ByteVector &buffer)
@@ -113,6 +154,52 @@ namespace
     return fwrite(buffer.data(), sizeof(char), buffer.size(), file);
   }
 
+  long fileLength(FileHandle file)
+  {
+    struct stat st;
+
+    if(fstat(fileno(file), &st) == 0 && st.st_size <= LONG_MAX)
+      return static_cast<long>(st.st_size);
+    else
+      return -1;
+  }
+
+  bool seekFile(FileHandle file, long offset, IOStream::Position p)
+  {
+    int whence;
+    switch(p) {
+    case IOStream::Current:
+      whence = SEEK_CUR;
+      break;
+    case IOStream::End:
+      whence = SEEK_END;
+      break;
+    default:
+      whence = SEEK_SET;
+      break;
+    }
+
+    return (fseek(file, offset, whence) == 0);
+  }
+
+  // Reads around the stdio buffer without touching the stream position.  The
+  // stream has to be flushed before, so that pending writes are visible.
+
+  size_t readFileAt(FileHandle file, char *data, size_t size, long offset)
+  {
+    const int fd = fileno(file);
+
+    size_t count = 0;
+    while(count < size) {
+      const ssize_t n = pread(fd, data + count, size - count, offset + count);
+      if(n <= 0)
+        break;
+      count += static_cast<size_t>(n);
+    }
+
+    return count;
+  }
+
 #endif  // _WIN32
 }
 
@@ -123,12 +210,101 @@ public:
     : file(InvalidFileHandle)
     , name(fileName)
     , readOnly(true)
+    , size(0)
+    , position(0)
+    , filePosition(0)
+    , writing(false)
+    , windowOffset(0)
+    , readAheadSize(DefaultReadAheadSize)
   {
+    statistics.readCalls = 0;
+    statistics.bufferedReads = 0;
+    statistics.fileReads = 0;
+    statistics.seekCalls = 0;
+    statistics.fileSeeks = 0;
+  }
+
+  // Moves the file handle to \a offset unless it is already there.  stdio
+  // needs a seek whenever it switches between reading and writing.
+
+  bool moveHandle(long offset, bool write)
+  {
+    if(filePosition == offset && writing == write)
+      return true;
+
+    statistics.fileSeeks++;
+
+    if(!seekFile(file, offset, IOStream::Beginning)) {
+      filePosition = -1;
+      return false;
+    }
+
+    filePosition = offset;
+    writing = write;
+    return true;
+  }
+
+  // Reads \a length bytes at \a offset straight from the file handle.
+
+  size_t readAt(long offset, char *data, size_t length)
+  {
+    if(!moveHandle(offset, false))
+      return 0;
+
+    statistics.fileReads++;
+
+    const size_t count = readFile(file, data, length);
+
+    // A short read leaves stdio in the end-of-file state; the next access
+    // has to seek to clear it.
+
+    if(count < length)
+      filePosition = -1;
+    else
+      filePosition += static_cast<long>(count);
+
+    return count;
+  }
+
+  size_t writeAt(long offset, const ByteVector &data)
+  {
+    window.clear();
+
+    if(!moveHandle(offset, true))
+      return 0;
+
+    const size_t count = writeFile(file, data);
+
+    size = std::max(size, offset + static_cast<long>(count));
+
+    if(count < data.size())
+      filePosition = -1;
+    else
+      filePosition += static_cast<long>(count);
+
+    return count;
   }
 
   FileHandle file;
   FileNameHandle name;
   bool readOnly;
+
+  // The file length, kept up to date by our own writes.
+  long size;
+
+  // The get pointer.  It is only applied to the file handle on demand.
+  long position;
+
+  // Position of the file handle, or -1 if it is not known.
+  long filePosition;
+  bool writing;
+
+  // Data read ahead of the get pointer, starting at windowOffset.
+  ByteVector window;
+  long windowOffset;
+  unsigned int readAheadSize;
+
+  ReadAheadStatistics statistics;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -155,6 +331,13 @@ FileStream::FileStream(FileName fileName, bool openReadOnly)
 # else
     debug("Could not open file " + String(static_cast<const char *>(d->name)));
 # endif
+    return;
+  }
+
+  d->size = fileLength(d->file);
+  if(d->size < 0) {
+    debug("FileStream::FileStream() -- Failed to get the file size.");
+    d->size = 0;
   }
 }
 
@@ -181,15 +364,106 @@ ByteVector FileStream::readBlock(unsigned long length)
   if(length == 0)
     return ByteVector();
 
+  d->statistics.readCalls++;
+
   const unsigned long streamLength = static_cast<unsigned long>(FileStream::length());
   if(length > bufferSize() && length > streamLength)
     length = streamLength;
 
   ByteVector buffer(static_cast<unsigned int>(length));
+  char *data = buffer.data();
+
+  // Take as much as possible from the read-ahead window.
+
+  size_t count = 0;
+
+  const long windowEnd = d->windowOffset + static_cast<long>(d->window.size());
+  if(d->position >= d->windowOffset && d->position < windowEnd) {
+    count = std::min<size_t>(length, windowEnd - d->position);
+    ::memcpy(data, d->window.data() + (d->position - d->windowOffset), count);
+  }
+
+  if(count == length) {
+    d->statistics.bufferedReads++;
+  }
+  else if(count > 0 && d->window.size() < d->readAheadSize) {
+    // The window was short, so it already reaches the end of the file.
+  }
+  else {
+    const long offset = d->position + static_cast<long>(count);
+    const size_t remaining = length - count;
+
+    if(remaining < d->readAheadSize) {
+
+      // Refill the window from the first byte that is still missing.
+
+      d->window.resize(d->readAheadSize);
+      d->window.resize(static_cast<unsigned int>(d->readAt(offset, d->window.data(), d->readAheadSize)));
+      d->windowOffset = offset;
+
+      const size_t n = std::min<size_t>(remaining, d->window.size());
+      ::memcpy(data + count, d->window.data(), n);
+      count += n;
+    }
+    else {
+      count += d->readAt(offset, data + count, remaining);
+    }
+  }
 
-  const size_t count = readFile(d->file, buffer);
   buffer.resize(static_cast<unsigned int>(count));
+  d->position += static_cast<long>(count);
+
+  return buffer;
+}
+
+ByteVector FileStream::readBlocks(const List<Range> &ranges)
+{
+  if(!isOpen()) {
+    debug("FileStream::readBlocks() -- invalid file.");
+    return ByteVector();
+  }
+
+  // Clamp the blocks to the end of the file first, so that a bogus length
+  // doesn't make us allocate more than the file could ever deliver.
+
+  const long streamLength = FileStream::length();
+
+  List<Range> blocks;
+  unsigned long totalLength = 0;
+
+  for(List<Range>::ConstIterator it = ranges.begin(); it != ranges.end(); ++it) {
+    if(it->offset < 0 || it->offset > streamLength)
+      break;
+
+    const unsigned long available = static_cast<unsigned long>(streamLength - it->offset);
+    blocks.append(Range(it->offset, std::min(it->length, available)));
+    totalLength += blocks.back().length;
+
+    if(it->length > available)
+      break;
+  }
+
+  ByteVector buffer(static_cast<unsigned int>(totalLength));
+  char *data = buffer.data();
+
+#ifndef _WIN32
+  fflush(d->file);
+#endif
+
+  size_t count = 0;
+  for(List<Range>::ConstIterator it = blocks.begin(); it != blocks.end(); ++it) {
+    const size_t n = readFileAt(d->file, data + count, it->length, it->offset);
+    count += n;
+
+    if(n < it->length)
+      break;
+  }
+
+#ifdef _WIN32
+  d->filePosition = -1;
+#endif
 
+  buffer.resize(static_cast<unsigned int>(count));
   return buffer;
 }
 
@@ -205,7 +479,7 @@ void FileStream::writeBlock(const ByteVector &data)
     return;
   }
 
-  writeFile(d->file, data);
+  d->position += static_cast<long>(d->writeAt(d->position, data));
 }
 
 void FileStream::insert(const ByteVector &data, unsigned long start, unsigned long replace)
@@ -257,25 +531,18 @@ void FileStream::insert(const ByteVector &data, unsigned long start, unsigned lo
 
   while(true)
   {
-    // Seek to the current read position and read the data that we're about
-    // to overwrite.  Appropriately increment the readPosition.
+    // Read the data that we're about to overwrite.  Appropriately increment
+    // the readPosition.
 
-    seek(readPosition);
-    const unsigned int bytesRead = static_cast<unsigned int>(readFile(d->file, aboutToOverwrite));
+    aboutToOverwrite.resize(static_cast<unsigned int>(bufferLength));
+    const unsigned int bytesRead = static_cast<unsigned int>(
+      d->readAt(readPosition, aboutToOverwrite.data(), bufferLength));
     aboutToOverwrite.resize(bytesRead);
     readPosition += bufferLength;
 
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < bufferLength)
-      clear();
-
-    // Seek to the write position and write our buffer.  Increment the
-    // writePosition.
+    // Write our buffer at the write position.
 
-    seek(writePosition);
-    writeBlock(buffer);
+    d->writeAt(writePosition, buffer);
 
     // We hit the end of the file.
 
@@ -288,6 +555,8 @@ void FileStream::insert(const ByteVector &data, unsigned long start, unsigned lo
 
     buffer = aboutToOverwrite;
   }
+
+  d->position = writePosition + buffer.size();
 }
 
 void FileStream::removeBlock(unsigned long start, unsigned long length)
@@ -306,24 +575,17 @@ void FileStream::removeBlock(unsigned long start, unsigned long length)
 
   for(unsigned int bytesRead = -1; bytesRead != 0;)
   {
-    seek(readPosition);
-    bytesRead = static_cast<unsigned int>(readFile(d->file, buffer));
+    buffer.resize(static_cast<unsigned int>(bufferLength));
+    bytesRead = static_cast<unsigned int>(d->readAt(readPosition, buffer.data(), bufferLength));
     readPosition += bytesRead;
 
-    // Check to see if we just read the last block.  We need to call clear()
-    // if we did so that the last write succeeds.
-
-    if(bytesRead < buffer.size()) {
-      clear();
-      buffer.resize(bytesRead);
-    }
-
-    seek(writePosition);
-    writeFile(d->file, buffer);
+    buffer.resize(bytesRead);
+    d->writeAt(writePosition, buffer);
 
     writePosition += bytesRead;
   }
 
+  d->position = writePosition;
   truncate(writePosition);
 }
 
@@ -344,41 +606,31 @@ void FileStream::seek(long offset, Position p)
     return;
   }
 
-#ifdef _WIN32
+  // Only the get pointer is moved here; the file handle follows on the next
+  // access that can not be served from the read-ahead window.
 
-  if(p != Beginning && p != Current && p != End) {
-    debug("FileStream::seek() -- Invalid Position value.");
-    return;
-  }
-
-  LARGE_INTEGER liOffset;
-  liOffset.QuadPart = offset;
-
-  if(!SetFilePointerEx(d->file, liOffset, NULL, static_cast<DWORD>(p))) {
-    debug("FileStream::seek() -- Failed to set the file pointer.");
-  }
-
-#else
-
-  int whence;
+  long position;
   switch(p) {
   case Beginning:
-    whence = SEEK_SET;
+    position = offset;
     break;
   case Current:
-    whence = SEEK_CUR;
+    position = d->position + offset;
     break;
   case End:
-    whence = SEEK_END;
+    position = length() + offset;
     break;
   default:
     debug("FileStream::seek() -- Invalid Position value.");
     return;
   }
 
-  fseek(d->file, offset, whence);
+  d->statistics.seekCalls++;
 
-#endif
+  // Like fseek(), refuse to move in front of the beginning of the file.
+
+  if(position >= 0)
+    d->position = position;
 }
 
 void FileStream::clear()
@@ -396,24 +648,7 @@ void FileStream::clear()
 
 long FileStream::tell() const
 {
-#ifdef _WIN32
-
-  const LARGE_INTEGER zero = {};
-  LARGE_INTEGER position;
-
-  if(SetFilePointerEx(d->file, zero, &position, FILE_CURRENT) && position.QuadPart <= LONG_MAX) {
-    return static_cast<long>(position.QuadPart);
-  }
-  else {
-    debug("FileStream::tell() -- Failed to get the file pointer.");
-    return 0;
-  }
-
-#else
-
-  return ftell(d->file);
-
-#endif
+  return d->position;
 }
 
 long FileStream::length()
@@ -423,30 +658,26 @@ long FileStream::length()
     return 0;
   }
 
-#ifdef _WIN32
-
-  LARGE_INTEGER fileSize;
+  // The length is taken once when opening the file and then only changed by
+  // writing through this stream, so this does not need any system calls.
 
-  if(GetFileSizeEx(d->file, &fileSize) && fileSize.QuadPart <= LONG_MAX) {
-    return static_cast<long>(fileSize.QuadPart);
-  }
-  else {
-    debug("FileStream::length() -- Failed to get the file size.");
-    return 0;
-  }
-
-#else
-
-  const long curpos = tell();
-
-  seek(0, End);
-  const long endpos = tell();
+  return d->size;
+}
 
-  seek(curpos, Beginning);
+void FileStream::setReadAheadSize(unsigned int size)
+{
+  d->readAheadSize = size;
+  d->window.clear();
+}
 
-  return endpos;
+unsigned int FileStream::readAheadSize() const
+{
+  return d->readAheadSize;
+}
 
-#endif
+FileStream::ReadAheadStatistics FileStream::readAheadStatistics() const
+{
+  return d->statistics;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -455,25 +686,33 @@ long FileStream::length()
 
 void FileStream::truncate(long length)
 {
-#ifdef _WIN32
+  d->window.clear();
 
-  const long currentPos = tell();
+#ifdef _WIN32
 
-  seek(length);
+  d->statistics.fileSeeks++;
+  d->filePosition = -1;
 
-  if(!SetEndOfFile(d->file)) {
+  if(!seekFile(d->file, length, Beginning) || !SetEndOfFile(d->file)) {
     debug("FileStream::truncate() -- Failed to truncate the file.");
+    return;
   }
 
-  seek(currentPos);
+  d->filePosition = length;
+  d->size = length;
 
 #else
 
+  fflush(d->file);
+
   const int error = ftruncate(fileno(d->file), length);
   if(error != 0) {
     debug("FileStream::truncate() -- Coundn't truncate the file.");
+    return;
   }
 
+  d->size = length;
+
 #endif
 }
 
@@ -48,6 +48,23 @@ namespace TagLib {
   class TAGLIB_EXPORT FileStream : public IOStream
   {
   public:
+    /*!
+     * Counters that show how much work the read-ahead window saved.
+     */
+    struct ReadAheadStatistics
+    {
+      //! Number of readBlock() calls
+      unsigned long long readCalls;
+      //! Number of readBlock() calls served entirely from the window
+      unsigned long long bufferedReads;
+      //! Number of reads issued on the file handle
+      unsigned long long fileReads;
+      //! Number of seek() calls
+      unsigned long long seekCalls;
+      //! Number of seeks issued on the file handle
+      unsigned long long fileSeeks;
+    };
+
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
      * be a C-string in the local file system encoding.
@@ -66,9 +83,17 @@ namespace TagLib {
 
     /*!
      * Reads a block of size \a length at the current get pointer.
+     *
+     * \see setReadAheadSize()
      */
     ByteVector readBlock(unsigned long length);
 
+    /*!
+     * Reads the blocks described by \a ranges with positioned reads, so the
+     * current get pointer is left alone and no seeks are issued.
+     */
+    ByteVector readBlocks(const List<Range> &ranges);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -128,7 +153,9 @@ namespace TagLib {
     long tell() const;
 
     /*!
-     * Returns the length of the file.
+     * Returns the length of the file.  This is read once when the file is
+     * opened and then kept up to date by the writes through this stream, so
+     * changes made to the file from elsewhere are not seen.
      */
     long length();
 
@@ -137,6 +164,27 @@ namespace TagLib {
      */
     void truncate(long length);
 
+    /*!
+     * Sets the size of the read-ahead window to \a size bytes.  Reads shorter
+     * than this are served from a window that is filled with a single read
+     * from the file, so that runs of small reads and seeks within the window
+     * don't cause any system calls.  Writing to the file discards the window.
+     * A size of 0 disables read-ahead.
+     */
+    void setReadAheadSize(unsigned int size);
+
+    /*!
+     * Returns the size of the read-ahead window.
+     *
+     * \see setReadAheadSize()
+     */
+    unsigned int readAheadSize() const;
+
+    /*!
+     * Returns the read-ahead counters of this stream.
+     */
+    ReadAheadStatistics readAheadStatistics() const;
+
   protected:
 
     /*!
@@ -108,6 +108,27 @@ IOStream::~IOStream()
 {
 }
 
+ByteVector IOStream::readBlocks(const List<Range> &ranges)
+{
+  const long position = tell();
+
+  ByteVector data;
+
+  for(List<Range>::ConstIterator it = ranges.begin(); it != ranges.end(); ++it) {
+    seek(it->offset);
+    const ByteVector block = readBlock(it->length);
+    data.append(block);
+
+    if(block.size() < it->length)
+      break;
+  }
+
+  clear();
+  seek(position);
+
+  return data;
+}
+
 void IOStream::clear()
 {
 }
@@ -29,6 +29,7 @@
 #include "taglib_export.h"
 #include "taglib.h"
 #include "tbytevector.h"
+#include "tlist.h"
 
 namespace TagLib {
 
@@ -74,6 +75,19 @@ namespace TagLib {
       End
     };
 
+    /*!
+     * A block of \a length bytes starting at \a offset in the stream.
+     *
+     * \see readBlocks()
+     */
+    struct Range {
+      Range(long offset = 0, unsigned long length = 0) :
+        offset(offset), length(length) {}
+
+      long offset;
+      unsigned long length;
+    };
+
     IOStream();
 
     /*!
@@ -91,6 +105,21 @@ namespace TagLib {
      */
     virtual ByteVector readBlock(unsigned long length) = 0;
 
+    /*!
+     * Reads the blocks described by \a ranges and returns them concatenated in
+     * a single ByteVector.  The current get pointer is neither used nor moved.
+     *
+     * Reading stops at the first block that can't be read completely, so the
+     * result is shorter than the sum of the lengths if a block extends past the
+     * end of the stream.
+     *
+     * The default implementation seeks to and reads each block in turn.
+     * Subclasses may reimplement this to issue the reads as a batch.
+     */
+    // BIC: new virtual function, changes the vtable of IOStream and of every
+    // subclass, so code built against older headers has to be rebuilt.
+    virtual ByteVector readBlocks(const List<Range> &ranges);
+
     /*!
      * Attempts to write the block \a data at the current get pointer.  If the
      * file is currently only opened read only -- i.e. readOnly() returns true --
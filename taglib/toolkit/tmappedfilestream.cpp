@@ -0,0 +1,329 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <climits>
+
+#include "tmappedfilestream.h"
+#include "tstring.h"
+#include "tdebug.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <string>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+#ifdef _WIN32
+
+  typedef FileName FileNameHandle;
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = 0;
+
+  // Maps the whole file.  The view keeps the file and the mapping object
+  // alive, so both handles can be closed right away.  Windows refuses to
+  // truncate a file while a view of it exists, so the mapping can not shrink.
+
+  bool mapFile(const FileName &path, FileHandle &, const char *&data, size_t &size)
+  {
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+    const HANDLE file = CreateFile2(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL);
+#else
+    const HANDLE file = CreateFileW(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+#endif
+    if(file == INVALID_HANDLE_VALUE)
+      return false;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart > LONG_MAX) {
+      CloseHandle(file);
+      return false;
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+    data = 0;
+
+    if(size > 0) {
+      const HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if(mapping) {
+        data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+      }
+    }
+
+    CloseHandle(file);
+    return (size == 0 || data != 0);
+  }
+
+  void unmapFile(FileHandle, const char *data, size_t)
+  {
+    if(data)
+      UnmapViewOfFile(data);
+  }
+
+  size_t backedSize(FileHandle, size_t size)
+  {
+    return size;
+  }
+
+#else   // _WIN32
+
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+
+  typedef int FileHandle;
+
+  const FileHandle InvalidFileHandle = -1;
+
+  // Maps the whole file.  The descriptor is kept open to check the size of the
+  // file before each read, see backedSize().
+
+  bool mapFile(const FileName &path, FileHandle &fd, const char *&data, size_t &size)
+  {
+    fd = open(path, O_RDONLY);
+    if(fd < 0)
+      return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+       static_cast<unsigned long long>(st.st_size) > static_cast<unsigned long long>(LONG_MAX)) {
+      close(fd);
+      fd = InvalidFileHandle;
+      return false;
+    }
+
+    size = static_cast<size_t>(st.st_size);
+    data = 0;
+
+    if(size > 0) {
+      void *mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(mapping != MAP_FAILED)
+        data = static_cast<const char *>(mapping);
+    }
+
+    return (size == 0 || data != 0);
+  }
+
+  void unmapFile(FileHandle fd, const char *data, size_t size)
+  {
+    if(data)
+      munmap(const_cast<char *>(data), size);
+
+    if(fd >= 0)
+      close(fd);
+  }
+
+  // Returns how much of a mapping of \a size bytes is still backed by the
+  // file.  Touching a mapped page past the end of a file that was truncated by
+  // someone else raises SIGBUS instead of returning an error.
+
+  size_t backedSize(FileHandle fd, size_t size)
+  {
+    struct stat st;
+    if(fstat(fd, &st) != 0)
+      return 0;
+
+    return std::min<size_t>(size, static_cast<size_t>(st.st_size));
+  }
+
+#endif  // _WIN32
+}
+
+class MappedFileStream::MappedFileStreamPrivate
+{
+public:
+  MappedFileStreamPrivate(const FileName &fileName) :
+    name(fileName),
+    open(false),
+    file(InvalidFileHandle),
+    data(0),
+    size(0),
+    position(0) {}
+
+  FileNameHandle name;
+  bool open;
+  FileHandle file;
+  const char *data;
+  size_t size;
+  long position;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFileStream::MappedFileStream(FileName fileName) :
+  d(new MappedFileStreamPrivate(fileName))
+{
+  d->open = mapFile(fileName, d->file, d->data, d->size);
+
+  if(!d->open) {
+# ifdef _WIN32
+    debug("Could not map file " + fileName.toString());
+# else
+    debug("Could not map file " + String(static_cast<const char *>(d->name)));
+# endif
+  }
+}
+
+MappedFileStream::~MappedFileStream()
+{
+  unmapFile(d->file, d->data, d->size);
+
+  delete d;
+}
+
+FileName MappedFileStream::name() const
+{
+  return d->name;
+}
+
+ByteVector MappedFileStream::readBlock(unsigned long length)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::readBlock() -- invalid file.");
+    return ByteVector();
+  }
+
+  if(length == 0 || d->position < 0 || static_cast<size_t>(d->position) >= d->size)
+    return ByteVector();
+
+  const size_t size = backedSize(d->file, d->size);
+  if(static_cast<size_t>(d->position) >= size)
+    return ByteVector();
+
+  length = static_cast<unsigned long>(std::min<size_t>(length, size - d->position));
+
+  ByteVector buffer(d->data + d->position, static_cast<unsigned int>(length));
+  d->position += length;
+
+  return buffer;
+}
+
+ByteVector MappedFileStream::readBlocks(const List<Range> &ranges)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::readBlocks() -- invalid file.");
+    return ByteVector();
+  }
+
+  const size_t size = backedSize(d->file, d->size);
+
+  ByteVector buffer;
+
+  for(List<Range>::ConstIterator it = ranges.begin(); it != ranges.end(); ++it) {
+    if(it->offset < 0 || static_cast<size_t>(it->offset) > size)
+      break;
+
+    const size_t available = size - it->offset;
+    const size_t length = std::min<size_t>(it->length, available);
+    buffer.append(ByteVector(d->data + it->offset, static_cast<unsigned int>(length)));
+
+    if(it->length > available)
+      break;
+  }
+
+  return buffer;
+}
+
+void MappedFileStream::writeBlock(const ByteVector &)
+{
+  debug("MappedFileStream::writeBlock() -- read only file.");
+}
+
+void MappedFileStream::insert(const ByteVector &, unsigned long, unsigned long)
+{
+  debug("MappedFileStream::insert() -- read only file.");
+}
+
+void MappedFileStream::removeBlock(unsigned long, unsigned long)
+{
+  debug("MappedFileStream::removeBlock() -- read only file.");
+}
+
+bool MappedFileStream::readOnly() const
+{
+  return true;
+}
+
+bool MappedFileStream::isOpen() const
+{
+  return d->open;
+}
+
+void MappedFileStream::seek(long offset, Position p)
+{
+  if(!isOpen()) {
+    debug("MappedFileStream::seek() -- invalid file.");
+    return;
+  }
+
+  long position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    position = static_cast<long>(d->size) + offset;
+    break;
+  default:
+    debug("MappedFileStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  // Like fseek(), refuse to move in front of the beginning of the file.
+
+  if(position >= 0)
+    d->position = position;
+}
+
+void MappedFileStream::clear()
+{
+}
+
+long MappedFileStream::tell() const
+{
+  return d->position;
+}
+
+long MappedFileStream::length()
+{
+  return static_cast<long>(d->size);
+}
+
+void MappedFileStream::truncate(long)
+{
+  debug("MappedFileStream::truncate() -- read only file.");
+}
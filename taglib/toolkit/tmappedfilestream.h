@@ -0,0 +1,141 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MAPPEDFILESTREAM_H
+#define TAGLIB_MAPPEDFILESTREAM_H
+
+#include "taglib_export.h"
+#include "taglib.h"
+#include "tbytevector.h"
+#include "tiostream.h"
+
+namespace TagLib {
+
+  //! A read only stream over a memory mapped file
+
+  /*!
+   * This maps the whole file into memory once and serves all reads straight
+   * from the mapping, so there is no stdio buffer in between and a read
+   * costs one fstat() at most.  It is meant for scanning files; the file can
+   * not be modified through this stream.
+   *
+   * \warning The file must not be truncated by another process while this
+   * stream is open.  On POSIX systems touching a mapped page past the new end
+   * of the file raises SIGBUS, which kills the process unless it is handled.
+   * Each read checks the current size of the file and stops at its end, which
+   * narrows the window but can not close it: the file may still shrink while
+   * the bytes are copied.  Use FileStream for files that other processes may
+   * rewrite.  Windows does not allow truncating a mapped file.
+   *
+   * \note ByteVector always owns its storage, so each read still copies the
+   * requested bytes out of the mapping.
+   */
+
+  class TAGLIB_EXPORT MappedFileStream : public IOStream
+  {
+  public:
+    /*!
+     * Opens and maps the file \a file.  \a file should be a C-string in the
+     * local file system encoding.  Check isOpen() to see if this succeeded.
+     */
+    MappedFileStream(FileName file);
+
+    /*!
+     * Unmaps and closes the file.
+     */
+    virtual ~MappedFileStream();
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(unsigned long length);
+
+    /*!
+     * Copies the blocks described by \a ranges out of the mapping.  The get
+     * pointer is not used or moved.
+     */
+    ByteVector readBlocks(const List<Range> &ranges);
+
+    /*!
+     * Not supported; the stream is always read only.
+     */
+    void writeBlock(const ByteVector &data);
+
+    /*!
+     * Not supported; the stream is always read only.
+     */
+    void insert(const ByteVector &data, unsigned long start = 0, unsigned long replace = 0);
+
+    /*!
+     * Not supported; the stream is always read only.
+     */
+    void removeBlock(unsigned long start = 0, unsigned long length = 0);
+
+    /*!
+     * Returns true.
+     */
+    bool readOnly() const;
+
+    /*!
+     * Returns true if the file could be opened and mapped.
+     */
+    bool isOpen() const;
+
+    /*!
+     * Move the I/O pointer to \a offset in the file from position \a p.  This
+     * defaults to seeking from the beginning of the file.
+     *
+     * \see Position
+     */
+    void seek(long offset, Position p = Beginning);
+
+    /*!
+     * Does nothing; there are no end-of-file or error flags to reset.
+     */
+    void clear();
+
+    /*!
+     * Returns the current offset within the file.
+     */
+    long tell() const;
+
+    /*!
+     * Returns the length of the file at the time it was mapped.
+     */
+    long length();
+
+    /*!
+     * Not supported; the stream is always read only.
+     */
+    void truncate(long length);
+
+  private:
+    class MappedFileStreamPrivate;
+    MappedFileStreamPrivate *d;
+  };
+
+}
+
+#endif
@@ -0,0 +1,199 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include <string.h>
+
+#include <tfile.h>
+#include <tdebug.h>
+#include <trefcounter.h>
+
+#include "tpicturehandle.h"
+
+using namespace TagLib;
+
+class PictureHandle::PictureHandlePrivate : public RefCounter
+{
+public:
+  PictureHandlePrivate() :
+    type(-1),
+    width(0),
+    height(0),
+    file(0),
+    offset(-1),
+    size(0) {}
+
+  ~PictureHandlePrivate()
+  {
+    File::releaseReference(file);
+  }
+
+  String mimeType;
+  int type;
+  String description;
+  int width;
+  int height;
+
+  File::FileReference *file;
+  long long offset;
+  unsigned int size;
+  ByteVector data;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+PictureHandle::PictureHandle() :
+  d(new PictureHandlePrivate())
+{
+}
+
+PictureHandle::PictureHandle(const ByteVector &data, const String &mimeType,
+                             int type, const String &description) :
+  d(new PictureHandlePrivate())
+{
+  d->mimeType    = mimeType;
+  d->type        = type;
+  d->description = description;
+  d->size        = data.size();
+  d->data        = data;
+}
+
+PictureHandle::PictureHandle(File *file, long long offset, unsigned int size,
+                             const String &mimeType, int type, const String &description) :
+  d(new PictureHandlePrivate())
+{
+  d->mimeType    = mimeType;
+  d->type        = type;
+  d->description = description;
+  d->file        = file ? file->reference() : 0;
+  d->offset      = offset;
+  d->size        = size;
+}
+
+PictureHandle::PictureHandle(const PictureHandle &handle) :
+  d(handle.d)
+{
+  d->ref();
+}
+
+PictureHandle::~PictureHandle()
+{
+  if(d->deref())
+    delete d;
+}
+
+PictureHandle &PictureHandle::operator=(const PictureHandle &handle)
+{
+  if(&handle == this)
+    return *this;
+
+  if(d->deref())
+    delete d;
+
+  d = handle.d;
+  d->ref();
+  return *this;
+}
+
+bool PictureHandle::isNull() const
+{
+  return !d->file && d->data.isEmpty();
+}
+
+String PictureHandle::mimeType() const
+{
+  return d->mimeType;
+}
+
+int PictureHandle::type() const
+{
+  return d->type;
+}
+
+String PictureHandle::description() const
+{
+  return d->description;
+}
+
+int PictureHandle::width() const
+{
+  return d->width;
+}
+
+int PictureHandle::height() const
+{
+  return d->height;
+}
+
+void PictureHandle::setDimensions(int width, int height)
+{
+  d->width  = width;
+  d->height = height;
+}
+
+long long PictureHandle::offset() const
+{
+  return d->file ? d->offset : -1;
+}
+
+unsigned int PictureHandle::size() const
+{
+  return d->size;
+}
+
+ByteVector PictureHandle::data() const
+{
+  return data(0, d->size);
+}
+
+ByteVector PictureHandle::data(unsigned int position, unsigned int length) const
+{
+  if(position >= d->size)
+    return ByteVector();
+
+  if(length > d->size - position)
+    length = d->size - position;
+
+  if(!d->file)
+    return d->data.mid(position, length);
+
+  File *file = File::referencedFile(d->file);
+  if(!file) {
+    debug("PictureHandle::data() -- The file was changed or destroyed.");
+    return ByteVector();
+  }
+
+  if(!file->isOpen()) {
+    debug("PictureHandle::data() -- The file is closed.");
+    return ByteVector();
+  }
+
+  file->seek(d->offset + position);
+  return file->readBlock(length);
+}
+
+unsigned int PictureHandle::read(unsigned int position, char *buffer, unsigned int length) const
+{
+  const ByteVector block = data(position, length);
+  if(!block.isEmpty())
+    ::memcpy(buffer, block.data(), block.size());
+  return block.size();
+}
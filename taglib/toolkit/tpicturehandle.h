@@ -0,0 +1,174 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#ifndef TAGLIB_PICTUREHANDLE_H
+#define TAGLIB_PICTUREHANDLE_H
+
+#include "taglib_export.h"
+#include "tlist.h"
+#include "tstring.h"
+#include "tbytevector.h"
+
+namespace TagLib {
+
+  class File;
+
+  //! A reference to an embedded picture that is read on demand
+
+  /*!
+   * A picture handle describes a picture embedded in a file -- its MIME type,
+   * picture type, description and, where the container records them, its
+   * dimensions -- together with the position of the image data in the file.
+   * The image data is only read when data() or read() is called, so listing
+   * the artwork of a file costs no more than reading the metadata around it,
+   * and parts of an image can be served with range reads.
+   *
+   * Pictures whose data is not stored as-is in the file (e.g. compressed
+   * ID3v2 frames) and pictures which were already read are held in memory
+   * instead; offset() is -1 for those.
+   *
+   * A file backed handle is only good for as long as the File it came from
+   * is open and unchanged.  Once that File is destroyed or written to, for
+   * example by save(), data() and read() return nothing; get new handles from
+   * the File after saving it.
+   *
+   * \warning The handles of a File must not be used from another thread
+   * while the File is in use, as reading the data moves the position of the
+   * File.
+   */
+
+  class TAGLIB_EXPORT PictureHandle
+  {
+  public:
+    /*!
+     * Constructs a null handle.
+     */
+    PictureHandle();
+
+    /*!
+     * Constructs a handle for the image \a data held in memory.
+     */
+    PictureHandle(const ByteVector &data, const String &mimeType = String(),
+                  int type = -1, const String &description = String());
+
+    /*!
+     * Constructs a handle for the \a size bytes of image data at \a offset in
+     * \a file.  The handle stops working when \a file is written to or
+     * destroyed.
+     */
+    PictureHandle(File *file, long long offset, unsigned int size,
+                  const String &mimeType = String(), int type = -1,
+                  const String &description = String());
+
+    /*!
+     * Does a shallow copy of \a handle.
+     */
+    PictureHandle(const PictureHandle &handle);
+
+    /*!
+     * Destroys this PictureHandle instance.
+     */
+    virtual ~PictureHandle();
+
+    /*!
+     * Makes a shallow copy of \a handle.
+     */
+    PictureHandle &operator=(const PictureHandle &handle);
+
+    /*!
+     * Returns true if the handle doesn't refer to a picture.
+     */
+    bool isNull() const;
+
+    /*!
+     * Returns the MIME type of the image, or an empty string if the container
+     * doesn't record one.
+     */
+    String mimeType() const;
+
+    /*!
+     * Returns the picture type, using the values shared by ID3v2, FLAC and
+     * ASF (e.g. 3 for the front cover), or -1 if the container doesn't record
+     * one.
+     *
+     * \see FLAC::Picture::Type
+     */
+    int type() const;
+
+    /*!
+     * Returns the description of the picture.
+     */
+    String description() const;
+
+    /*!
+     * Returns the width of the image in pixels, or 0 if it is not known.
+     */
+    int width() const;
+
+    /*!
+     * Returns the height of the image in pixels, or 0 if it is not known.
+     */
+    int height() const;
+
+    /*!
+     * Sets the dimensions of the image to \a width by \a height pixels.
+     */
+    void setDimensions(int width, int height);
+
+    /*!
+     * Returns the position of the image data in the file, or -1 if the data
+     * is held in memory.
+     */
+    long long offset() const;
+
+    /*!
+     * Returns the size of the image data in bytes.
+     */
+    unsigned int size() const;
+
+    /*!
+     * Returns the image data.  For a file backed handle this reads it from
+     * the file on every call, and returns an empty ByteVector if the file was
+     * changed or destroyed since the handle was made.
+     */
+    ByteVector data() const;
+
+    /*!
+     * Returns at most \a length bytes of the image data starting at
+     * \a position.
+     */
+    ByteVector data(unsigned int position, unsigned int length) const;
+
+    /*!
+     * Copies at most \a length bytes of the image data starting at
+     * \a position to \a buffer and returns the number of bytes copied.
+     */
+    unsigned int read(unsigned int position, char *buffer, unsigned int length) const;
+
+  private:
+    class PictureHandlePrivate;
+    PictureHandlePrivate *d;
+  };
+
+  typedef List<PictureHandle> PictureHandleList;
+
+}
+
+#endif
@@ -77,38 +77,38 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-TrueAudio::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+TrueAudio::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                      bool readProperties, Properties::ReadStyle) :
+                      bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                      bool readProperties, Properties::ReadStyle) :
+                      bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::~File()
@@ -156,6 +156,16 @@ bool TrueAudio::File::save()
     return false;
   }
 
+  // A lazy signature has to be taken before the audio data is moved.
+
+  if(d->properties)
+    d->properties->signature();
+
+  // Frames skipped by the ID3v2 frame filter are read before anything moves.
+
+  if(ID3v2Tag())
+    ID3v2Tag()->readSkippedFrames();
+
   // Update ID3v2 tag
 
   if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
@@ -253,7 +263,7 @@ bool TrueAudio::File::hasID3v2Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void TrueAudio::File::read(bool readProperties)
+void TrueAudio::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -293,6 +303,6 @@ void TrueAudio::File::read(bool readProperties)
       seek(0);
     }
 
-    d->properties = new Properties(readBlock(TrueAudio::HeaderSize), streamLength);
+    d->properties = new Properties(this, streamLength, propertiesStyle);
   }
 }
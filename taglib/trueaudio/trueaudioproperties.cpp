@@ -33,6 +33,7 @@
 
 #include "trueaudioproperties.h"
 #include "trueaudiofile.h"
+#include <roon_taglib_utils.h>
 
 using namespace TagLib;
 
@@ -55,6 +56,7 @@ public:
   int channels;
   int bitsPerSample;
   unsigned int sampleFrames;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +70,15 @@ TrueAudio::Properties::Properties(const ByteVector &data, long streamLength, Rea
   read(data, streamLength);
 }
 
+TrueAudio::Properties::Properties(File *file, long streamLength, ReadStyle style) :
+  AudioProperties(style),
+  d(new PropertiesPrivate())
+{
+  const long streamOffset = file->tell();
+  read(file->readBlock(TrueAudio::HeaderSize), streamLength);
+  d->signature.setRegion(file, streamOffset, streamLength, style);
+}
+
 TrueAudio::Properties::~Properties()
 {
   delete d;
@@ -118,6 +129,11 @@ int TrueAudio::Properties::ttaVersion() const
   return d->version;
 }
 
+ByteVector TrueAudio::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // private members
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,13 @@ namespace TagLib {
        */
       Properties(const ByteVector &data, long streamLength, ReadStyle style = Average);
 
+      /*!
+       * Create an instance of TrueAudio::Properties with the data read from the
+       * TrueAudio::File \a file, which is positioned at the start of the
+       * \a streamLength bytes of the stream.
+       */
+      Properties(File *file, long streamLength, ReadStyle style = Average);
+
       /*!
        * Destroys this TrueAudio::Properties instance.
        */
@@ -118,6 +125,11 @@ namespace TagLib {
        */
       int ttaVersion() const;
 
+      /*!
+       * Returns the SHA1 signature of the audio stream
+       */
+      virtual ByteVector signature() const;
+
     private:
       Properties(const Properties &);
       Properties &operator=(const Properties &);
@@ -75,20 +75,20 @@ public:
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(new FilePrivate())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 WavPack::File::~File()
@@ -232,7 +232,7 @@ bool WavPack::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void WavPack::File::read(bool readProperties)
+void WavPack::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v1 tag
 
@@ -267,6 +267,6 @@ void WavPack::File::read(bool readProperties)
     else
       streamLength = length();
 
-    d->properties = new Properties(this, streamLength);
+    d->properties = new Properties(this, streamLength, propertiesStyle);
   }
 }
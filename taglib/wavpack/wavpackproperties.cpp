@@ -32,6 +32,7 @@
 
 #include "wavpackproperties.h"
 #include "wavpackfile.h"
+#include <roon_taglib_utils.h>
 
 // Implementation of this class is based on the information at:
 // http://www.wavpack.com/file_format.txt
@@ -59,6 +60,7 @@ public:
   int bitsPerSample;
   bool lossless;
   unsigned int sampleFrames;
+  TaglibSignature signature;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +79,7 @@ WavPack::Properties::Properties(File *file, long streamLength, ReadStyle style)
   d(new PropertiesPrivate())
 {
   read(file, streamLength);
+  d->signature.setRegion(file, 0, streamLength, style);
 }
 
 WavPack::Properties::~Properties()
@@ -119,6 +122,11 @@ int WavPack::Properties::version() const
   return d->version;
 }
 
+ByteVector WavPack::Properties::signature() const
+{
+  return d->signature.value();
+}
+
 int WavPack::Properties::bitsPerSample() const
 {
   return d->bitsPerSample;
@@ -49,6 +49,7 @@ class TestAPE : public CppUnit::TestFixture
   CPPUNIT_TEST(testFuzzedFile2);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -186,6 +187,39 @@ public:
     }
   }
 
+  void testSignature()
+  {
+    ScopedFileCopy copy("mac-399", ".ape");
+    ByteVector signature;
+    long audioByte;
+    {
+      APE::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() / 2;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      APE::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.
+      APE::File f(copy.fileName().c_str(), true,
+                  AudioProperties::Average | AudioProperties::LazySignature);
+      f.APETag(true)->setTitle("Title");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      APE::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestAPE);
@@ -51,6 +51,8 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testSaveMultiplePictures);
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testLazyPicture);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -319,6 +321,90 @@ public:
     }
   }
 
+  void testLazyPicture()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+    string newname = copy.fileName();
+
+    {
+      ASF::File f(newname.c_str());
+      ASF::Picture picture;
+      picture.setMimeType("image/jpeg");
+      picture.setType(ASF::Picture::FrontCover);
+      picture.setDescription("description");
+      picture.setPicture(ByteVector(64 * 1024, 'x'));
+      f.tag()->setAttribute("WM/Picture", picture);
+      f.save();
+    }
+    {
+      ASF::File f(newname.c_str(), true,
+                  AudioProperties::Average | AudioProperties::NoSignature | AudioProperties::LazyTags);
+      CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 32 * 1024);
+      ASF::Picture picture = f.tag()->attribute("WM/Picture").front().toPicture();
+      CPPUNIT_ASSERT(picture.isValid());
+      CPPUNIT_ASSERT(picture.handle().offset() > 0);
+      CPPUNIT_ASSERT_EQUAL(64U * 1024, picture.handle().size());
+      CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), picture.handle().mimeType());
+      CPPUNIT_ASSERT_EQUAL(String("description"), picture.handle().description());
+      CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), picture.handle().data());
+
+      f.tag()->setTitle("Title");
+      f.save();
+    }
+    {
+      ASF::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      ASF::Picture picture = f.tag()->attribute("WM/Picture").front().toPicture();
+      CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), picture.picture());
+    }
+    {
+      // A copy that outlives the file has no image data.
+      ASF::Picture picture;
+      {
+        ASF::File f(newname.c_str(), true,
+                    AudioProperties::Average | AudioProperties::NoSignature | AudioProperties::LazyTags);
+        picture = f.tag()->attribute("WM/Picture").front().toPicture();
+      }
+      CPPUNIT_ASSERT(picture.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("image/jpeg"), picture.mimeType());
+      CPPUNIT_ASSERT(picture.handle().data().isEmpty());
+      CPPUNIT_ASSERT(picture.picture().isEmpty());
+    }
+  }
+
+  void testSignature()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+    ByteVector signature;
+    long audioByte;
+    {
+      ASF::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() / 2;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      ASF::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.
+      ASF::File f(copy.fileName().c_str(), true,
+                  AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setTitle(longText(64 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      ASF::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestASF);
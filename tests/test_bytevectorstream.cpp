@@ -39,6 +39,7 @@ class TestByteVectorStream : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveBlock);
   CPPUNIT_TEST(testInsert);
   CPPUNIT_TEST(testSeekEnd);
+  CPPUNIT_TEST(testReadBlocks);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -126,6 +127,24 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("b"), stream.readBlock(1));
   }
 
+  void testReadBlocks()
+  {
+    ByteVector v("abcdefghijklmnopqrstuvwxyz");
+    ByteVectorStream stream(v);
+    stream.seek(5);
+
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(0, 2));
+    ranges.append(IOStream::Range(20, 3));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abuvw"), stream.readBlocks(ranges));
+    CPPUNIT_ASSERT_EQUAL(5L, stream.tell());
+
+    ranges.append(IOStream::Range(24, 4));
+    ranges.append(IOStream::Range(2, 1));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abuvwyz"), stream.readBlocks(ranges));
+    CPPUNIT_ASSERT_EQUAL(5L, stream.tell());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestByteVectorStream);
@@ -24,6 +24,8 @@
  ***************************************************************************/
 
 #include <tfile.h>
+#include <tfilestream.h>
+#include <roon_taglib_utils.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -39,6 +41,14 @@ public:
   void truncate(long length) { File::truncate(length); }
 };
 
+namespace
+{
+  void traceRead(const File *, long offset, unsigned long length, void *userData)
+  {
+    static_cast<List<IOStream::Range> *>(userData)->append(IOStream::Range(offset, length));
+  }
+}
+
 class TestFile : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestFile);
@@ -46,6 +56,11 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST(testRFindInSmallFile);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testReadBlocks);
+  CPPUNIT_TEST(testReadAhead);
+  CPPUNIT_TEST(testReadAheadWrite);
+  CPPUNIT_TEST(testIOStatistics);
+  CPPUNIT_TEST(testReadTrace);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -148,6 +163,173 @@ public:
     }
   }
 
+  void testReadBlocks()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    PlainFile f(name.c_str());
+    f.seek(10);
+    ByteVector expected = f.readBlock(6);
+    f.seek(4000);
+    expected.append(f.readBlock(100));
+    f.seek(4300);
+    expected.append(f.readBlock(28));
+
+    f.seek(1234);
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(10, 6));
+    ranges.append(IOStream::Range(4000, 100));
+    ranges.append(IOStream::Range(4300, 28));
+    CPPUNIT_ASSERT_EQUAL(expected, f.readBlocks(ranges));
+    CPPUNIT_ASSERT_EQUAL(1234L, f.tell());
+
+    // Reading stops at the first block that runs past the end of the file.
+    ranges.clear();
+    ranges.append(IOStream::Range(10, 6));
+    ranges.append(IOStream::Range(4300, 100));
+    ranges.append(IOStream::Range(4000, 100));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)34, f.readBlocks(ranges).size());
+    CPPUNIT_ASSERT_EQUAL(1234L, f.tell());
+
+    // A signature is not taken from a short read.
+    CPPUNIT_ASSERT_EQUAL((unsigned int)20, taglib_make_signature(&f, 0, f.length()).size());
+    CPPUNIT_ASSERT(taglib_make_signature(&f, 0, f.length() + 1).isEmpty());
+  }
+
+  void testReadAhead()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    FileStream buffered(name.c_str(), true);
+    FileStream unbuffered(name.c_str(), true);
+    unbuffered.setReadAheadSize(0);
+    CPPUNIT_ASSERT_EQUAL(0U, unbuffered.readAheadSize());
+
+    for(long offset = 0; offset < 4328; offset += 97) {
+      buffered.seek(offset);
+      unbuffered.seek(offset);
+      CPPUNIT_ASSERT_EQUAL(unbuffered.readBlock(13), buffered.readBlock(13));
+      CPPUNIT_ASSERT_EQUAL(unbuffered.tell(), buffered.tell());
+    }
+
+    // A large read is only partly covered by the window.
+    buffered.seek(10);
+    unbuffered.seek(10);
+    CPPUNIT_ASSERT_EQUAL(unbuffered.readBlock(100000), buffered.readBlock(100000));
+    CPPUNIT_ASSERT_EQUAL(4328L, buffered.tell());
+
+    const FileStream::ReadAheadStatistics stats = buffered.readAheadStatistics();
+    CPPUNIT_ASSERT_EQUAL(46ULL, stats.readCalls);
+    CPPUNIT_ASSERT_EQUAL(44ULL, stats.bufferedReads);
+    CPPUNIT_ASSERT_EQUAL(1ULL, stats.fileReads);
+    CPPUNIT_ASSERT_EQUAL(0ULL, unbuffered.readAheadStatistics().bufferedReads);
+  }
+
+  void testReadAheadWrite()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    FileStream f(name.c_str());
+    f.seek(100);
+    const ByteVector original = f.readBlock(4);
+
+    f.seek(100);
+    f.writeBlock("abcd");
+    CPPUNIT_ASSERT_EQUAL(104L, f.tell());
+    f.seek(100);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), f.readBlock(4));
+
+    f.insert("xyz", 50, 0);
+    f.seek(103);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcd"), f.readBlock(4));
+
+    f.truncate(100);
+    f.seek(99);
+    CPPUNIT_ASSERT_EQUAL(1U, f.readBlock(4).size());
+    CPPUNIT_ASSERT_EQUAL(100L, f.length());
+    CPPUNIT_ASSERT(original != ByteVector("abcd"));
+  }
+
+  void testIOStatistics()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    PlainFile f(name.c_str());
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.ioStatistics().readCalls);
+
+    f.seek(0);
+    f.readBlock(10);
+    f.readBlock(10);
+    f.seek(4000);
+    f.readBlock(1000);
+
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(4328, 0));
+    ranges.append(IOStream::Range(100, 8));
+    f.readBlocks(ranges);
+
+    f.seek(50);
+    f.writeBlock("abcd");
+
+    File::IOStatistics stats = f.ioStatistics();
+    CPPUNIT_ASSERT_EQUAL(5ULL, stats.readCalls);
+    CPPUNIT_ASSERT_EQUAL(356ULL, stats.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(3ULL, stats.seekCalls);
+    CPPUNIT_ASSERT_EQUAL(3ULL, stats.regions);
+    CPPUNIT_ASSERT_EQUAL(1ULL, stats.writeCalls);
+    CPPUNIT_ASSERT_EQUAL(4ULL, stats.bytesWritten);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stats.ioNanoseconds);
+
+    f.setIOTiming(true);
+    f.seek(0);
+    f.readBlock(100);
+    CPPUNIT_ASSERT(f.ioStatistics().ioNanoseconds > 0);
+
+    f.resetIOStatistics();
+    stats = f.ioStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ULL, stats.readCalls);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stats.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stats.seekCalls);
+    CPPUNIT_ASSERT_EQUAL(0ULL, stats.ioNanoseconds);
+  }
+
+  void testReadTrace()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    List<IOStream::Range> reads;
+    File::setDefaultReadTraceCallback(traceRead, &reads);
+    PlainFile f(name.c_str());
+    File::setDefaultReadTraceCallback(0);
+
+    f.seek(4320);
+    f.readBlock(100);
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(10, 6));
+    ranges.append(IOStream::Range(20, 4));
+    f.readBlocks(ranges);
+
+    CPPUNIT_ASSERT_EQUAL(3U, reads.size());
+    CPPUNIT_ASSERT_EQUAL(4320L, reads[0].offset);
+    CPPUNIT_ASSERT_EQUAL(8UL, reads[0].length);
+    CPPUNIT_ASSERT_EQUAL(10L, reads[1].offset);
+    CPPUNIT_ASSERT_EQUAL(6UL, reads[1].length);
+    CPPUNIT_ASSERT_EQUAL(20L, reads[2].offset);
+
+    f.setReadTraceCallback(0);
+    f.readBlock(1);
+    CPPUNIT_ASSERT_EQUAL(3U, reads.size());
+
+    PlainFile untraced(name.c_str());
+    untraced.readBlock(1);
+    CPPUNIT_ASSERT_EQUAL(3U, reads.size());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
@@ -39,9 +39,18 @@
 #include <wavfile.h>
 #include <apefile.h>
 #include <aifffile.h>
+#include <opusfile.h>
+#include <wavpackfile.h>
+#include <itfile.h>
+#include <s3mfile.h>
+#include <xmfile.h>
+#include <dsffile.h>
+#include <dfffile.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 #include <tfilestream.h>
+#include <tbytevectorstream.h>
+#include <tpropertymap.h>
 
 using namespace std;
 using namespace TagLib;
@@ -78,7 +87,11 @@ class TestFileRef : public CppUnit::TestFixture
   CPPUNIT_TEST(testWav);
   CPPUNIT_TEST(testAIFF_1);
   CPPUNIT_TEST(testAIFF_2);
+  CPPUNIT_TEST(testDSF);
+  CPPUNIT_TEST(testDFF);
   CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testDetectByContent);
+  CPPUNIT_TEST(testDetectMislabeled);
   CPPUNIT_TEST(testFileResolver);
   CPPUNIT_TEST_SUITE_END();
 
@@ -141,6 +154,18 @@ public:
       CPPUNIT_ASSERT_EQUAL(f.tag()->track(), (unsigned int)7);
       CPPUNIT_ASSERT_EQUAL(f.tag()->year(), (unsigned int)2080);
     }
+    {
+      FileRef f(newname.c_str(), true, AudioProperties::Average, FileRef::MappedStreamType);
+      CPPUNIT_ASSERT(dynamic_cast<T*>(f.file()));
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(f.file()->readOnly());
+      CPPUNIT_ASSERT_EQUAL(f.tag()->artist(), String("ttest artist"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->title(), String("ytest title"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->genre(), String("uTest!"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->album(), String("ialbummmm"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->track(), (unsigned int)7);
+      CPPUNIT_ASSERT_EQUAL(f.tag()->year(), (unsigned int)2080);
+    }
   }
 
   void testMusepack()
@@ -228,6 +253,59 @@ public:
     fileRefSave<RIFF::AIFF::File>("alaw", ".aifc");
   }
 
+  void testDSF()
+  {
+    fileRefSave<DSFFile>("empty", ".dsf");
+
+    FileRef f(TEST_FILE_PATH_C("empty.dsf"), false);
+    CPPUNIT_ASSERT(!f.isNull());
+    CPPUNIT_ASSERT(!f.audioProperties());
+    CPPUNIT_ASSERT(f.tag());
+  }
+
+  void testDFF()
+  {
+    {
+      FileRef f(TEST_FILE_PATH_C("empty.dff"));
+      CPPUNIT_ASSERT(dynamic_cast<DFFFile *>(f.file()));
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT_EQUAL(2822400, f.audioProperties()->sampleRate());
+      CPPUNIT_ASSERT_EQUAL(2, f.audioProperties()->channels());
+      CPPUNIT_ASSERT(!f.tag());
+      CPPUNIT_ASSERT(f.file()->properties().isEmpty());
+
+      PropertyMap properties;
+      properties["TITLE"] = StringList("title");
+      CPPUNIT_ASSERT_EQUAL(1U, f.file()->setProperties(properties).size());
+    }
+    {
+      FileStream fs(TEST_FILE_PATH_C("empty.dff"), true);
+      FileRef f(&fs);
+      CPPUNIT_ASSERT(dynamic_cast<DFFFile *>(f.file()));
+      CPPUNIT_ASSERT(!f.isNull());
+    }
+    {
+      ScopedFileCopy copy("empty", ".dff");
+      {
+        FileStream fs(copy.fileName().c_str());
+        fs.truncate(0);
+        fs.writeBlock(ByteVector(1000, '\0'));
+      }
+      FileRef f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(dynamic_cast<DFFFile *>(f.file()));
+      CPPUNIT_ASSERT(f.isNull());
+
+      FileRef f2(copy.fileName().c_str(), false);
+      CPPUNIT_ASSERT(dynamic_cast<DFFFile *>(f2.file()));
+      CPPUNIT_ASSERT(f2.isNull());
+    }
+    {
+      FileRef f(TEST_FILE_PATH_C("empty.dff"), false);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(!f.audioProperties());
+    }
+  }
+
   void testUnsupported()
   {
     FileRef f1(TEST_FILE_PATH_C("no-extension"));
@@ -237,6 +315,91 @@ public:
     CPPUNIT_ASSERT(f2.isNull());
   }
 
+  template <typename T>
+  void detectByContent(const string &filename)
+  {
+    // A ByteVectorStream has no name, so only the content can be used.
+
+    ByteVector data;
+    {
+      FileStream file(TEST_FILE_PATH_C(filename), true);
+      data = file.readBlock(file.length());
+    }
+
+    ByteVectorStream stream(data);
+    FileRef f(&stream, true, AudioProperties::Average, FileRef::DetectByContent);
+    CPPUNIT_ASSERT(dynamic_cast<T *>(f.file()) != NULL);
+    CPPUNIT_ASSERT(f.file()->isValid());
+  }
+
+  void testDetectByContent()
+  {
+    detectByContent<MPEG::File>("xing.mp3");
+    detectByContent<MPEG::File>("rare_frames.mp3");
+    detectByContent<FLAC::File>("no-tags.flac");
+    detectByContent<Ogg::Vorbis::File>("empty.ogg");
+    detectByContent<Ogg::Vorbis::File>("empty_vorbis.oga");
+    detectByContent<Ogg::FLAC::File>("empty_flac.oga");
+    detectByContent<Ogg::Speex::File>("empty.spx");
+    detectByContent<Ogg::Opus::File>("correctness_gain_silent_output.opus");
+    detectByContent<MP4::File>("has-tags.m4a");
+    detectByContent<MP4::File>("no-tags.3g2");
+    detectByContent<RIFF::WAV::File>("empty.wav");
+    detectByContent<RIFF::AIFF::File>("empty.aiff");
+    detectByContent<RIFF::AIFF::File>("alaw.aifc");
+    detectByContent<WavPack::File>("click.wv");
+    detectByContent<MPC::File>("click.mpc");
+    detectByContent<MPC::File>("sv8_header.mpc");
+    detectByContent<TrueAudio::File>("empty.tta");
+    detectByContent<TrueAudio::File>("tagged.tta");
+    detectByContent<ASF::File>("silence-1.wma");
+    detectByContent<APE::File>("mac-399.ape");
+    detectByContent<APE::File>("mac-399-id3v2.ape");
+    detectByContent<IT::File>("test.it");
+    detectByContent<XM::File>("test.xm");
+    detectByContent<S3M::File>("test.s3m");
+    detectByContent<DSFFile>("empty.dsf");
+    detectByContent<DFFFile>("empty.dff");
+
+    ByteVectorStream garbage(ByteVector(1024, 'x'));
+    FileRef f(&garbage, true, AudioProperties::Average, FileRef::DetectByContent);
+    CPPUNIT_ASSERT(f.isNull());
+  }
+
+  void testDetectMislabeled()
+  {
+    ScopedFileCopy copy("unsupported-extension", ".xx");
+    {
+      FileStream source(TEST_FILE_PATH_C("no-tags.flac"), true);
+      FileStream target(copy.fileName().c_str());
+      target.truncate(0);
+      target.writeBlock(source.readBlock(source.length()));
+    }
+
+    {
+      FileRef f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isNull());
+    }
+    {
+      FileRef f(copy.fileName().c_str(), true, AudioProperties::Average,
+                FileRef::FileStreamType, FileRef::DetectByContent);
+      CPPUNIT_ASSERT(dynamic_cast<FLAC::File *>(f.file()) != NULL);
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+      f.tag()->setTitle("Mislabeled");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      FileRef f(copy.fileName().c_str(), true, AudioProperties::Average,
+                FileRef::MappedStreamType, FileRef::DetectByContent);
+      CPPUNIT_ASSERT(dynamic_cast<FLAC::File *>(f.file()) != NULL);
+      CPPUNIT_ASSERT_EQUAL(String("Mislabeled"), f.tag()->title());
+    }
+
+    FileRef f(TEST_FILE_PATH_C("no-extension"), true, AudioProperties::Average,
+              FileRef::FileStreamType, FileRef::DetectByContent);
+    CPPUNIT_ASSERT(f.isNull());
+  }
+
   void testFileResolver()
   {
     {
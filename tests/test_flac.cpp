@@ -33,6 +33,7 @@
 #include <xiphcomment.h>
 #include <id3v1tag.h>
 #include <id3v2tag.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -43,6 +44,7 @@ class TestFLAC : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestFLAC);
   CPPUNIT_TEST(testSignature);
+  CPPUNIT_TEST(testSignatureWithoutMD5);
   CPPUNIT_TEST(testMultipleCommentBlocks);
   CPPUNIT_TEST(testReadPicture);
   CPPUNIT_TEST(testAddPicture);
@@ -64,6 +66,7 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testStripTags);
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
+  CPPUNIT_TEST(testLazyPictures);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -74,6 +77,29 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("a1b141f766e9849ac3db1030a20a3c77"), f.audioProperties()->signature().toHex());
   }
 
+  void testSignatureWithoutMD5()
+  {
+    ScopedFileCopy copy("no-tags", ".flac");
+    {
+      FileStream stream(copy.fileName().c_str());
+      stream.seek(26);
+      stream.writeBlock(ByteVector(16, '\0'));
+    }
+    ByteVector signature;
+    {
+      FLAC::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      FLAC::File f(copy.fileName().c_str(), true,
+                   AudioProperties::Average | AudioProperties::LazySignature);
+      const unsigned long long bytesRead = f.ioStatistics().bytesRead;
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+      CPPUNIT_ASSERT(f.ioStatistics().bytesRead > bytesRead);
+    }
+  }
+
   void testMultipleCommentBlocks()
   {
     ScopedFileCopy copy("multiple-vc", ".flac");
@@ -535,6 +561,69 @@ public:
     }
   }
 
+  void testLazyPictures()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    string newname = copy.fileName();
+
+    {
+      FLAC::File f(newname.c_str());
+      FLAC::Picture *pic = f.pictureList().front();
+      pic->setData(ByteVector(64 * 1024, 'x'));
+      f.save();
+    }
+    {
+      FLAC::File f(newname.c_str(), true, AudioProperties::Average | AudioProperties::LazyTags);
+      const PictureHandleList handles = f.pictureHandles();
+      CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 32 * 1024);
+      CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+      CPPUNIT_ASSERT(handles.front().offset() > 0);
+      CPPUNIT_ASSERT_EQUAL(64U * 1024, handles.front().size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), handles.front().mimeType());
+      CPPUNIT_ASSERT_EQUAL(1, handles.front().width());
+      CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), handles.front().data());
+
+      // The image data is read before the file is rewritten.
+      f.xiphComment()->setTitle("Title");
+      f.save();
+    }
+    {
+      FLAC::File f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), f.pictureList().front()->data());
+    }
+    {
+      // A picture removed without being deleted outlives the file, and has
+      // no image data then.
+      FLAC::Picture *picture;
+      {
+        FLAC::File f(newname.c_str(), true, AudioProperties::Average | AudioProperties::LazyTags);
+        picture = f.pictureList().front();
+        f.removePicture(picture, false);
+      }
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), picture->mimeType());
+      CPPUNIT_ASSERT(picture->handle().data().isEmpty());
+      CPPUNIT_ASSERT(picture->data().isEmpty());
+      delete picture;
+    }
+    {
+      // An image data length beyond the end of the block is rejected.
+      long long offset;
+      {
+        FLAC::File f(newname.c_str(), true, AudioProperties::Average | AudioProperties::LazyTags);
+        offset = f.pictureHandles().front().offset();
+      }
+      {
+        FileStream file(newname.c_str());
+        file.seek(offset - 4);
+        file.writeBlock(ByteVector::fromUInt(64 * 1024 + 1));
+      }
+      FLAC::File f(newname.c_str(), true, AudioProperties::Average | AudioProperties::LazyTags);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT(f.pictureHandles().isEmpty());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
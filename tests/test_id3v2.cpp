@@ -45,6 +45,7 @@
 #include <tdebug.h>
 #include <tpropertymap.h>
 #include <tzlib.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -63,6 +64,10 @@ class PublicFrame : public ID3v2::Frame
     virtual ByteVector renderFields() const { return ByteVector(); }
 };
 
+class FilteredFrameFactory : public ID3v2::FrameFactory
+{
+};
+
 class TestID3v2 : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestID3v2);
@@ -120,6 +125,11 @@ class TestID3v2 : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyFrame);
   CPPUNIT_TEST(testDuplicateTags);
   CPPUNIT_TEST(testParseTOCFrameWithManyChildren);
+  CPPUNIT_TEST(testFrameFilter);
+  CPPUNIT_TEST(testFrameFilterSetters);
+  CPPUNIT_TEST(testFrameFilterProperties);
+  CPPUNIT_TEST(testPictureHandles);
+  CPPUNIT_TEST(testConvertFrameIDs);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -1266,6 +1276,258 @@ public:
     CPPUNIT_ASSERT(f.isValid());
   }
 
+  void testFrameFilter()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    for(int version = 3; version <= 4; ++version) {
+      {
+        MPEG::File f(copy.fileName().c_str());
+        f.ID3v2Tag(true)->setTitle("Title");
+        f.ID3v2Tag()->setComment("Comment");
+        ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+        picture->setPicture(ByteVector(256 * 1024, 'x'));
+        f.ID3v2Tag()->addFrame(picture);
+        f.ID3v2Tag()->setArtist("Artist");
+        f.save(MPEG::File::ID3v2, true, version);
+      }
+
+      FilteredFrameFactory factory;
+      factory.setFrameFilter(ByteVectorList::split("T COMM", " "),
+                             ID3v2::FrameFactory::ReadListedFrames);
+      CPPUNIT_ASSERT(factory.acceptsFrame("TYER", 3));
+      CPPUNIT_ASSERT(factory.acceptsFrame("COM", 2));
+      CPPUNIT_ASSERT(!factory.acceptsFrame("PIC", 2));
+      CPPUNIT_ASSERT(!factory.acceptsFrame("GEOB"));
+      {
+        MPEG::File f(copy.fileName().c_str(), &factory, false);
+        CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 32 * 1024);
+        CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+        CPPUNIT_ASSERT_EQUAL(String("Comment"), f.tag()->comment());
+        CPPUNIT_ASSERT_EQUAL(String("Artist"), f.tag()->artist());
+        CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 32 * 1024);
+
+        // The skipped picture is read when it is asked for.
+        CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("APIC").size());
+        CPPUNIT_ASSERT(f.ioStatistics().bytesRead > 256 * 1024);
+
+        // It is kept when saving.
+        f.tag()->setTitle("New title");
+        f.save(MPEG::File::ID3v2, true, version);
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        const ID3v2::FrameList pictures = f.ID3v2Tag()->frameListMap()["APIC"];
+        CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+        CPPUNIT_ASSERT_EQUAL(256U * 1024, static_cast<ID3v2::AttachedPictureFrame *>(
+          pictures.front())->picture().size());
+      }
+      {
+        MPEG::File f(copy.fileName().c_str(), &factory, false);
+        CPPUNIT_ASSERT_EQUAL(String("New title"), f.tag()->title());
+        f.ID3v2Tag()->removeFrames("APIC");
+        f.save(MPEG::File::ID3v2, true, version);
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        CPPUNIT_ASSERT_EQUAL(String("New title"), f.tag()->title());
+        CPPUNIT_ASSERT_EQUAL(String("Artist"), f.tag()->artist());
+        CPPUNIT_ASSERT(f.ID3v2Tag()->frameListMap()["APIC"].isEmpty());
+      }
+    }
+  }
+
+  void testFrameFilterSetters()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    for(int version = 2; version <= 4; ++version) {
+      {
+        MPEG::File f(copy.fileName().c_str());
+        f.ID3v2Tag(true)->setTitle("Title");
+        f.ID3v2Tag()->setArtist("Artist");
+        f.ID3v2Tag()->setYear(2001);
+        f.save(MPEG::File::ID3v2, true, version == 2 ? 3 : version);
+      }
+
+      if(version == 2) {
+        // Turn the tag into an ID3v2.3 tag with ID3v2.2 frame IDs, as
+        // written by iTunes.
+        FileStream file(copy.fileName().c_str());
+        ByteVector data = file.readBlock(file.length());
+        const char *ids[][2] = { { "TIT2", "TT2" }, { "TPE1", "TP1" }, { "TYER", "TYE" } };
+        for(size_t i = 0; i < 3; ++i) {
+          const int offset = data.find(ids[i][0]);
+          CPPUNIT_ASSERT(offset > 0);
+          for(int j = 0; j < 4; ++j)
+            data[offset + j] = ids[i][1][j];
+        }
+        file.seek(0);
+        file.writeBlock(data);
+      }
+
+      FilteredFrameFactory factory;
+      factory.setFrameFilter(ByteVectorList::split("APIC COMM", " "),
+                             ID3v2::FrameFactory::ReadListedFrames);
+      {
+        MPEG::File f(copy.fileName().c_str(), &factory, false);
+        CPPUNIT_ASSERT(!f.ID3v2Tag()->isEmpty());
+        f.tag()->setTitle("New title");
+        f.tag()->setArtist("New artist");
+        f.ID3v2Tag()->removeFrames("TDRC");
+        f.save(MPEG::File::ID3v2, true, 4);
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("TIT2").size());
+        CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("TPE1").size());
+        CPPUNIT_ASSERT_EQUAL(String("New title"), f.tag()->title());
+        CPPUNIT_ASSERT_EQUAL(String("New artist"), f.tag()->artist());
+        CPPUNIT_ASSERT(f.ID3v2Tag()->frameList("TDRC").isEmpty());
+        f.strip();
+      }
+    }
+  }
+
+  void testFrameFilterProperties()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    {
+      MPEG::File f(copy.fileName().c_str());
+      f.ID3v2Tag(true)->setTitle("Title");
+      ID3v2::UnsynchronizedLyricsFrame *lyrics = new ID3v2::UnsynchronizedLyricsFrame();
+      lyrics->setText("Lyrics");
+      f.ID3v2Tag()->addFrame(lyrics);
+      ID3v2::UserTextIdentificationFrame *userText = new ID3v2::UserTextIdentificationFrame();
+      userText->setDescription("FOO");
+      userText->setText("bar");
+      f.ID3v2Tag()->addFrame(userText);
+      f.save();
+    }
+
+    FilteredFrameFactory factory;
+    factory.setFrameFilter(ByteVectorList::split("TIT2", " "),
+                           ID3v2::FrameFactory::ReadListedFrames);
+    {
+      MPEG::File f(copy.fileName().c_str(), &factory, false);
+      PropertyMap properties = f.properties();
+      CPPUNIT_ASSERT_EQUAL(1U, properties.size());
+      CPPUNIT_ASSERT(!properties.contains("LYRICS"));
+
+      // Frames that properties() left out are kept by setProperties().
+      properties["TITLE"] = StringList("New title");
+      CPPUNIT_ASSERT(f.setProperties(properties).isEmpty());
+      f.save();
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      const PropertyMap properties = f.properties();
+      CPPUNIT_ASSERT_EQUAL(StringList("New title"), properties["TITLE"]);
+      CPPUNIT_ASSERT_EQUAL(StringList("Lyrics"), properties["LYRICS"]);
+      CPPUNIT_ASSERT_EQUAL(StringList("bar"), properties["FOO"]);
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("USLT").size());
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("TXXX").size());
+    }
+  }
+
+  void testPictureHandles()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+
+    for(int version = 3; version <= 4; ++version) {
+      {
+        MPEG::File f(copy.fileName().c_str());
+        ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+        picture->setMimeType("image/png");
+        picture->setType(ID3v2::AttachedPictureFrame::BackCover);
+        picture->setDescription("Description");
+        picture->setPicture(ByteVector(64 * 1024, 'x'));
+        f.ID3v2Tag(true)->addFrame(picture);
+        f.save(MPEG::File::ID3v2, true, version);
+      }
+
+      FilteredFrameFactory factory;
+      factory.setFrameFilter(ByteVectorList::split("APIC", " "));
+      {
+        MPEG::File f(copy.fileName().c_str(), &factory, false);
+        const PictureHandleList handles = f.ID3v2Tag()->pictureHandles();
+        CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 32 * 1024);
+        CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+        CPPUNIT_ASSERT(handles.front().offset() > 0);
+        CPPUNIT_ASSERT_EQUAL(64U * 1024, handles.front().size());
+        CPPUNIT_ASSERT_EQUAL(String("image/png"), handles.front().mimeType());
+        CPPUNIT_ASSERT_EQUAL(static_cast<int>(ID3v2::AttachedPictureFrame::BackCover),
+                             handles.front().type());
+        CPPUNIT_ASSERT_EQUAL(String("Description"), handles.front().description());
+        CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), handles.front().data());
+        CPPUNIT_ASSERT_EQUAL(ByteVector(3, 'x'), handles.front().data(100, 3));
+      }
+      {
+        // Handles stop working when the file is changed or destroyed.
+        PictureHandleList handles;
+        {
+          MPEG::File f(copy.fileName().c_str(), &factory, false);
+          handles = f.ID3v2Tag()->pictureHandles();
+        }
+        CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+        CPPUNIT_ASSERT(handles.front().data().isEmpty());
+
+        MPEG::File f(copy.fileName().c_str(), &factory, false);
+        handles = f.ID3v2Tag()->pictureHandles();
+        f.tag()->setTitle("Title");
+        f.save(MPEG::File::ID3v2, true, version);
+        CPPUNIT_ASSERT(handles.front().data().isEmpty());
+
+        // The saved picture is held in memory now.
+        handles = f.ID3v2Tag()->pictureHandles();
+        CPPUNIT_ASSERT_EQUAL(-1LL, handles.front().offset());
+        CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), handles.front().data());
+      }
+      {
+        MPEG::File f(copy.fileName().c_str());
+        const PictureHandleList handles = f.ID3v2Tag()->pictureHandles();
+        CPPUNIT_ASSERT_EQUAL(1U, handles.size());
+        CPPUNIT_ASSERT_EQUAL(-1LL, handles.front().offset());
+        CPPUNIT_ASSERT_EQUAL(ByteVector(64 * 1024, 'x'), handles.front().data());
+        f.strip();
+      }
+    }
+  }
+
+  void testConvertFrameIDs()
+  {
+    ID3v2::FrameFactory *factory = ID3v2::FrameFactory::instance();
+
+    const char *ids[][3] = {
+      { "MVI", "MVIN", "2" }, { "PCS", "PCST", "2" }, { "TCT", "TCAT", "2" },
+      { "TT2", "TIT2", "2" }, { "TXX", "TXXX", "2" }, { "WFD", "WFED", "2" },
+      { "WXX", "WXXX", "2" }, { "IPLS", "TIPL", "3" }, { "TYER", "TDRC", "3" },
+      { "TRDC", "TDRC", "4" }
+    };
+
+    for(size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); ++i) {
+      const unsigned int version = ids[i][2][0] - '0';
+      ByteVector data = ids[i][0];
+      if(version == 2)
+        data.append(ByteVector("\x00\x00\x03", 3));
+      else
+        data.append(ByteVector("\x00\x00\x00\x03\x00\x00", 6));
+      data.append(ByteVector("\x00" "a\x00", 3));
+
+      ID3v2::Frame *frame = factory->createFrame(data, version);
+      CPPUNIT_ASSERT(frame);
+      CPPUNIT_ASSERT_EQUAL(ByteVector(ids[i][1]), frame->frameID());
+      CPPUNIT_ASSERT(!dynamic_cast<ID3v2::UnknownFrame *>(frame));
+      delete frame;
+    }
+
+    ByteVector data("EQU\x00\x00\x03\x00" "a\x00", 9);
+    ID3v2::Frame *frame = factory->createFrame(data, 2U);
+    CPPUNIT_ASSERT(dynamic_cast<ID3v2::UnknownFrame *>(frame));
+    delete frame;
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestID3v2);
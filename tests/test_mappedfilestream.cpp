@@ -0,0 +1,151 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include <tmappedfilestream.h>
+#include <tfilestream.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace TagLib;
+
+class TestMappedFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMappedFileStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadBlocks);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testMissingFile);
+#ifndef _WIN32
+  CPPUNIT_TEST(testTruncatedFile);
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    const std::string name = TEST_FILE_PATH_C("empty.ogg");
+
+    FileStream file(name.c_str(), true);
+    MappedFileStream mapped(name.c_str());
+    CPPUNIT_ASSERT(mapped.isOpen());
+    CPPUNIT_ASSERT_EQUAL(4328L, mapped.length());
+
+    CPPUNIT_ASSERT_EQUAL(file.readBlock(100), mapped.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(100L, mapped.tell());
+    CPPUNIT_ASSERT_EQUAL(file.readBlock(5000), mapped.readBlock(5000));
+    CPPUNIT_ASSERT_EQUAL(4328L, mapped.tell());
+    CPPUNIT_ASSERT(mapped.readBlock(1).isEmpty());
+  }
+
+  void testSeek()
+  {
+    MappedFileStream f(TEST_FILE_PATH_C("empty.ogg"));
+    CPPUNIT_ASSERT_EQUAL(0L, f.tell());
+
+    f.seek(100, IOStream::Beginning);
+    CPPUNIT_ASSERT_EQUAL(100L, f.tell());
+    f.seek(100, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(200L, f.tell());
+    f.seek(-300, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(200L, f.tell());
+
+    f.seek(-100, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(4228L, f.tell());
+    f.seek(300, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(4528L, f.tell());
+    CPPUNIT_ASSERT(f.readBlock(10).isEmpty());
+    CPPUNIT_ASSERT_EQUAL(4528L, f.tell());
+  }
+
+  void testReadBlocks()
+  {
+    const std::string name = TEST_FILE_PATH_C("empty.ogg");
+
+    FileStream file(name.c_str(), true);
+    MappedFileStream mapped(name.c_str());
+    mapped.seek(1234);
+
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(10, 6));
+    ranges.append(IOStream::Range(4000, 100));
+    ranges.append(IOStream::Range(4300, 100));
+    ranges.append(IOStream::Range(0, 100));
+
+    const ByteVector data = mapped.readBlocks(ranges);
+    CPPUNIT_ASSERT_EQUAL(file.readBlocks(ranges), data);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)134, data.size());
+    CPPUNIT_ASSERT_EQUAL(1234L, mapped.tell());
+  }
+
+  void testReadOnly()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    {
+      MappedFileStream f(name.c_str());
+      CPPUNIT_ASSERT(f.readOnly());
+      f.writeBlock(ByteVector("abcd"));
+      f.insert(ByteVector("abcd"), 10);
+      f.removeBlock(0, 100);
+      f.truncate(10);
+      CPPUNIT_ASSERT_EQUAL(4328L, f.length());
+    }
+    {
+      FileStream f(name.c_str());
+      CPPUNIT_ASSERT_EQUAL(4328L, f.length());
+    }
+  }
+
+  void testMissingFile()
+  {
+    MappedFileStream f("does-not-exist.ogg");
+    CPPUNIT_ASSERT(!f.isOpen());
+    CPPUNIT_ASSERT(f.readBlock(10).isEmpty());
+  }
+
+#ifndef _WIN32
+  void testTruncatedFile()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    MappedFileStream mapped(name.c_str());
+    CPPUNIT_ASSERT_EQUAL(4328L, mapped.length());
+
+    FileStream(name.c_str()).truncate(100);
+
+    mapped.seek(4200);
+    CPPUNIT_ASSERT(mapped.readBlock(100).isEmpty());
+    mapped.seek(50);
+    CPPUNIT_ASSERT_EQUAL((unsigned int)50, mapped.readBlock(100).size());
+
+    List<IOStream::Range> ranges;
+    ranges.append(IOStream::Range(0, 10));
+    ranges.append(IOStream::Range(4200, 100));
+    CPPUNIT_ASSERT_EQUAL((unsigned int)10, mapped.readBlocks(ranges).size());
+  }
+#endif
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMappedFileStream);
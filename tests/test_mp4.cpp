@@ -25,9 +25,11 @@
 
 #include <string>
 #include <stdio.h>
+#include <climits>
 #include <tag.h>
 #include <mp4tag.h>
 #include <tbytevectorlist.h>
+#include <tbytevectorstream.h>
 #include <tpropertymap.h>
 #include <mp4atom.h>
 #include <mp4file.h>
@@ -37,6 +39,45 @@
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  ByteVector atom(const char *name, const ByteVector &payload)
+  {
+    return ByteVector::fromUInt(payload.size() + 8) + ByteVector(name) + payload;
+  }
+
+  // A file with a single chunk that points to the data in 'mdat', and with
+  // \a before and \a after placed around 'udta' in 'moov'.
+
+  ByteVector fileWithFreeSpace(const ByteVector &before, const ByteVector &after)
+  {
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4A ") + ByteVector::fromUInt(0));
+    const ByteVector hdlr = ByteVector(8, '\0') + ByteVector("mdirappl") + ByteVector(9, '\0');
+    const ByteVector udta = atom("udta", atom("meta", ByteVector(4, '\0') + atom("hdlr", hdlr) +
+      atom("ilst", atom("\251nam", atom("data", ByteVector::fromUInt(1) + ByteVector::fromUInt(0) +
+                                                 ByteVector("Title"))))));
+
+    // 'trak' is 52 bytes long.
+    const unsigned int moovSize = 8 + before.size() + 52 + udta.size() + after.size();
+    const ByteVector stco = ByteVector::fromUInt(0) + ByteVector::fromUInt(1) +
+                            ByteVector::fromUInt(ftyp.size() + moovSize + 8);
+    const ByteVector trak = atom("trak", atom("mdia", atom("minf", atom("stbl", atom("stco", stco)))));
+
+    return ftyp + atom("moov", before + trak + udta + after) + atom("mdat", ByteVector("audio data"));
+  }
+
+  // Returns what the first chunk offset points to.
+
+  ByteVector firstChunk(MP4::File &f)
+  {
+    MP4::Atoms a(&f);
+    MP4::Atom *stco = a.find("moov")->findall("stco", true)[0];
+    f.seek(stco->offset + 16);
+    f.seek(f.readBlock(4).toUInt());
+    return f.readBlock(10);
+  }
+}
+
 class TestMP4 : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestMP4);
@@ -48,6 +89,13 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testHasTag);
   CPPUNIT_TEST(testIsEmpty);
   CPPUNIT_TEST(testUpdateStco);
+  CPPUNIT_TEST(testUpdateCo64);
+  CPPUNIT_TEST(testUpdateTfhd);
+  CPPUNIT_TEST(testLazyAtoms);
+  CPPUNIT_TEST(testSaveToFreeAtom);
+  CPPUNIT_TEST(testSaveToFreeAtomBefore);
+  CPPUNIT_TEST(testPaddingSize);
+  CPPUNIT_TEST(testSaveWithInvalidAtom);
   CPPUNIT_TEST(testSaveExisingWhenIlstIsLast);
   CPPUNIT_TEST(test64BitAtom);
   CPPUNIT_TEST(testGnre);
@@ -59,6 +107,8 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testRepeatedSave);
   CPPUNIT_TEST(testWithZeroLengthAtom);
+  CPPUNIT_TEST(testLazySignatureSave);
+  CPPUNIT_TEST(testLazyCoverArt);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -150,6 +200,213 @@ public:
     CPPUNIT_ASSERT(!t2.isEmpty());
   }
 
+  void testUpdateCo64()
+  {
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4A ") + ByteVector::fromUInt(0));
+    const ByteVector hdlr = ByteVector(8, '\0') + ByteVector("mdirappl") + ByteVector(9, '\0');
+    const ByteVector udta = atom("udta", atom("meta", ByteVector(4, '\0') + atom("hdlr", hdlr) +
+                                                      atom("ilst", ByteVector())));
+
+    // One offset in front of 'moov', one in 'mdat' and one beyond 4 GiB.
+
+    ByteVector co64 = ByteVector::fromUInt(0) + ByteVector::fromUInt(3);
+    co64.append(ByteVector::fromLongLong(8LL));
+    co64.append(ByteVector::fromLongLong(1000LL));
+    co64.append(ByteVector::fromLongLong(0x100000010LL));
+
+    const ByteVector moov = atom("moov", atom("trak", atom("mdia", atom("minf",
+                                 atom("stbl", atom("co64", co64))))) + udta);
+    ByteVectorStream stream(ftyp + moov + atom("mdat", ByteVector(16, '\0')));
+
+    long delta;
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      const long length = f.length();
+      f.tag()->setArtist(ByteVector(3000, 'x'));
+      f.save();
+      delta = f.length() - length;
+      CPPUNIT_ASSERT(delta > 0);
+    }
+
+    MP4::File f(&stream);
+    MP4::Atoms a(&f);
+    MP4::Atom *co64Atom = a.find("moov")->findall("co64", true)[0];
+    f.seek(co64Atom->offset + 12);
+    const ByteVector data = f.readBlock(co64Atom->length - 12);
+    CPPUNIT_ASSERT_EQUAL(3U, data.toUInt());
+    CPPUNIT_ASSERT_EQUAL(8LL, data.toLongLong(4U));
+    CPPUNIT_ASSERT_EQUAL(1000LL + delta, data.toLongLong(12U));
+    CPPUNIT_ASSERT_EQUAL(0x100000010LL + delta, data.toLongLong(20U));
+  }
+
+  void testUpdateTfhd()
+  {
+    const ByteVector ftyp = atom("ftyp", ByteVector("iso5") + ByteVector::fromUInt(0));
+    const ByteVector hdlr = ByteVector(8, '\0') + ByteVector("mdirappl") + ByteVector(9, '\0');
+    const ByteVector moov = atom("moov", atom("udta", atom("meta", ByteVector(4, '\0') +
+                                                      atom("hdlr", hdlr) + atom("ilst", ByteVector()))));
+
+    // The fragment is only read when the offsets are updated.
+    const ByteVector tfhd = ByteVector::fromUInt(1) + ByteVector::fromUInt(1) +
+                            ByteVector::fromLongLong(1000LL);
+    const ByteVector moof = atom("moof", atom("traf", atom("tfhd", tfhd)));
+    ByteVectorStream stream(ftyp + moov + moof + atom("mdat", ByteVector(16, '\0')));
+
+    long delta;
+    {
+      MP4::File f(&stream, false);
+      CPPUNIT_ASSERT(f.isValid());
+      const long length = f.length();
+      f.tag()->setArtist(ByteVector(3000, 'x'));
+      f.save();
+      delta = f.length() - length;
+      CPPUNIT_ASSERT(delta > 0);
+    }
+
+    MP4::File f(&stream, false);
+    MP4::Atoms a(&f);
+    MP4::Atom *tfhdAtom = a.find("moof", "traf", "tfhd");
+    CPPUNIT_ASSERT(tfhdAtom);
+    f.seek(tfhdAtom->offset + 16);
+    CPPUNIT_ASSERT_EQUAL(1000LL + delta, f.readBlock(8).toLongLong());
+  }
+
+  void testLazyAtoms()
+  {
+    MP4::File f(TEST_FILE_PATH_C("has-tags.m4a"));
+    MP4::Atoms a(&f);
+
+    MP4::Atom *moov = a.find("moov");
+    CPPUNIT_ASSERT(moov->hasUnreadChildren());
+    CPPUNIT_ASSERT(a.find("moov", "udta", "meta", "ilst"));
+    CPPUNIT_ASSERT(!moov->hasUnreadChildren());
+
+    MP4::Atom *trak = moov->find("trak");
+    CPPUNIT_ASSERT(trak->hasUnreadChildren());
+    CPPUNIT_ASSERT(trak->find("mdia", "minf", "stbl", "stco"));
+    CPPUNIT_ASSERT(!trak->hasUnreadChildren());
+    CPPUNIT_ASSERT_EQUAL(1U, moov->findall("stco", true).size());
+  }
+
+  void testSaveToFreeAtom()
+  {
+    ByteVectorStream stream(fileWithFreeSpace(ByteVector(), atom("free", ByteVector(4000, '\0'))));
+    const long length = stream.length();
+    const String artist(ByteVector(3000, 'x'));
+
+    {
+      MP4::File f(&stream);
+      f.tag()->setArtist(artist);
+      f.save();
+      CPPUNIT_ASSERT(f.tag()->savedInPlace());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+      // The atom tree is kept up to date.
+      f.tag()->setArtist("Artist");
+      f.save();
+      CPPUNIT_ASSERT(f.tag()->savedInPlace());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+      f.tag()->setArtist(artist);
+      f.save();
+      CPPUNIT_ASSERT(f.tag()->savedInPlace());
+    }
+
+    MP4::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(artist, f.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("audio data"), firstChunk(f));
+
+    MP4::Atoms a(&f);
+    CPPUNIT_ASSERT(!a.find("moov", "free"));
+    CPPUNIT_ASSERT_EQUAL(length, a.atoms.back()->offset + a.atoms.back()->length);
+  }
+
+  void testSaveToFreeAtomBefore()
+  {
+    // A 'skip' atom in front of the track, so the track has to move.
+    ByteVectorStream stream(fileWithFreeSpace(atom("skip", ByteVector(4000, '\0')), ByteVector()));
+    const long length = stream.length();
+    const String artist(ByteVector(3000, 'x'));
+
+    {
+      MP4::File f(&stream);
+      f.tag()->setArtist(artist);
+      f.save();
+      CPPUNIT_ASSERT(f.tag()->savedInPlace());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+
+    MP4::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(artist, f.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("audio data"), firstChunk(f));
+
+    MP4::Atoms a(&f);
+    CPPUNIT_ASSERT(!a.find("moov", "skip"));
+    CPPUNIT_ASSERT(a.find("moov", "udta", "meta", "free"));
+  }
+
+  void testPaddingSize()
+  {
+    ByteVectorStream stream(fileWithFreeSpace(ByteVector(), ByteVector()));
+    const long length = stream.length();
+
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT_EQUAL(0U, f.tag()->paddingSize());
+      f.tag()->setPaddingSize(10000);
+      f.tag()->setArtist("Artist");
+      f.save();
+      CPPUNIT_ASSERT(!f.tag()->savedInPlace());
+    }
+    CPPUNIT_ASSERT(stream.length() > length + 10000);
+
+    {
+      // The padding size counts the bytes after the header of 'free'.
+      MP4::File f(&stream);
+      MP4::Atoms a(&f);
+      const MP4::Atom *free = a.find("moov", "udta", "meta", "free");
+      CPPUNIT_ASSERT(free);
+      CPPUNIT_ASSERT_EQUAL(10008L, free->length);
+
+      f.tag()->setPaddingSize(0xFFFFFFFFU);
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(INT_MAX), f.tag()->paddingSize());
+    }
+
+    {
+      MP4::File f(&stream);
+      f.tag()->setArtist(ByteVector(5000, 'x'));
+      f.save();
+      CPPUNIT_ASSERT(f.tag()->savedInPlace());
+    }
+
+    MP4::File f(&stream);
+    CPPUNIT_ASSERT_EQUAL(String(ByteVector(5000, 'x')), f.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("audio data"), firstChunk(f));
+  }
+
+  void testSaveWithInvalidAtom()
+  {
+    // An atom of size 3 in front of 'stco' hides the offset table.
+    const ByteVector ftyp = atom("ftyp", ByteVector("M4A ") + ByteVector::fromUInt(0));
+    const ByteVector stco = atom("stco", ByteVector::fromUInt(0) + ByteVector::fromUInt(1) +
+                                         ByteVector::fromUInt(0));
+    const ByteVector stbl = atom("stbl", ByteVector::fromUInt(3) + ByteVector("junk") + stco);
+    const ByteVector file = ftyp + atom("moov", atom("trak", atom("mdia", atom("minf", stbl)))) +
+                            atom("mdat", ByteVector("audio data"));
+
+    ByteVectorStream stream(file);
+    {
+      MP4::File f(&stream, false);
+      CPPUNIT_ASSERT(f.isValid());
+      f.tag()->setTitle("Title");
+      CPPUNIT_ASSERT(!f.save());
+    }
+    CPPUNIT_ASSERT_EQUAL(file, *stream.data());
+  }
+
   void testUpdateStco()
   {
     ScopedFileCopy copy("no-tags", ".3g2");
@@ -458,6 +715,58 @@ public:
     CPPUNIT_ASSERT_EQUAL(22050, f.audioProperties()->sampleRate());
   }
 
+  void testLazySignatureSave()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+
+    ByteVector signature;
+    {
+      MP4::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      MP4::File f(copy.fileName().c_str(), true,
+                  AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setComment(String(std::string(10000, 'x')));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      MP4::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
+  void testLazyCoverArt()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+    string filename = copy.fileName();
+
+    {
+      MP4::File f(filename.c_str(), true, AudioProperties::Average | AudioProperties::LazyTags);
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL((unsigned int)2, l.size());
+      CPPUNIT_ASSERT(l[0].handle().offset() > 0);
+      CPPUNIT_ASSERT_EQUAL((unsigned int)79, l[0].handle().size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), l[0].handle().mimeType());
+      CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::JPEG, l[1].format());
+      CPPUNIT_ASSERT_EQUAL((unsigned int)287, l[1].handle().size());
+      CPPUNIT_ASSERT_EQUAL(l[1].handle().data(), l[1].data());
+
+      f.tag()->setTitle("Title");
+      f.save();
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+      MP4::CoverArtList l = f.tag()->item("covr").toCoverArtList();
+      CPPUNIT_ASSERT_EQUAL((unsigned int)2, l.size());
+      CPPUNIT_ASSERT_EQUAL((unsigned int)79, l[0].data().size());
+      CPPUNIT_ASSERT_EQUAL((unsigned int)287, l[1].data().size());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMP4);
@@ -29,22 +29,52 @@
 #include <tpropertymap.h>
 #include <mpegfile.h>
 #include <id3v2tag.h>
+#include <attachedpictureframe.h>
 #include <id3v1tag.h>
 #include <apetag.h>
 #include <mpegproperties.h>
 #include <xingheader.h>
 #include <mpegheader.h>
+#include <mpegframeheader.h>
+#include <mpegscanner.h>
+#include <mpegutils.h>
+#include <tfilestream.h>
+#include <tbytevectorstream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  // 100 frames of 128 kb/s and 100 frames of 320 kb/s at 44.1 kHz, in turns,
+  // with 100 bytes of garbage after the 101st frame.
+
+  ByteVector vbrStream()
+  {
+    ByteVector frame128("\xFF\xFB\x90\x00", 4);
+    frame128.append(ByteVector(417 - 4, '\0'));
+    ByteVector frame320("\xFF\xFB\xE0\x00", 4);
+    frame320.append(ByteVector(1044 - 4, '\0'));
+
+    ByteVector data;
+    for(int i = 0; i < 100; ++i) {
+      data.append(frame128);
+      if(i == 50)
+        data.append(ByteVector(100, '\x55'));
+      data.append(frame320);
+    }
+    return data;
+  }
+}
+
 class TestMPEG : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestMPEG);
   CPPUNIT_TEST(testAudioPropertiesXingHeaderCBR);
   CPPUNIT_TEST(testAudioPropertiesXingHeaderVBR);
+  CPPUNIT_TEST(testXingHeaderLameTag);
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
   CPPUNIT_TEST(testSkipInvalidFrames1);
@@ -65,6 +95,13 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyID3v1);
   CPPUNIT_TEST(testEmptyAPE);
   CPPUNIT_TEST(testIgnoreGarbage);
+  CPPUNIT_TEST(testFalseSyncBeforeFirstFrame);
+  CPPUNIT_TEST(testHeaderFromData);
+  CPPUNIT_TEST(testScannerBackends);
+  CPPUNIT_TEST(testFrameHeader);
+  CPPUNIT_TEST(testAccurateVBRWithoutHeader);
+  CPPUNIT_TEST(testSeekIndex);
+  CPPUNIT_TEST(testLazyID3v2Tag);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -95,6 +132,43 @@ public:
     CPPUNIT_ASSERT_EQUAL(MPEG::XingHeader::Xing, f.audioProperties()->xingHeader()->type());
   }
 
+  void testXingHeaderLameTag()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"));
+    const MPEG::XingHeader *xing = f.audioProperties()->xingHeader();
+    CPPUNIT_ASSERT(xing);
+    CPPUNIT_ASSERT_EQUAL(String("LAME3.99r"), xing->encoderInfo());
+    CPPUNIT_ASSERT(xing->hasTableOfContents());
+    CPPUNIT_ASSERT_EQUAL(100U, xing->tableOfContents().size());
+    CPPUNIT_ASSERT_EQUAL(0LL, xing->tableOfContentsOffset(0));
+    CPPUNIT_ASSERT_EQUAL(8289302LL, xing->tableOfContentsOffset(50));
+    CPPUNIT_ASSERT_EQUAL(static_cast<long long>(xing->totalSize()), xing->tableOfContentsOffset(100));
+    CPPUNIT_ASSERT_EQUAL(50, xing->quality());
+    CPPUNIT_ASSERT(xing->hasLameTag());
+    CPPUNIT_ASSERT_EQUAL(4, xing->vbrMethod());
+    CPPUNIT_ASSERT_EQUAL(17000, xing->lowpassFrequency());
+    CPPUNIT_ASSERT_EQUAL(576, xing->encoderDelay());
+    CPPUNIT_ASSERT_EQUAL(576, xing->encoderPadding());
+    CPPUNIT_ASSERT_EQUAL(16578604U, xing->musicLength());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned short>(0x753f), xing->musicCRC());
+
+    // A damaged LAME tag must not be trusted.
+
+    f.seek(f.firstFrameOffset());
+    ByteVector frame = f.readBlock(1024);
+    const int lame = frame.find("LAME");
+    CPPUNIT_ASSERT(lame > 0);
+    frame[lame + 22] = frame[lame + 22] + 1;
+    MPEG::XingHeader damaged(frame);
+    CPPUNIT_ASSERT(damaged.isValid());
+    CPPUNIT_ASSERT(damaged.hasTableOfContents());
+    CPPUNIT_ASSERT(!damaged.hasLameTag());
+    CPPUNIT_ASSERT_EQUAL(0, damaged.encoderDelay());
+
+    MPEG::File cbr(TEST_FILE_PATH_C("lame_cbr.mp3"));
+    CPPUNIT_ASSERT_EQUAL(1, cbr.audioProperties()->xingHeader()->vbrMethod());
+  }
+
   void testAudioPropertiesVBRIHeader()
   {
     MPEG::File f(TEST_FILE_PATH_C("rare_frames.mp3"));
@@ -438,6 +512,251 @@ public:
     }
   }
 
+  void testFalseSyncBeforeFirstFrame()
+  {
+    const ScopedFileCopy copy("xing", ".mp3");
+
+    // Every four bytes look like the header of a padded 48 kHz frame, but the
+    // next frame never matches it.
+
+    ByteVector junk;
+    for(int i = 0; i < 16384; ++i)
+      junk.append(ByteVector("\xFF\xFB\x96\x00", 4));
+    {
+      FileStream stream(copy.fileName().c_str());
+      stream.insert(junk, 0, 0);
+    }
+
+    MPEG::File f(copy.fileName().c_str());
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(static_cast<long>(junk.size()), f.firstFrameOffset());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+
+    // The candidates are checked in the blocks that are scanned anyway.
+    CPPUNIT_ASSERT(f.ioStatistics().readCalls < 1000);
+  }
+
+  void testHeaderFromData()
+  {
+    const MPEG::Header header(ByteVector("\xFF\xFB\x90\x00", 4));
+    CPPUNIT_ASSERT(header.isValid());
+    CPPUNIT_ASSERT_EQUAL(MPEG::Header::Version1, header.version());
+    CPPUNIT_ASSERT_EQUAL(3, header.layer());
+    CPPUNIT_ASSERT_EQUAL(128, header.bitrate());
+    CPPUNIT_ASSERT_EQUAL(44100, header.sampleRate());
+    CPPUNIT_ASSERT_EQUAL(417, header.frameLength());
+
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFB\xF0\x00", 4)).isValid());
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFB", 2)).isValid());
+  }
+
+  void testScannerBackends()
+  {
+    // Random bytes that are mostly the ones the scanner looks for.
+
+    const char alphabet[] = { '\xFF', '\xFF', '\xE0', '\xFB', 'I', 'D', '3', '\x00' };
+    ByteVector data;
+    unsigned int seed = 1;
+    for(int i = 0; i < 300; ++i) {
+      seed = seed * 1103515245 + 12345;
+      data.append(alphabet[(seed >> 16) % sizeof(alphabet)]);
+    }
+
+    const MPEG::Scanner::Backend defaultBackend = MPEG::Scanner::backend();
+    const MPEG::Scanner::Backend backends[] = {
+      MPEG::Scanner::Scalar, MPEG::Scanner::SSE2, MPEG::Scanner::AVX2
+    };
+
+    CPPUNIT_ASSERT(MPEG::Scanner::isSupported(MPEG::Scanner::Scalar));
+
+    for(unsigned int b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+      if(!MPEG::Scanner::setBackend(backends[b]))
+        continue;
+
+      for(unsigned int length = 0; length <= data.size(); length += 37) {
+        const ByteVector buffer = data.mid(0, length);
+        for(unsigned int offset = 0; offset <= length; ++offset) {
+          int sync = -1;
+          int syncOrTag = -1;
+          for(unsigned int i = offset; i + 1 < length; ++i) {
+            const bool isSync = MPEG::isFrameSync(buffer.mid(i, 2));
+            const bool isTag = buffer.containsAt("ID3", i);
+            if(sync < 0 && isSync)
+              sync = i;
+            if(syncOrTag < 0 && i + 2 < length && (isSync || isTag))
+              syncOrTag = i;
+          }
+          int lastSync = -1;
+          for(unsigned int i = 0; i <= offset && i + 1 < length; ++i) {
+            if(MPEG::isFrameSync(buffer.mid(i, 2)))
+              lastSync = i;
+          }
+
+          CPPUNIT_ASSERT_EQUAL(sync, MPEG::Scanner::findFrameSync(buffer, offset));
+          CPPUNIT_ASSERT_EQUAL(lastSync, MPEG::Scanner::rfindFrameSync(buffer, offset));
+          CPPUNIT_ASSERT_EQUAL(syncOrTag, MPEG::Scanner::findFrameSyncOrTag(buffer, offset));
+        }
+      }
+    }
+
+    MPEG::Scanner::setBackend(defaultBackend);
+  }
+
+  void testFrameHeader()
+  {
+    MPEG::FrameHeader header;
+
+    // MPEG 2.5 layer II at 160 kb/s and 8 kHz, padded: the longest frame.
+    CPPUNIT_ASSERT(MPEG::parseFrameHeader(0xFFE5EA00, header));
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(MPEG::Header::Version2_5), static_cast<int>(header.version));
+    CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(header.layer));
+    CPPUNIT_ASSERT_EQUAL(160, static_cast<int>(header.bitrate));
+    CPPUNIT_ASSERT_EQUAL(8000, static_cast<int>(header.sampleRate));
+    CPPUNIT_ASSERT_EQUAL(2881, static_cast<int>(header.frameLength));
+    CPPUNIT_ASSERT(header.isPadded());
+    CPPUNIT_ASSERT(!header.protectionEnabled());
+
+    // MPEG 1 layer I at 32 kb/s and 48 kHz with a CRC, padded by a 4 byte
+    // slot, mono, copyrighted and original.
+    CPPUNIT_ASSERT(MPEG::parseFrameHeader(0xFFFE16CC, header));
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(header.layer));
+    CPPUNIT_ASSERT_EQUAL(384, static_cast<int>(header.samplesPerFrame));
+    CPPUNIT_ASSERT_EQUAL(36, static_cast<int>(header.frameLength));
+    CPPUNIT_ASSERT(header.protectionEnabled());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(MPEG::Header::SingleChannel), header.channelMode());
+    CPPUNIT_ASSERT(header.isCopyrighted());
+    CPPUNIT_ASSERT(header.isOriginal());
+
+    const char *error = 0;
+    CPPUNIT_ASSERT(!MPEG::parseFrameHeader(0xFFEB9000, header, &error));
+    CPPUNIT_ASSERT_EQUAL(string("Invalid MPEG version bits."), string(error));
+    CPPUNIT_ASSERT(!MPEG::parseFrameHeader(0xFFFF9000, header));
+    CPPUNIT_ASSERT(!MPEG::parseFrameHeader(0xFFFBF000, header));
+    CPPUNIT_ASSERT(!MPEG::parseFrameHeader(0xFFFB9C00, header));
+  }
+
+  void testAccurateVBRWithoutHeader()
+  {
+    const ByteVector data = vbrStream();
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(9138, f.audioProperties()->lengthInMilliseconds());
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(!f.audioProperties()->xingHeader());
+      CPPUNIT_ASSERT_EQUAL(224, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(5224, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    }
+  }
+
+  void testSeekIndex()
+  {
+    const ByteVector data = vbrStream();
+
+    ByteVector rendered;
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Accurate);
+
+      // The index was built while counting the frames.
+      const unsigned long long readCalls = f.ioStatistics().readCalls;
+      const MPEG::SeekIndex index = f.seekIndex();
+      CPPUNIT_ASSERT_EQUAL(readCalls, f.ioStatistics().readCalls);
+
+      CPPUNIT_ASSERT(index.isValid());
+      CPPUNIT_ASSERT_EQUAL(32U, index.interval());
+      CPPUNIT_ASSERT_EQUAL(44100U, index.sampleRate());
+      CPPUNIT_ASSERT_EQUAL(200ULL * 1152, index.totalSamples());
+      CPPUNIT_ASSERT_EQUAL(7U, index.size());
+      CPPUNIT_ASSERT_EQUAL(0LL, index.entry(0).offset);
+      CPPUNIT_ASSERT_EQUAL(16LL * 1461, index.entry(1).offset);
+      CPPUNIT_ASSERT_EQUAL(32ULL * 1152, index.entry(1).sample);
+      CPPUNIT_ASSERT_EQUAL(64ULL * 1152, index.find(70 * 1152).sample);
+
+      unsigned long long frameSample = 0;
+      CPPUNIT_ASSERT_EQUAL(0L, f.frameOffsetForSample(0, &frameSample));
+      CPPUNIT_ASSERT_EQUAL(0ULL, frameSample);
+      CPPUNIT_ASSERT_EQUAL(16L * 1461 + 417, f.frameOffsetForSample(33 * 1152 + 5, &frameSample));
+      CPPUNIT_ASSERT_EQUAL(33ULL * 1152, frameSample);
+      CPPUNIT_ASSERT_EQUAL(75L * 1461 + 100, f.frameOffsetForSample(150 * 1152));
+      CPPUNIT_ASSERT_EQUAL(-1L, f.frameOffsetForSample(200 * 1152));
+
+      rendered = index.render();
+    }
+    {
+      const MPEG::SeekIndex index(rendered);
+      CPPUNIT_ASSERT(index.isValid());
+      CPPUNIT_ASSERT_EQUAL(200ULL * 1152, index.totalSamples());
+      CPPUNIT_ASSERT_EQUAL(7U, index.size());
+      CPPUNIT_ASSERT_EQUAL(48LL * 1461, index.entry(3).offset);
+      CPPUNIT_ASSERT_EQUAL(160LL / 2 * 1461 + 100, index.entry(5).offset);
+
+      // A stored index saves the walk.
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false);
+      f.setSeekIndex(index);
+      CPPUNIT_ASSERT_EQUAL(75L * 1461 + 100, f.frameOffsetForSample(150 * 1152 + 1151));
+    }
+
+    CPPUNIT_ASSERT(!MPEG::SeekIndex(rendered.mid(0, rendered.size() - 1)).isValid());
+    CPPUNIT_ASSERT(!MPEG::SeekIndex(ByteVector("MPSI\x02", 5)).isValid());
+  }
+
+  void testLazyID3v2Tag()
+  {
+    ByteVector data;
+    {
+      ByteVectorStream stream(vbrStream());
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), false);
+      f.ID3v2Tag(true)->setTitle("Lazy");
+      ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+      picture->setPicture(ByteVector(1024 * 1024, 'x'));
+      f.ID3v2Tag()->addFrame(picture);
+      f.save(MPEG::File::ID3v2);
+      data = *stream.data();
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::ReadStyle(MPEG::Properties::Average | MPEG::Properties::LazyTags));
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+      // The signature samples some of the audio, but the picture isn't read.
+      CPPUNIT_ASSERT(f.ioStatistics().bytesRead < 256 * 1024);
+
+      CPPUNIT_ASSERT_EQUAL(String("Lazy"), f.tag()->title());
+      CPPUNIT_ASSERT(f.ioStatistics().bytesRead > 1024 * 1024);
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameListMap()["APIC"].size());
+
+      // Saving writes the deferred tag back unchanged.
+      f.tag()->setArtist("Artist");
+      f.save(MPEG::File::ID3v2);
+      data = *stream.data();
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true,
+                   MPEG::Properties::ReadStyle(MPEG::Properties::Average | MPEG::Properties::LazyTags));
+      CPPUNIT_ASSERT_EQUAL(String("Artist"), f.ID3v2Tag()->artist());
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameListMap()["APIC"].size());
+
+      // Stripping a tag that was never read.
+      ByteVectorStream stripped(data);
+      MPEG::File g(&stripped, ID3v2::FrameFactory::instance(), false,
+                   MPEG::Properties::LazyTags);
+      g.strip(MPEG::File::ID3v2);
+      CPPUNIT_ASSERT(!g.hasID3v2Tag());
+      CPPUNIT_ASSERT(!g.ID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(vbrStream().size(), stripped.data()->size());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMPEG);
@@ -48,6 +48,7 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testPageChecksum);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -223,6 +224,40 @@ public:
 
   }
 
+  void testSignature()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    ByteVector signature;
+    long audioByte;
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() - 1;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.  The comment spans many pages, so the
+      // audio pages are renumbered.
+      Vorbis::File f(copy.fileName().c_str(), true,
+                     AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setTitle(longText(128 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      Vorbis::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOGG);
@@ -31,6 +31,7 @@
 #include <oggfile.h>
 #include <oggflacfile.h>
 #include <oggpageheader.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -43,6 +44,7 @@ class TestOggFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testFramingBit);
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testSplitPackets);
+  CPPUNIT_TEST(testSignatureWithoutMD5);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -117,6 +119,49 @@ public:
     }
   }
 
+  void testSignatureWithoutMD5()
+  {
+    ScopedFileCopy copy("empty_flac", ".oga");
+    {
+      // Without the MD5 of the audio in STREAMINFO, the signature is taken
+      // from the audio pages.
+      FileStream file(copy.fileName().c_str());
+      const int streamInfo = file.readBlock(1024).find("fLaC") + 8;
+      CPPUNIT_ASSERT(streamInfo > 8);
+      file.seek(streamInfo + 18);
+      file.writeBlock(ByteVector(16, '\0'));
+    }
+    ByteVector signature;
+    long audioByte;
+    {
+      Ogg::FLAC::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() - 1;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      Ogg::FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.  The comment spans many pages, so the
+      // audio pages are renumbered.
+      Ogg::FLAC::File f(copy.fileName().c_str(), true,
+                        AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setTitle(longText(128 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      Ogg::FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOggFLAC);
@@ -42,6 +42,7 @@ class TestOpus : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadComments);
   CPPUNIT_TEST(testWriteComments);
   CPPUNIT_TEST(testSplitPackets);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -133,6 +134,40 @@ public:
     }
   }
 
+  void testSignature()
+  {
+    ScopedFileCopy copy("correctness_gain_silent_output", ".opus");
+    ByteVector signature;
+    long audioByte;
+    {
+      Ogg::Opus::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() - 1;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      Ogg::Opus::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.  The comment spans many pages, so the
+      // audio pages are renumbered.
+      Ogg::Opus::File f(copy.fileName().c_str(), true,
+                        AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setTitle(longText(128 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      Ogg::Opus::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestOpus);
@@ -0,0 +1,90 @@
+/***************************************************************************
+    copyright            : (C) 2026 Roon Labs LLC
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ ***************************************************************************/
+
+#include <string>
+#include <SHA1.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace std;
+
+namespace
+{
+  string hashHex(CSHA1::BACKEND backend, const string &data, size_t split)
+  {
+    CSHA1 sha1;
+    CPPUNIT_ASSERT(sha1.SetBackend(backend));
+    sha1.Update(reinterpret_cast<const UINT_8 *>(data.data()), static_cast<UINT_32>(split));
+    sha1.Update(reinterpret_cast<const UINT_8 *>(data.data() + split), static_cast<UINT_32>(data.size() - split));
+    sha1.Final();
+
+    string report;
+    sha1.ReportHashStl(report, CSHA1::REPORT_HEX_SHORT);
+    return report;
+  }
+}
+
+class TestSHA1 : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestSHA1);
+  CPPUNIT_TEST(testVectors);
+  CPPUNIT_TEST(testBackendsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testVectors()
+  {
+    const string million(1000000, 'a');
+
+    for(int b = CSHA1::BACKEND_SCALAR; b <= CSHA1::BACKEND_ARMV8_SHA; ++b) {
+      const CSHA1::BACKEND backend = static_cast<CSHA1::BACKEND>(b);
+      if(!CSHA1::IsBackendSupported(backend))
+        continue;
+
+      CPPUNIT_ASSERT_EQUAL(string("DA39A3EE5E6B4B0D3255BFEF95601890AFD80709"),
+                           hashHex(backend, "", 0));
+      CPPUNIT_ASSERT_EQUAL(string("A9993E364706816ABA3E25717850C26C9CD0D89D"),
+                           hashHex(backend, "abc", 1));
+      CPPUNIT_ASSERT_EQUAL(string("84983E441C3BD26EBAAE4AA1F95129E5E54670F1"),
+                           hashHex(backend, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 7));
+      CPPUNIT_ASSERT_EQUAL(string("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"),
+                           hashHex(backend, million, 333333));
+    }
+  }
+
+  void testBackendsAgree()
+  {
+    CPPUNIT_ASSERT(CSHA1::IsBackendSupported(CSHA1::BACKEND_SCALAR));
+    CPPUNIT_ASSERT(CSHA1::IsBackendSupported(CSHA1::GetBestBackend()));
+
+    string data(3000, '\0');
+    for(size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>((i * 7919) >> 3);
+
+    for(size_t length = 0; length < data.size(); length += 61) {
+      const string s = data.substr(0, length);
+      CPPUNIT_ASSERT_EQUAL(hashHex(CSHA1::BACKEND_SCALAR, s, length / 3),
+                           hashHex(CSHA1::GetBestBackend(), s, length / 3));
+    }
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSHA1);
@@ -36,6 +36,7 @@ class TestSpeex : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestSpeex);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testSplitPackets);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -98,6 +99,40 @@ public:
     }
   }
 
+  void testSignature()
+  {
+    ScopedFileCopy copy("empty", ".spx");
+    ByteVector signature;
+    long audioByte;
+    {
+      Ogg::Speex::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() - 1;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      Ogg::Speex::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.  The comment spans many pages, so the
+      // audio pages are renumbered.
+      Ogg::Speex::File f(copy.fileName().c_str(), true,
+                         AudioProperties::Average | AudioProperties::LazySignature);
+      f.tag()->setTitle(longText(128 * 1024));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      Ogg::Speex::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestSpeex);
@@ -42,6 +42,7 @@ class TestTrueAudio : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadPropertiesWithTags);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testSignature);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -122,6 +123,39 @@ public:
     }
   }
 
+  void testSignature()
+  {
+    ScopedFileCopy copy("empty", ".tta");
+    ByteVector signature;
+    long audioByte;
+    {
+      TrueAudio::File f(copy.fileName().c_str());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+      audioByte = f.length() / 2;
+    }
+    {
+      // Changing a byte of the audio changes the signature.
+      flipByte(copy.fileName(), audioByte);
+      TrueAudio::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(signature != f.audioProperties()->signature());
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      // Changing the tags does not.
+      TrueAudio::File f(copy.fileName().c_str(), true,
+                        AudioProperties::Average | AudioProperties::LazySignature);
+      f.ID3v2Tag(true)->setTitle("Title");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      TrueAudio::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestTrueAudio);
@@ -26,10 +26,13 @@
 #include <string>
 #include <stdio.h>
 #include <id3v2tag.h>
+#include <id3v2framefactory.h>
+#include <attachedpictureframe.h>
 #include <infotag.h>
 #include <tbytevectorlist.h>
 #include <tpropertymap.h>
 #include <wavfile.h>
+#include <tfilestream.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -51,6 +54,9 @@ class TestWAV : public CppUnit::TestFixture
   CPPUNIT_TEST(testFuzzedFile2);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testPCMWithFactChunk);
+  CPPUNIT_TEST(testSignatureStyles);
+  CPPUNIT_TEST(testManyChunksSyscalls);
+  CPPUNIT_TEST(testSkippedFrames);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -289,6 +295,105 @@ public:
     CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->format());
   }
 
+  void testSignatureStyles()
+  {
+    ByteVector signature;
+    {
+      RIFF::WAV::File f(TEST_FILE_PATH_C("empty.wav"));
+      signature = f.audioProperties()->signature();
+      CPPUNIT_ASSERT_EQUAL(20U, signature.size());
+    }
+    {
+      RIFF::WAV::File f(TEST_FILE_PATH_C("empty.wav"), true,
+                        AudioProperties::Average | AudioProperties::LazySignature);
+      CPPUNIT_ASSERT_EQUAL(signature, f.audioProperties()->signature());
+    }
+    {
+      RIFF::WAV::File f(TEST_FILE_PATH_C("empty.wav"), true,
+                        AudioProperties::Average | AudioProperties::NoSignature);
+      CPPUNIT_ASSERT_EQUAL(3675, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT(f.audioProperties()->signature().isEmpty());
+    }
+  }
+
+  void testManyChunksSyscalls()
+  {
+    ScopedFileCopy copy("empty", ".wav");
+    string filename = copy.fileName();
+
+    ByteVector fmt = ByteVector::fromShort(1, false);
+    fmt.append(ByteVector::fromShort(2, false));
+    fmt.append(ByteVector::fromUInt(44100, false));
+    fmt.append(ByteVector::fromUInt(44100 * 4, false));
+    fmt.append(ByteVector::fromShort(4, false));
+    fmt.append(ByteVector::fromShort(16, false));
+
+    ByteVector body("WAVE");
+    body.append(ByteVector("fmt ") + ByteVector::fromUInt(fmt.size(), false) + fmt);
+    for(int i = 0; i < 1000; ++i)
+      body.append(ByteVector("junk") + ByteVector::fromUInt(2, false) + ByteVector(2, '\0'));
+    body.append(ByteVector("data") + ByteVector::fromUInt(4000, false) + ByteVector(4000, '\0'));
+
+    {
+      FileStream stream(filename.c_str());
+      stream.truncate(0);
+      stream.writeBlock(ByteVector("RIFF") + ByteVector::fromUInt(body.size(), false) + body);
+    }
+
+    FileStream stream(filename.c_str(), true);
+    RIFF::WAV::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    CPPUNIT_ASSERT_EQUAL(1000U, f.audioProperties()->sampleFrames());
+
+    // Walking the chunk list used to seek to the end of the file twice per
+    // chunk just to find out the file length.
+    const FileStream::ReadAheadStatistics stats = stream.readAheadStatistics();
+    CPPUNIT_ASSERT(stats.readCalls > 1000);
+    CPPUNIT_ASSERT(stats.fileReads <= 2);
+    CPPUNIT_ASSERT(stats.fileSeeks <= 2);
+  }
+
+  void testSkippedFrames()
+  {
+    ScopedFileCopy copy("empty", ".wav");
+    string filename = copy.fileName();
+
+    {
+      RIFF::WAV::File f(filename.c_str());
+      f.ID3v2Tag()->setTitle("Title");
+      ID3v2::AttachedPictureFrame *picture = new ID3v2::AttachedPictureFrame();
+      picture->setPicture(ByteVector(1024, 'x'));
+      f.ID3v2Tag()->addFrame(picture);
+      f.save();
+    }
+
+    // WAV files always use the global factory.
+    struct FilterGuard {
+      FilterGuard()
+      {
+        ID3v2::FrameFactory::instance()->setFrameFilter(ByteVectorList::split("APIC", " "));
+      }
+      ~FilterGuard()
+      {
+        ID3v2::FrameFactory::instance()->setFrameFilter(ByteVectorList());
+      }
+    };
+    {
+      FilterGuard guard;
+      RIFF::WAV::File f(filename.c_str());
+      f.ID3v2Tag()->setTitle("New title");
+      f.save();
+    }
+    {
+      RIFF::WAV::File f(filename.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("New title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(1U, f.ID3v2Tag()->frameList("APIC").size());
+      CPPUNIT_ASSERT_EQUAL(ByteVector(1024, 'x'), static_cast<ID3v2::AttachedPictureFrame *>(
+        f.ID3v2Tag()->frameList("APIC").front())->picture());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestWAV);
@@ -103,6 +103,15 @@ inline bool fileEqual(const string &filename1, const string &filename2)
   return stream1.good() == stream2.good();
 }
 
+inline void flipByte(const string &filename, long offset)
+{
+  fstream stream(filename.c_str(), ios_base::in | ios_base::out | ios_base::binary);
+  stream.seekg(offset);
+  const char c = static_cast<char>(stream.get());
+  stream.seekp(offset);
+  stream.put(static_cast<char>(~c));
+}
+
 #ifdef TAGLIB_STRING_H
 
 namespace TagLib {